@@ -8,6 +8,7 @@
  */
 
 #include "measure.h"
+#include "../mpn.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -269,12 +270,15 @@ void correctTEST_SQU_Krtsb(int test_cnt) {
         bool sgnX = false, sgnY = false; \
         RANDOM_BINT(&ptrX, sgnX, lenX); \
         RANDOM_BINT(&ptrY, sgnY, lenY); \
+        if (rand() % 16 == 0) copyBINT(&ptrY, &ptrX); \
         FUNC(&ptrX, &ptrY, &ptrQ, &ptrR); \
         printf("print(hex("); print_bint_hex_py(ptrQ); \
         printf(" * "); print_bint_hex_py(ptrY); \
         printf(" + "); print_bint_hex_py(ptrR); \
         printf(") == hex("); print_bint_hex_py(ptrX); \
-        printf("))\n"); \
+        printf(") and "); print_bint_hex_py(ptrR); \
+        printf(" < "); print_bint_hex_py(ptrY); \
+        printf(")\n"); \
         delete_bint(&ptrX); \
         delete_bint(&ptrY); \
         delete_bint(&ptrQ); \
@@ -287,10 +291,10 @@ void corretTEST_BinDIV(int test_cnt) {
 }
 
 void corretTEST_GenDIV(int test_cnt) {
-    TEST_DIV_TEMPLATE(DIV_Long, test_cnt, lenX - 1);
+    TEST_DIV_TEMPLATE(DIV_Long, test_cnt, rand() % lenX + 1);
 }
 
-#define TEST_EXP_MOD_TEMPLATE(FUNC, test_cnt) \
+#define TEST_EXP_MOD_TEMPLATE(FUNC, test_cnt, exp_len) \
     srand((unsigned int)time(NULL)); \
     int idx = 0; \
     while (idx < (test_cnt)) { \
@@ -298,7 +302,7 @@ void corretTEST_GenDIV(int test_cnt) {
         int redMax = MAX_BIT_LENGTH / WORD_BITLEN; \
         int redMin = MIN_BIT_LENGTH / WORD_BITLEN; \
         int len1 = rand() % (redMax - redMin + 1) + redMin; \
-        int len2 = 1; \
+        int len2 = (exp_len); \
         int len3 = rand() % (redMax - redMin + 1) + 1; \
         RANDOM_BINT(&ptrX, false, len1); \
         RANDOM_BINT(&ptrY, false, len2); \
@@ -321,15 +325,543 @@ void corretTEST_GenDIV(int test_cnt) {
     }
 
 void corretTEST_EXP_MOD_L2R(int test_cnt) {
-    TEST_EXP_MOD_TEMPLATE(EXP_MOD_L2R, test_cnt);
+    TEST_EXP_MOD_TEMPLATE(EXP_MOD_L2R, test_cnt, 1);
 }
 
 void corretTEST_EXP_MOD_R2L(int test_cnt) {
-    TEST_EXP_MOD_TEMPLATE(EXP_MOD_R2L, test_cnt);
+    TEST_EXP_MOD_TEMPLATE(EXP_MOD_R2L, test_cnt, 1);
 }
 
 void corretTEST_EXP_MOD_Montgomery(int test_cnt) {
-    TEST_EXP_MOD_TEMPLATE(EXP_MOD_Montgomery, test_cnt);
+    TEST_EXP_MOD_TEMPLATE(EXP_MOD_Montgomery, test_cnt, 1);
+}
+
+// Exponents of up to MAX_BIT_LENGTH bits, so every window width is exercised
+void corretTEST_EXP_MOD_KAry(int test_cnt) {
+    TEST_EXP_MOD_TEMPLATE(EXP_MOD_KAry, test_cnt, rand() % (MAX_BIT_LENGTH / WORD_BITLEN) + 1);
+}
+
+void corretTEST_EXP_MOD_Sliding(int test_cnt) {
+    TEST_EXP_MOD_TEMPLATE(EXP_MOD_Sliding, test_cnt, rand() % (MAX_BIT_LENGTH / WORD_BITLEN) + 1);
+}
+
+void corretTEST_EXP_MOD_Multi(int test_cnt) {
+    srand((unsigned int)time(NULL));
+
+    int idx = 0x00;
+    while (idx < test_cnt) {
+        int redMax = MAX_BIT_LENGTH / WORD_BITLEN;
+        int len = rand() % redMax + 1;
+        int count = rand() % 4 + 1;
+
+        BINT *ptrBases[4] = { NULL }, *ptrExps[4] = { NULL };
+        BINT *ptrMod = NULL, *ptrZ = NULL;
+        RANDOM_BINT(&ptrMod, false, len);
+        for (int j = 0; j < count; j++) {
+            RANDOM_BINT(&ptrBases[j], false, rand() % (2 * len) + 1);
+            RANDOM_BINT(&ptrExps[j], false, rand() % redMax + 1);
+        }
+        EXP_MOD_Multi(ptrBases, ptrExps, count, &ptrZ, ptrMod);
+
+        printf("print((1");
+        for (int j = 0; j < count; j++) {
+            printf(" * pow("); print_bint_hex_py(ptrBases[j]);
+            printf(", "); print_bint_hex_py(ptrExps[j]);
+            printf(", "); print_bint_hex_py(ptrMod);
+            printf(")");
+        }
+        printf(") %% "); print_bint_hex_py(ptrMod);
+        printf(" == "); print_bint_hex_py(ptrZ);
+        printf(")\n");
+
+        for (int j = 0; j < count; j++) {
+            delete_bint(&ptrBases[j]); delete_bint(&ptrExps[j]);
+        }
+        delete_bint(&ptrMod); delete_bint(&ptrZ);
+        idx++;
+    }
+}
+
+void corretTEST_MontMul(int test_cnt) {
+    srand((unsigned int)time(NULL));
+
+    int idx = 0x00;
+    while (idx < test_cnt) {
+        int redMax = MAX_BIT_LENGTH / WORD_BITLEN;
+        int len = rand() % redMax + 1;
+
+        BINT *ptrX = NULL, *ptrY = NULL, *ptrN = NULL;
+        BINT *ptrXm = NULL, *ptrYm = NULL, *ptrZm = NULL, *ptrZ = NULL, *ptrS = NULL;
+        MontCtx* ptrCtx = NULL;
+        RANDOM_BINT(&ptrX, false, rand() % (2 * len) + 1);
+        RANDOM_BINT(&ptrY, false, rand() % (2 * len) + 1);
+        RANDOM_BINT(&ptrN, false, len);
+        ptrN->val[0] |= 1;
+
+        init_mont_ctx(&ptrCtx, ptrN);
+        MONT_To(&ptrX, &ptrXm, ptrCtx);
+        MONT_To(&ptrY, &ptrYm, ptrCtx);
+        MONT_Mul(&ptrXm, &ptrYm, &ptrZm, ptrCtx);
+        MONT_From(&ptrZm, &ptrZ, ptrCtx);
+        MONT_Sqr(&ptrXm, &ptrZm, ptrCtx);
+        MONT_From(&ptrZm, &ptrS, ptrCtx);
+
+        printf("print(("); print_bint_hex_py(ptrX);
+        printf(" * "); print_bint_hex_py(ptrY);
+        printf(") %% "); print_bint_hex_py(ptrN);
+        printf(" == "); print_bint_hex_py(ptrZ);
+        printf(" and ("); print_bint_hex_py(ptrX);
+        printf(" ** 2) %% "); print_bint_hex_py(ptrN);
+        printf(" == "); print_bint_hex_py(ptrS);
+        printf(")\n");
+
+        delete_mont_ctx(&ptrCtx);
+        delete_bint(&ptrX); delete_bint(&ptrY); delete_bint(&ptrN);
+        delete_bint(&ptrXm); delete_bint(&ptrYm); delete_bint(&ptrZm);
+        delete_bint(&ptrZ); delete_bint(&ptrS);
+        idx++;
+    }
+}
+
+void corretTEST_FixedBase(int test_cnt) {
+    srand((unsigned int)time(NULL));
+
+    int idx = 0x00;
+    while (idx < test_cnt) {
+        int redMax = MAX_BIT_LENGTH / WORD_BITLEN;
+        int len = rand() % redMax + 1;
+        int max_bits = rand() % (len * WORD_BITLEN) + 1;
+        int width = rand() % 6;     // 0 selects FB_DEFAULT_WIDTH
+
+        BINT *ptrG = NULL, *ptrN = NULL, *ptrY = NULL, *ptrW = NULL, *ptrZ = NULL, *ptrV = NULL;
+        FixedBase* ptrFB = NULL;
+        RANDOM_BINT(&ptrG, false, rand() % (2 * len) + 1);
+        RANDOM_BINT(&ptrN, false, len);
+        RANDOM_BINT(&ptrY, false, (max_bits + WORD_BITLEN - 1) / WORD_BITLEN);
+        right_shift_bit(&ptrY, ptrY->wordlen * WORD_BITLEN - max_bits);
+        RANDOM_BINT(&ptrW, false, len + 1);     // beyond the table: takes the fallback path
+
+        // The exponentiations run on a table that went through the disk
+        init_fixed_base(&ptrFB, &ptrG, ptrN, max_bits, width);
+        if (!FB_Save(ptrFB, "FB_TEST.tbl") || !FB_Load(&ptrFB, "FB_TEST.tbl")) {
+            printf("print(False)\n");
+        } else {
+            EXP_MOD_FixedBase(ptrFB, &ptrY, &ptrZ);
+            EXP_MOD_FixedBase(ptrFB, &ptrW, &ptrV);
+            printf("print(pow("); print_bint_hex_py(ptrG);
+            printf(", "); print_bint_hex_py(ptrY);
+            printf(", "); print_bint_hex_py(ptrN);
+            printf(") == "); print_bint_hex_py(ptrZ);
+            printf(" and pow("); print_bint_hex_py(ptrG);
+            printf(", "); print_bint_hex_py(ptrW);
+            printf(", "); print_bint_hex_py(ptrN);
+            printf(") == "); print_bint_hex_py(ptrV);
+            printf(")\n");
+        }
+        remove("FB_TEST.tbl");
+
+        delete_fixed_base(&ptrFB);
+        delete_bint(&ptrG); delete_bint(&ptrN); delete_bint(&ptrY);
+        delete_bint(&ptrW); delete_bint(&ptrZ); delete_bint(&ptrV);
+        idx++;
+    }
+}
+
+void corretTEST_Arena(int test_cnt) {
+    srand((unsigned int)time(NULL));
+
+    int idx = 0x00;
+    while (idx < test_cnt) {
+        int len = rand() % (MAX_BIT_LENGTH / WORD_BITLEN) + 1;
+        int rounds = rand() % 8 + 1;
+
+        BINT *ptrX = NULL, *ptrY = NULL, *ptrZ = NULL, *ptrQ = NULL, *ptrR = NULL;
+        BINT *ptrAcc = NULL, *ptrT = NULL, *ptrS = NULL;
+        RANDOM_BINT(&ptrX, false, len);
+        RANDOM_BINT(&ptrY, false, rand() % len + 1);
+        ptrX->val[0] |= WORD_ONE;
+
+        // Everything the kernels allocate goes back to the arena; only the listed objects leave the scope
+        ArenaMark mark = bint_arena_begin();
+        BINT** keep[] = { &ptrX, &ptrY, &ptrZ, &ptrQ, &ptrR, &ptrAcc };
+        MUL_Core_Krtsb_xyz(&ptrX, &ptrY, &ptrZ);
+        DIV_Long(&ptrZ, &ptrX, &ptrQ, &ptrR);
+        init_bint(&ptrAcc, 1);
+        for (int i = 0; i < rounds; i++) {
+            mul_core_TxtBk_xyz(&ptrX, &ptrY, &ptrT);
+            ADD(&ptrAcc, &ptrT, &ptrS);
+            copyBINT(&ptrAcc, &ptrS);
+            bint_arena_rollback(mark, keep, 6);
+            ptrT = NULL; ptrS = NULL;
+        }
+        bint_arena_end(mark, keep, 6);
+
+        // Outside any scope of ours, the wrappers take their scratch from scopes of their own: once the results
+        // have room and the arena has its blocks, a multiplication and a division leave the heap untouched
+        MUL_Core_Krtsb_xyz(&ptrX, &ptrY, &ptrZ);
+        DIV_Long(&ptrZ, &ptrX, &ptrQ, &ptrR);
+        size_t heap_calls = bint_heap_calls();
+        MUL_Core_Krtsb_xyz(&ptrX, &ptrY, &ptrZ);
+        DIV_Long(&ptrZ, &ptrX, &ptrQ, &ptrR);
+        bool off_heap = bint_heap_calls() == heap_calls;
+
+        printf("print(("); print_bint_hex_py(ptrX);
+        printf(" * "); print_bint_hex_py(ptrY);
+        printf(" == "); print_bint_hex_py(ptrZ);
+        printf(") and ("); print_bint_hex_py(ptrZ);
+        printf(" // "); print_bint_hex_py(ptrX);
+        printf(" == "); print_bint_hex_py(ptrQ);
+        printf(") and ("); print_bint_hex_py(ptrZ);
+        printf(" %% "); print_bint_hex_py(ptrX);
+        printf(" == "); print_bint_hex_py(ptrR);
+        printf(") and (%d * ", rounds); print_bint_hex_py(ptrX);
+        printf(" * "); print_bint_hex_py(ptrY);
+        printf(" == "); print_bint_hex_py(ptrAcc);
+        printf(") and %s)\n", off_heap ? "True" : "False");
+
+        delete_bint(&ptrX); delete_bint(&ptrY); delete_bint(&ptrZ);
+        delete_bint(&ptrQ); delete_bint(&ptrR); delete_bint(&ptrAcc);
+
+        // Every other round starts from an empty arena
+        if (idx % 2)
+            bint_arena_release_thread();
+        idx++;
+    }
+}
+
+void corretTEST_Mpn(int test_cnt) {
+    srand((unsigned int)time(NULL));
+
+    int idx = 0x00;
+    while (idx < test_cnt) {
+        int an = rand() % (MAX_BIT_LENGTH / WORD_BITLEN) + 1;
+        int bn = rand() % an + 1;
+        int cnt = rand() % (WORD_BITLEN - 1) + 1;
+
+        BINT *ptrA = NULL, *ptrB = NULL, *ptrP = NULL, *ptrS = NULL, *ptrQ = NULL, *ptrR = NULL;
+        BINT *ptrQ2 = NULL, *ptrR2 = NULL, *ptrL = NULL, *ptrX = NULL, *ptrY = NULL, *ptrC = NULL, *ptrC2 = NULL;
+        RANDOM_BINT(&ptrA, false, an);
+        RANDOM_BINT(&ptrB, false, bn);
+        // A zero top word has been trimmed away by RANDOM_BINT; the lengths are restored with it set
+        ptrA->val[an - 1] |= WORD_ONE;
+        ptrB->val[bn - 1] |= WORD_ONE;
+        ptrA->wordlen = an;
+        ptrB->wordlen = bn;
+
+        // The kernels write straight into the words of caller-owned objects; only the scratch is extra
+        BINT ws = BINT_INITIALIZER(ws);
+        reserveBINT(&ws, MAXIMUM(MAXIMUM(mpn_mul_itch(an, bn), mpn_mul_n_itch(an)), mpn_div_qr_itch(an, bn)));
+        init_bint(&ptrP, an + bn);
+        mpn_mul(ptrP->val, ptrA->val, an, ptrB->val, bn, ws.val);
+        init_bint(&ptrS, 2 * an);
+        mpn_sqr_n(ptrS->val, ptrA->val, an, ws.val);
+        init_bint(&ptrC, an + bn);
+        mpn_mul_comba(ptrC->val, ptrA->val, an, ptrB->val, bn);
+        init_bint(&ptrC2, 2 * an);
+        mpn_sqr_comba(ptrC2->val, ptrA->val, an);
+
+        init_bint(&ptrQ, an); init_bint(&ptrR, bn + 1);
+        mpn_div_qr(ptrQ->val, ptrR->val, ptrA->val, an, ptrB->val, bn, ws.val);
+        clear_bint(&ws);
+        init_bint(&ptrQ2, an); init_bint(&ptrR2, bn + 1);
+        mpn_div_binary(ptrQ2->val, ptrR2->val, ptrA->val, an, ptrB->val, bn);
+
+        init_bint(&ptrL, an + 1);
+        ptrL->val[an] = mpn_lshift(ptrL->val, ptrA->val, an, cnt);
+        WORD out = mpn_rshift(ptrL->val, ptrL->val, an + 1, cnt);
+        refineBINT(ptrP); refineBINT(ptrS); refineBINT(ptrL); refineBINT(ptrC); refineBINT(ptrC2);
+        refineBINT(ptrQ); refineBINT(ptrR); refineBINT(ptrQ2); refineBINT(ptrR2);
+
+        // Signed wrappers with the output aliasing an operand, and the in-place variants
+        RANDOM_BINT(&ptrX, rand() % 2, an);
+        RANDOM_BINT(&ptrY, rand() % 2, bn);
+        printf("print((("); print_bint_hex_py(ptrX);
+        printf(" + "); print_bint_hex_py(ptrY);
+        printf(" - "); print_bint_hex_py(ptrY);
+        printf(") * 2 - "); print_bint_hex_py(ptrY);
+        printf(") * "); print_bint_hex_py(ptrY);
+        printf(" == ");
+        ADD(&ptrX, &ptrY, &ptrX);
+        SUB(&ptrX, &ptrY, &ptrX);
+        ADD_Inplace(&ptrX, &ptrX);
+        SUB_Inplace(&ptrX, &ptrY);
+        MUL_Core_Krtsb_xyz(&ptrX, &ptrY, &ptrY);
+        print_bint_hex_py(ptrY);
+
+        printf(" and "); print_bint_hex_py(ptrA);
+        printf(" * "); print_bint_hex_py(ptrB);
+        printf(" == "); print_bint_hex_py(ptrP);
+        printf(" and "); print_bint_hex_py(ptrA);
+        printf(" ** 2 == "); print_bint_hex_py(ptrS);
+        printf(" and "); print_bint_hex_py(ptrC);
+        printf(" == "); print_bint_hex_py(ptrP);
+        printf(" and "); print_bint_hex_py(ptrC2);
+        printf(" == "); print_bint_hex_py(ptrS);
+        printf(" and divmod("); print_bint_hex_py(ptrA);
+        printf(", "); print_bint_hex_py(ptrB);
+        printf(") == ("); print_bint_hex_py(ptrQ);
+        printf(", "); print_bint_hex_py(ptrR);
+        printf(") == ("); print_bint_hex_py(ptrQ2);
+        printf(", "); print_bint_hex_py(ptrR2);
+        printf(") and "); print_bint_hex_py(ptrL);
+        printf(" == "); print_bint_hex_py(ptrA);
+        printf(" and %d == 0)\n", out != 0);
+
+        delete_bint(&ptrA); delete_bint(&ptrB); delete_bint(&ptrP); delete_bint(&ptrS);
+        delete_bint(&ptrQ); delete_bint(&ptrR); delete_bint(&ptrQ2); delete_bint(&ptrR2);
+        delete_bint(&ptrL); delete_bint(&ptrX); delete_bint(&ptrY); delete_bint(&ptrC); delete_bint(&ptrC2);
+        idx++;
+    }
+}
+
+void corretTEST_Toom(int test_cnt) {
+    srand((unsigned int)time(NULL));
+    int kara[2] = { mpn_mul_karatsuba_threshold, mpn_sqr_karatsuba_threshold };
+    int toom3[2] = { mpn_mul_toom3_threshold, mpn_sqr_toom3_threshold };
+    int toom4[2] = { mpn_mul_toom4_threshold, mpn_sqr_toom4_threshold };
+
+    int idx = 0x00;
+    while (idx < test_cnt) {
+        // Low thresholds, so that MAX_BIT_LENGTH operands recurse through every algorithm
+        mpn_mul_karatsuba_threshold = mpn_sqr_karatsuba_threshold = rand() % 6 + 2;
+        mpn_mul_toom3_threshold = mpn_sqr_toom3_threshold = mpn_mul_karatsuba_threshold + rand() % 8;
+        mpn_mul_toom4_threshold = mpn_sqr_toom4_threshold = mpn_mul_toom3_threshold + rand() % 16;
+        int xn = rand() % (MAX_BIT_LENGTH / WORD_BITLEN) + 1;
+        int yn = rand() % 2 ? xn : rand() % xn + 1;
+
+        BINT *ptrX = NULL, *ptrY = NULL, *ptrZ = NULL, *ptrS = NULL;
+        RANDOM_BINT(&ptrX, rand() % 2, xn);
+        RANDOM_BINT(&ptrY, rand() % 2, yn);
+        if (rand() % 4 == 0) {  // all-ones operands carry through every evaluation and interpolation step
+            for (int i = 0; i < ptrX->wordlen; i++) ptrX->val[i] = (WORD)~(WORD)0;
+            for (int i = 0; i < ptrY->wordlen; i++) ptrY->val[i] = (WORD)~(WORD)0;
+        }
+        MUL_Core_Krtsb_xyz(&ptrX, &ptrY, &ptrZ);
+        SQU_Krtsb_xz(&ptrX, &ptrS);
+
+        printf("print("); print_bint_hex_py(ptrX);
+        printf(" * "); print_bint_hex_py(ptrY);
+        printf(" == "); print_bint_hex_py(ptrZ);
+        printf(" and ("); print_bint_hex_py(ptrX);
+        printf(") ** 2 == "); print_bint_hex_py(ptrS);
+        printf(")\n");
+
+        delete_bint(&ptrX); delete_bint(&ptrY); delete_bint(&ptrZ); delete_bint(&ptrS);
+        idx++;
+    }
+
+    mpn_mul_karatsuba_threshold = kara[0]; mpn_sqr_karatsuba_threshold = kara[1];
+    mpn_mul_toom3_threshold = toom3[0]; mpn_sqr_toom3_threshold = toom3[1];
+    mpn_mul_toom4_threshold = toom4[0]; mpn_sqr_toom4_threshold = toom4[1];
+}
+
+// Fills the words of X with all ones, random words, lone top bits or zeros, one kind throughout or mixed; such
+// words drive the quotient estimates of the division routines to their limits
+static void edge_words(BINT* ptrX) {
+    int pattern = rand() % 4;
+    for (int i = 0; i < ptrX->wordlen; i++) {
+        int pick = pattern == 3 ? rand() % 4 : pattern;
+        ptrX->val[i] = pick == 0 ? (WORD)~(WORD)0
+                     : pick == 1 ? (WORD)((WORD)rand() * (WORD)2654435761u + (WORD)rand())
+                     : pick == 2 ? (WORD)((WORD)WORD_ONE << (WORD_BITLEN - 1))
+                                 : (WORD)0;
+    }
+}
+
+// One signed division by DIV_Long of an xn-word dividend by a yn-word divisor of edge_words, checked against
+// Python's divmod
+static void div_edge_case(int xn, int yn) {
+    BINT *ptrX = NULL, *ptrY = NULL, *ptrQ = NULL, *ptrR = NULL;
+    init_bint(&ptrX, xn); init_bint(&ptrY, yn);
+    edge_words(ptrX); edge_words(ptrY);
+    if (ptrY->val[yn - 1] == 0)
+        ptrY->val[yn - 1] = (WORD)(rand() % 3 + 1);
+    // A dividend that starts with the divisor less one leaves a partial remainder whose top word equals the
+    // divisor's, the case where the 2-by-1 estimate does not apply
+    if (xn > yn && rand() % 2) {
+        for (int i = 0; i < yn; i++)
+            ptrX->val[xn - yn + i] = ptrY->val[i];
+        for (int i = xn - yn; i < xn && ptrX->val[i]-- == 0; i++)
+            ;
+    }
+    if (rand() % 8 == 0) copyBINT(&ptrX, &ptrY);
+    ptrX->sign = rand() % 2; ptrY->sign = rand() % 2;
+    refineBINT(ptrX); refineBINT(ptrY);
+    DIV_Long(&ptrX, &ptrY, &ptrQ, &ptrR);
+
+    printf("print(divmod(abs("); print_bint_hex_py(ptrX);
+    printf("), abs("); print_bint_hex_py(ptrY);
+    printf(")) == (abs("); print_bint_hex_py(ptrQ);
+    printf("), "); print_bint_hex_py(ptrR);
+    printf(") and ("); print_bint_hex_py(ptrQ);
+    printf(" == 0 or ("); print_bint_hex_py(ptrQ);
+    printf(" < 0) == ((%d) != (%d))))\n", ptrX->sign, ptrY->sign);
+
+    delete_bint(&ptrX); delete_bint(&ptrY); delete_bint(&ptrQ); delete_bint(&ptrR);
+}
+
+void corretTEST_KnuthDIV(int test_cnt) {
+    srand((unsigned int)time(NULL));
+    int maxlen = MAX_BIT_LENGTH / WORD_BITLEN + 2;
+
+    int idx = 0x00;
+    while (idx < test_cnt) {
+        div_edge_case(rand() % (2 * maxlen) + 1, rand() % maxlen + 1);
+        idx++;
+    }
+}
+
+void corretTEST_BZDIV(int test_cnt) {
+    srand((unsigned int)time(NULL));
+    int maxlen = MAX_BIT_LENGTH / WORD_BITLEN + 2;
+    int bz = mpn_div_bz_threshold, kara = mpn_mul_karatsuba_threshold;
+
+    int idx = 0x00;
+    while (idx < test_cnt) {
+        // Low thresholds, so that the recursion reaches its leaves and its products split with Karatsuba; the
+        // dividends run to several quotient blocks
+        mpn_div_bz_threshold = rand() % 8 + 2;
+        mpn_mul_karatsuba_threshold = rand() % 6 + 2;
+        int yn = rand() % maxlen + 1;
+        div_edge_case(yn + rand() % (3 * yn + 1), yn);
+        idx++;
+    }
+
+    mpn_div_bz_threshold = bz; mpn_mul_karatsuba_threshold = kara;
+}
+
+void corretTEST_DivInvariant(int test_cnt) {
+    srand((unsigned int)time(NULL));
+    int maxlen = MAX_BIT_LENGTH / WORD_BITLEN + 2;
+    int bz = mpn_div_bz_threshold, kara = mpn_mul_karatsuba_threshold, fft = mpn_mul_fft_threshold;
+
+    int idx = 0x00;
+    while (idx < test_cnt) {
+        // Low thresholds half of the time, so that the Newton recursion and the preinverted blocks run on
+        // test-sized divisors, the blocks only from the NTT threshold on
+        if (rand() % 2) {
+            mpn_div_bz_threshold = rand() % 8 + 2;
+            mpn_mul_karatsuba_threshold = rand() % 6 + 2;
+            mpn_mul_fft_threshold = rand() % maxlen + 1;
+        }
+        int yn = rand() % maxlen + 1;
+        BINT *ptrY = NULL, *ptrI = NULL;
+        init_bint(&ptrY, yn);
+        edge_words(ptrY);
+        if (ptrY->val[yn - 1] == 0)
+            ptrY->val[yn - 1] = (WORD)(rand() % 3 + 1);
+        ptrY->sign = rand() % 2;
+        DivCtx* ptrCtx = NULL;
+        init_div_ctx(&ptrCtx, ptrY);
+        refineBINT(ptrY);
+
+        // The reciprocal itself, then a batch of numerators of any length against the one context
+        int k = ptrCtx->wordlen;
+        init_bint(&ptrI, k);
+        mpn_copy(ptrI->val, ptrCtx->inv, k);
+        printf("print((2 ** %d - 1) // (abs(", 2 * k * WORD_BITLEN); print_bint_hex_py(ptrY);
+        printf(") << %d) - 2 ** %d == ", ptrCtx->shift, k * WORD_BITLEN); print_bint_hex_py(ptrI);
+        printf(")\n");
+        for (int j = 0; j < 4; j++) {
+            BINT *ptrX = NULL, *ptrQ = NULL, *ptrR = NULL;
+            init_bint(&ptrX, rand() % (3 * maxlen) + 1);
+            edge_words(ptrX);
+            ptrX->sign = rand() % 2;
+            refineBINT(ptrX);
+            DIV_Invariant(&ptrX, &ptrQ, &ptrR, ptrCtx);
+
+            printf("print(divmod(abs("); print_bint_hex_py(ptrX);
+            printf("), abs("); print_bint_hex_py(ptrY);
+            printf(")) == (abs("); print_bint_hex_py(ptrQ);
+            printf("), "); print_bint_hex_py(ptrR);
+            printf(") and ("); print_bint_hex_py(ptrQ);
+            printf(" == 0 or ("); print_bint_hex_py(ptrQ);
+            printf(" < 0) == ((%d) != (%d))))\n", ptrX->sign, ptrY->sign);
+            delete_bint(&ptrX); delete_bint(&ptrQ); delete_bint(&ptrR);
+        }
+
+        delete_div_ctx(&ptrCtx);
+        delete_bint(&ptrY); delete_bint(&ptrI);
+        mpn_div_bz_threshold = bz; mpn_mul_karatsuba_threshold = kara; mpn_mul_fft_threshold = fft;
+        idx++;
+    }
+}
+
+void corretTEST_FFT(int test_cnt) {
+    srand((unsigned int)time(NULL));
+    int mul = mpn_mul_fft_threshold, sqr = mpn_sqr_fft_threshold;
+
+    int idx = 0x00;
+    while (idx < test_cnt) {
+        // Low thresholds, so that MAX_BIT_LENGTH operands go through the transform, unbalanced ones whole
+        mpn_mul_fft_threshold = mpn_sqr_fft_threshold = rand() % 16 + 1;
+        int xn = rand() % (MAX_BIT_LENGTH / WORD_BITLEN) + 1;
+        int yn = rand() % 2 ? xn : rand() % xn + 1;
+
+        BINT *ptrX = NULL, *ptrY = NULL, *ptrZ = NULL, *ptrS = NULL;
+        RANDOM_BINT(&ptrX, rand() % 2, xn);
+        RANDOM_BINT(&ptrY, rand() % 2, yn);
+        if (rand() % 4 == 0) {  // all-ones operands give the largest coefficients
+            for (int i = 0; i < ptrX->wordlen; i++) ptrX->val[i] = (WORD)~(WORD)0;
+            for (int i = 0; i < ptrY->wordlen; i++) ptrY->val[i] = (WORD)~(WORD)0;
+        }
+        MUL_Core_Krtsb_xyz(&ptrX, &ptrY, &ptrZ);
+        SQU_Krtsb_xz(&ptrX, &ptrS);
+
+        printf("print("); print_bint_hex_py(ptrX);
+        printf(" * "); print_bint_hex_py(ptrY);
+        printf(" == "); print_bint_hex_py(ptrZ);
+        printf(" and ("); print_bint_hex_py(ptrX);
+        printf(") ** 2 == "); print_bint_hex_py(ptrS);
+        printf(")\n");
+
+        delete_bint(&ptrX); delete_bint(&ptrY); delete_bint(&ptrZ); delete_bint(&ptrS);
+        idx++;
+    }
+
+    mpn_mul_fft_threshold = mul; mpn_sqr_fft_threshold = sqr;
+}
+
+void corretTEST_BarrettMul(int test_cnt) {
+    srand((unsigned int)time(NULL));
+
+    int idx = 0x00;
+    while (idx < test_cnt) {
+        int redMax = MAX_BIT_LENGTH / WORD_BITLEN;
+        int len = rand() % redMax + 1;
+
+        BINT *ptrX = NULL, *ptrY = NULL, *ptrN = NULL, *ptrT = NULL;
+        BINT *ptrZ = NULL, *ptrS = NULL, *ptrR = NULL;
+        BarrettCtx* ptrCtx = NULL;
+        RANDOM_BINT(&ptrX, false, len);
+        RANDOM_BINT(&ptrY, false, len);
+        RANDOM_BINT(&ptrT, false, rand() % (3 * len) + 1);
+        RANDOM_BINT(&ptrN, false, len);
+        if (rand() % 4 == 0)    // n close to W^(k-1), where the quotient estimate is loosest
+            ptrN->val[len - 1] = WORD_ONE;
+
+        init_barrett_ctx(&ptrCtx, ptrN);
+        BARRETT_Mul(&ptrX, &ptrY, &ptrZ, ptrCtx);
+        BARRETT_Sqr(&ptrX, &ptrS, ptrCtx);
+        BARRETT_Reduce(&ptrT, &ptrR, ptrCtx);
+
+        printf("print(("); print_bint_hex_py(ptrX);
+        printf(" * "); print_bint_hex_py(ptrY);
+        printf(") %% "); print_bint_hex_py(ptrN);
+        printf(" == "); print_bint_hex_py(ptrZ);
+        printf(" and ("); print_bint_hex_py(ptrX);
+        printf(" ** 2) %% "); print_bint_hex_py(ptrN);
+        printf(" == "); print_bint_hex_py(ptrS);
+        printf(" and "); print_bint_hex_py(ptrT);
+        printf(" %% "); print_bint_hex_py(ptrN);
+        printf(" == "); print_bint_hex_py(ptrR);
+        printf(")\n");
+
+        delete_barrett_ctx(&ptrCtx);
+        delete_bint(&ptrX); delete_bint(&ptrY); delete_bint(&ptrN); delete_bint(&ptrT);
+        delete_bint(&ptrZ); delete_bint(&ptrS); delete_bint(&ptrR);
+        idx++;
+    }
 }
 
 void corretTEST_BarrettRed(int test_cnt) {
@@ -356,7 +888,7 @@ void corretTEST_BarrettRed(int test_cnt) {
         copyBINT(&Y,&ptrN);
         init_bint(&W,(ptrX)->wordlen+1);
         W->val[(ptrX)->wordlen] = WORD_ONE;
-        DIV_Binary_Long(&W,&Y,&preT,&temp);
+        DIV_Long(&W,&Y,&preT,&temp);
 
         Barrett_Reduction(&ptrX,&ptrN,&ptrR,&preT);
 
@@ -419,6 +951,331 @@ void corretTEST_EEA(int test_cnt) {
     }
 }
 
+void corretTEST_HGCD(int test_cnt) {
+    srand((unsigned int)time(NULL));
+    int maxlen = MAX_BIT_LENGTH / WORD_BITLEN + 2;
+    int hgcd = mpn_hgcd_threshold, kara = mpn_mul_karatsuba_threshold;
+
+    int idx = 0x00;
+    while (idx < test_cnt) {
+        // Low thresholds half of the time, so that the half-GCD recursion runs several levels deep on test-sized
+        // operands
+        if (rand() % 2) {
+            mpn_hgcd_threshold = rand() % 8 + 4;
+            mpn_mul_karatsuba_threshold = rand() % 6 + 2;
+        }
+        // A common factor of any length, times cofactors of unrelated lengths, one of them zero now and then
+        BINT *ptrG = NULL, *ptrA = NULL, *ptrB = NULL, *ptrX = NULL, *ptrY = NULL;
+        BINT *ptrS = NULL, *ptrT = NULL, *ptrR = NULL;
+        init_bint(&ptrG, rand() % maxlen + 1);
+        init_bint(&ptrA, rand() % (2 * maxlen) + 1);
+        init_bint(&ptrB, rand() % (2 * maxlen) + 1);
+        edge_words(ptrG); edge_words(ptrA); edge_words(ptrB);
+        if (rand() % 16 == 0)
+            init_bint(rand() % 2 ? &ptrA : &ptrB, 1);
+        MUL_Core_Krtsb_xyz(&ptrG, &ptrA, &ptrX);
+        MUL_Core_Krtsb_xyz(&ptrG, &ptrB, &ptrY);
+        ptrX->sign = !isZero(ptrX) && rand() % 2;
+        ptrY->sign = !isZero(ptrY) && rand() % 2;
+
+        EEA(&ptrX, &ptrY, &ptrS, &ptrT, &ptrR);
+
+        printf("print("); print_bint_hex_py(ptrX);
+        printf(" * "); print_bint_hex_py(ptrS);
+        printf(" + "); print_bint_hex_py(ptrY);
+        printf(" * "); print_bint_hex_py(ptrT);
+        printf(" == "); print_bint_hex_py(ptrR);
+        printf(" == __import__('math').gcd("); print_bint_hex_py(ptrX);
+        printf(", "); print_bint_hex_py(ptrY);
+        printf("))\n");
+
+        delete_bint(&ptrG); delete_bint(&ptrA); delete_bint(&ptrB);
+        delete_bint(&ptrX); delete_bint(&ptrY);
+        delete_bint(&ptrS); delete_bint(&ptrT); delete_bint(&ptrR);
+        mpn_hgcd_threshold = hgcd; mpn_mul_karatsuba_threshold = kara;
+        idx++;
+    }
+}
+
+void corretTEST_BinaryGCD(int test_cnt) {
+    srand((unsigned int)time(NULL));
+    int maxlen = MAX_BIT_LENGTH / WORD_BITLEN + 2;
+
+    int idx = 0x00;
+    while (idx < test_cnt) {
+        // Signed multiples of a common factor with a power of two in it, one of them zero now and then
+        BINT *ptrG = NULL, *ptrA = NULL, *ptrB = NULL, *ptrX = NULL, *ptrY = NULL, *ptrR = NULL;
+        init_bint(&ptrG, rand() % maxlen + 1);
+        init_bint(&ptrA, rand() % (2 * maxlen) + 1);
+        init_bint(&ptrB, rand() % (2 * maxlen) + 1);
+        edge_words(ptrG); edge_words(ptrA); edge_words(ptrB);
+        ptrG->val[0] = (WORD)(ptrG->val[0] << (rand() % WORD_BITLEN));
+        if (rand() % 16 == 0)
+            init_bint(rand() % 2 ? &ptrA : &ptrB, 1);
+        MUL_Core_Krtsb_xyz(&ptrG, &ptrA, &ptrX);
+        MUL_Core_Krtsb_xyz(&ptrG, &ptrB, &ptrY);
+        ptrX->sign = !isZero(ptrX) && rand() % 2;
+        ptrY->sign = !isZero(ptrY) && rand() % 2;
+
+        GCD_Binary(&ptrX, &ptrY, &ptrR);
+
+        printf("print("); print_bint_hex_py(ptrR);
+        printf(" == __import__('math').gcd("); print_bint_hex_py(ptrX);
+        printf(", "); print_bint_hex_py(ptrY);
+        printf("))\n");
+
+        delete_bint(&ptrG); delete_bint(&ptrA); delete_bint(&ptrB);
+        delete_bint(&ptrX); delete_bint(&ptrY); delete_bint(&ptrR);
+        idx++;
+    }
+}
+
+void corretTEST_SafeGCD(int test_cnt) {
+    srand((unsigned int)time(NULL));
+    int maxlen = MAX_BIT_LENGTH / WORD_BITLEN + 2;
+
+    int idx = 0x00;
+    while (idx < test_cnt) {
+        // An odd modulus with an odd factor g; a quarter of the values share g and have no inverse, and a
+        // quarter are short. Values are reduced, as INV_MOD_SafeGCD expects, and half of them padded to k words
+        BINT *ptrG = NULL, *ptrA = NULL, *ptrN = NULL, *ptrX = NULL, *ptrZ = NULL;
+        init_bint(&ptrG, rand() % maxlen + 1);
+        init_bint(&ptrA, rand() % maxlen + 1);
+        edge_words(ptrG); edge_words(ptrA);
+        ptrG->val[0] |= 1; ptrA->val[0] |= 1;
+        MUL_Core_Krtsb_xyz(&ptrG, &ptrA, &ptrN);
+        int k = ptrN->wordlen, kind = rand() % 4;
+        init_bint(&ptrX, kind == 3 ? rand() % k + 1 : k);
+        edge_words(ptrX);
+        if (kind == 0) {
+            MUL_Core_Krtsb_xyz(&ptrG, &ptrX, &ptrZ);
+            copyBINT(&ptrX, &ptrZ);
+        }
+        BINT* ptrQ = NULL;
+        DIV_Long(&ptrX, &ptrN, &ptrQ, &ptrZ);
+        copyBINT(&ptrX, &ptrZ);
+        delete_bint(&ptrQ);
+        refineBINT(ptrX);
+        if (rand() % 2) {
+            reserveBINT(ptrX, k);
+            mpn_zero(ptrX->val + ptrX->wordlen, k - ptrX->wordlen);
+            ptrX->wordlen = k;
+        }
+
+        bool ok = INV_MOD_SafeGCD(&ptrX, &ptrZ, ptrN);
+
+        printf("print((%d == 1) == (__import__('math').gcd(", ok); print_bint_hex_py(ptrX);
+        printf(", "); print_bint_hex_py(ptrN);
+        printf(") == 1) and (%d == 0 or (", ok); print_bint_hex_py(ptrX);
+        printf(" * "); print_bint_hex_py(ptrZ);
+        printf(" - 1) %% "); print_bint_hex_py(ptrN);
+        printf(" == 0 and 0 <= "); print_bint_hex_py(ptrZ);
+        printf(" < "); print_bint_hex_py(ptrN);
+        printf("))\n");
+
+        delete_bint(&ptrG); delete_bint(&ptrA); delete_bint(&ptrN);
+        delete_bint(&ptrX); delete_bint(&ptrZ);
+        idx++;
+    }
+}
+
+/*
+ * DLP test parameters: p = cofactor * order + 1 with prime p and prime order,
+ * and a base whose (p-1)/order-th power generates the subgroup of that order.
+ */
+static const u64 DLP_PARAMS[][4] = {
+    { 0x5e9967b01ULL,         0xb00ULL,  0x899951ULL,      2 }, // 24-bit order
+    { 0x1b11a5aa0dbULL,       0x1c92ULL, 0xf28c105ULL,     2 }, // 28-bit order
+    { 0x73920b633675ULL,      0x7e44ULL, 0xea50df4dULL,    2 }, // 32-bit order
+    { 0x7531690b20cbULL,      0xadaULL,  0xaccb573d9ULL,   2 }, // 36-bit order
+    { 0x2dfad377a57b91ULL,    0x51b0ULL, 0x901886a7bbULL,  2 }, // 40-bit order
+    { 0x2c9954734150079ULL,   0x4708ULL, 0xa0bc99716efULL, 2 }, // 44-bit order
+};
+
+// Builds g of the given order and h = g^x for a random x from row idx of DLP_PARAMS
+static void DLP_INSTANCE(int idx, BINT** pptrG, BINT** pptrH, BINT** pptrMod, BINT** pptrOrder) {
+    BINT* ptrBase = NULL; BINT* ptrE = NULL;
+    set_bint_u64(pptrMod, DLP_PARAMS[idx][0]);
+    set_bint_u64(pptrOrder, DLP_PARAMS[idx][2]);
+    set_bint_u64(&ptrBase, DLP_PARAMS[idx][3]);
+    set_bint_u64(&ptrE, DLP_PARAMS[idx][1]);
+    EXP_MOD_L2R(&ptrBase, &ptrE, pptrG, *pptrMod);
+
+    u64 x = (((u64)rand() << 31) ^ (u64)rand()) % DLP_PARAMS[idx][2];
+    set_bint_u64(&ptrE, x);
+    EXP_MOD_L2R(pptrG, &ptrE, pptrH, *pptrMod);
+    delete_bint(&ptrBase); delete_bint(&ptrE);
+}
+
+#define TEST_DLP_TEMPLATE(SOLVE, test_cnt, rows) \
+    srand((unsigned int)time(NULL)); \
+    int idx = 0; \
+    while (idx < (test_cnt)) { \
+        BINT *ptrG = NULL, *ptrH = NULL, *ptrX = NULL, *ptrMod = NULL, *ptrOrder = NULL; \
+        DLP_INSTANCE(rand() % (rows), &ptrG, &ptrH, &ptrMod, &ptrOrder); \
+        if (!(SOLVE)) set_bint_u64(&ptrX, 0); \
+        printf("print(pow("); print_bint_hex_py(ptrG); \
+        printf(", "); print_bint_hex_py(ptrX); \
+        printf(", "); print_bint_hex_py(ptrMod); \
+        printf(") == "); print_bint_hex_py(ptrH); \
+        printf(")\n"); \
+        delete_bint(&ptrG); \
+        delete_bint(&ptrH); \
+        delete_bint(&ptrX); \
+        delete_bint(&ptrMod); \
+        delete_bint(&ptrOrder); \
+        idx++; \
+    }
+
+void corretTEST_BSGS(int test_cnt) {
+    TEST_DLP_TEMPLATE(DLP_BSGS(&ptrG, &ptrH, &ptrX, ptrMod, ptrOrder, BSGS_DEFAULT_MEMORY), test_cnt, 4);
+}
+
+void corretTEST_Rho(int test_cnt) {
+    TEST_DLP_TEMPLATE(DLP_Rho(&ptrG, &ptrH, &ptrX, ptrMod, ptrOrder, 0), test_cnt, 4);
+}
+
+void corretTEST_Kangaroo(int test_cnt) {
+    srand((unsigned int)time(NULL));
+
+    int idx = 0x00;
+    int rows = sizeof(DLP_PARAMS) / sizeof(DLP_PARAMS[0]);
+    while (idx < test_cnt) {
+        int row = rand() % rows;
+        BINT *ptrG = NULL, *ptrH = NULL, *ptrX = NULL, *ptrMod = NULL, *ptrOrder = NULL;
+        BINT *ptrA = NULL, *ptrB = NULL, *ptrE = NULL;
+        DLP_INSTANCE(row, &ptrG, &ptrH, &ptrMod, &ptrOrder);
+
+        // Re-target h to an exponent inside [a, a + w] with w of up to 28 bits and below half the order
+        u64 w = ((u64)rand() << 31 ^ (u64)rand()) % MINIMUM(1ULL << (16 + rand() % 13), DLP_PARAMS[row][2] / 2);
+        u64 a = ((u64)rand() << 31 ^ (u64)rand()) % (DLP_PARAMS[row][2] - w);
+        u64 x = a + ((u64)rand() << 31 ^ (u64)rand()) % (w + 1);
+        set_bint_u64(&ptrA, a);
+        set_bint_u64(&ptrB, a + w);
+        set_bint_u64(&ptrE, x);
+        EXP_MOD_L2R(&ptrG, &ptrE, &ptrH, ptrMod);
+
+        if (!DLP_Kangaroo(&ptrG, &ptrH, &ptrX, ptrMod, ptrA, ptrB, 0))
+            set_bint_u64(&ptrX, 0);
+
+        printf("print(pow("); print_bint_hex_py(ptrG);
+        printf(", "); print_bint_hex_py(ptrX);
+        printf(", "); print_bint_hex_py(ptrMod);
+        printf(") == "); print_bint_hex_py(ptrH);
+        printf(" and "); print_bint_hex_py(ptrA);
+        printf(" <= "); print_bint_hex_py(ptrX);
+        printf(" <= "); print_bint_hex_py(ptrB);
+        printf(")\n");
+
+        delete_bint(&ptrG); delete_bint(&ptrH); delete_bint(&ptrX);
+        delete_bint(&ptrMod); delete_bint(&ptrOrder);
+        delete_bint(&ptrA); delete_bint(&ptrB); delete_bint(&ptrE);
+        idx++;
+    }
+}
+
+// Generators of F_p^* together with the factorization of p-1
+static struct {
+    u64 p;
+    u64 g;
+    int num_factors;
+    u64 primes[8];
+    int exponents[8];
+} PH_PARAMS[] = {
+    { 0x39174cb37c6bULL,   2, 5, { 0x2ULL, 0x5ULL, 0xbULL,  0x1fULL, 0x20f2e1ULL }, { 1, 3, 2, 2, 1 } },
+    { 0xdfd897cee9c6c5ULL, 2, 5, { 0x2ULL, 0x7ULL, 0x13ULL, 0x2fULL, 0x2e3fa5ULL }, { 2, 3, 3, 2, 1 } },
+    { 0x201ae48ef4b5ULL,   5, 5, { 0x2ULL, 0x3ULL, 0x1fULL, 0x25ULL, 0x28b8bdULL }, { 2, 1, 3, 1, 1 } },
+};
+
+void corretTEST_PohligHellman(int test_cnt) {
+    srand((unsigned int)time(NULL));
+
+    int idx = 0x00;
+    int rows = sizeof(PH_PARAMS) / sizeof(PH_PARAMS[0]);
+    while (idx < test_cnt) {
+        int row = rand() % rows;
+        BINT *ptrG = NULL, *ptrH = NULL, *ptrX = NULL, *ptrMod = NULL, *ptrE = NULL;
+        BINT* ptrPrimes[8] = { NULL };
+
+        set_bint_u64(&ptrMod, PH_PARAMS[row].p);
+        set_bint_u64(&ptrG, PH_PARAMS[row].g);
+        for (int i = 0; i < PH_PARAMS[row].num_factors; i++)
+            set_bint_u64(&ptrPrimes[i], PH_PARAMS[row].primes[i]);
+        u64 x = (((u64)rand() << 31) ^ (u64)rand()) % (PH_PARAMS[row].p - 1);
+        set_bint_u64(&ptrE, x);
+        EXP_MOD_L2R(&ptrG, &ptrE, &ptrH, ptrMod);
+
+        if (!DLP_PohligHellman(&ptrG, &ptrH, &ptrX, ptrMod, ptrPrimes, PH_PARAMS[row].exponents,
+                               PH_PARAMS[row].num_factors, 0))
+            set_bint_u64(&ptrX, 0);
+
+        printf("print(pow("); print_bint_hex_py(ptrG);
+        printf(", "); print_bint_hex_py(ptrX);
+        printf(", "); print_bint_hex_py(ptrMod);
+        printf(") == "); print_bint_hex_py(ptrH);
+        printf(")\n");
+
+        delete_bint(&ptrG); delete_bint(&ptrH);
+        delete_bint(&ptrX); delete_bint(&ptrMod); delete_bint(&ptrE);
+        for (int i = 0; i < PH_PARAMS[row].num_factors; i++)
+            delete_bint(&ptrPrimes[i]);
+        idx++;
+    }
+}
+
+// Safe primes p = 2q + 1 with a generator g of F_p^*
+static const u64 IC_PARAMS[][3] = {
+    { 0x8b8e8f4fULL,   0x45c747a7ULL,   5 }, // 32-bit p
+    { 0x9b1c2ae90fULL, 0x4d8e157487ULL, 5 }, // 40-bit p
+};
+
+void corretTEST_IndexCalculus(int test_cnt) {
+    srand((unsigned int)time(NULL));
+
+    int row = rand() % (int)(sizeof(IC_PARAMS) / sizeof(IC_PARAMS[0]));
+    BINT *ptrG = NULL, *ptrMod = NULL, *ptrOrder = NULL, *ptrC = NULL;
+    IC_DB* ptrDB = NULL;
+    set_bint_u64(&ptrMod, IC_PARAMS[row][0]);
+    set_bint_u64(&ptrOrder, IC_PARAMS[row][1]);
+    set_bint_u64(&ptrG, IC_PARAMS[row][2]);
+    set_bint_u64(&ptrC, (IC_PARAMS[row][0] - 1) / IC_PARAMS[row][1]);
+
+    // The targets are solved from a database that went through the disk
+    if (!IC_Precompute(&ptrDB, &ptrG, ptrMod, ptrOrder, 300, 0) || !IC_Save(ptrDB, "IC_TEST.db") ||
+        !IC_Load(&ptrDB, "IC_TEST.db")) {
+        printf("print(False)\n");
+        delete_ic_db(&ptrDB);
+        delete_bint(&ptrG); delete_bint(&ptrMod); delete_bint(&ptrOrder); delete_bint(&ptrC);
+        return;
+    }
+    remove("IC_TEST.db");
+
+    int idx = 0x00;
+    while (idx < test_cnt) {
+        BINT *ptrH = NULL, *ptrX = NULL, *ptrE = NULL;
+        set_bint_u64(&ptrE, (((u64)rand() << 31) ^ (u64)rand()) % IC_PARAMS[row][0]);
+        EXP_MOD_L2R(&ptrG, &ptrE, &ptrH, ptrMod);
+
+        if (!DLP_IndexCalculus(ptrDB, &ptrH, &ptrX, 0))
+            set_bint_u64(&ptrX, 0);
+
+        // x is only defined modulo q: compare both sides in the subgroup of order q
+        printf("print(pow("); print_bint_hex_py(ptrG);
+        printf(", "); print_bint_hex_py(ptrX);
+        printf(" * "); print_bint_hex_py(ptrC);
+        printf(", "); print_bint_hex_py(ptrMod);
+        printf(") == pow("); print_bint_hex_py(ptrH);
+        printf(", "); print_bint_hex_py(ptrC);
+        printf(", "); print_bint_hex_py(ptrMod);
+        printf("))\n");
+
+        delete_bint(&ptrH); delete_bint(&ptrX); delete_bint(&ptrE);
+        idx++;
+    }
+    delete_ic_db(&ptrDB);
+    delete_bint(&ptrG); delete_bint(&ptrMod); delete_bint(&ptrOrder); delete_bint(&ptrC);
+}
+
 void performTEST_MUL() {
     performTEST_3ArgFn(mul_core_TxtBk_xyz,MUL_Core_ImpTxtBk_xyz);
 }
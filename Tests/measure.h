@@ -10,7 +10,7 @@
 #ifndef _MEASURE_H
 #define _MEASURE_H
 
-#include "../arithmetic.h"
+#include "../dlp.h"
 
 // Define Macros for Bit Lengths based on 8-bit word units
 #define u8_BIT_1024 0x080  // 128 * 8 = 1024 bits
@@ -214,6 +214,145 @@ void corretTEST_EXP_MOD_R2L(int test_cnt);
  */
 void corretTEST_EXP_MOD_Montgomery(int test_cnt);
 
+/**
+ * @brief Correctness Test for Fixed-Window (k-ary) Modular Exponentiation
+ * @details Like the other EXP_MOD tests, but with exponents of up to MAX_BIT_LENGTH bits so that every window
+ *          width is reached. Prints one Python pow() check per test case.
+ * @param test_cnt Number of test cases intended for execution.
+ */
+void corretTEST_EXP_MOD_KAry(int test_cnt);
+
+/**
+ * @brief Correctness Test for Sliding-Window Modular Exponentiation
+ * @details Like the other EXP_MOD tests, but with exponents of up to MAX_BIT_LENGTH bits so that every window
+ *          width is reached. Prints one Python pow() check per test case.
+ * @param test_cnt Number of test cases intended for execution.
+ */
+void corretTEST_EXP_MOD_Sliding(int test_cnt);
+
+/**
+ * @brief Correctness Test for Simultaneous Multi-Exponentiation
+ * @details Raises one to four random bases to random exponents of different lengths with EXP_MOD_Multi, modulo a
+ *          random modulus of either parity, and prints a Python check against the product of pow() calls.
+ * @param test_cnt Number of test cases intended for execution.
+ */
+void corretTEST_EXP_MOD_Multi(int test_cnt);
+
+/**
+ * @brief Correctness Test for Montgomery Multiplication
+ * @details Builds a Montgomery context for a random odd modulus, converts two random operands into Montgomery form,
+ *          multiplies and squares them with MONT_Mul and MONT_Sqr and converts the results back. Prints a Python
+ *          check of both against (x * y) % n and (x * x) % n.
+ * @param test_cnt The number of test cases to be executed.
+ * @pre init_mont_ctx, MONT_To, MONT_From, MONT_Mul and MONT_Sqr must be implemented.
+ * @post Outputs one Python assertion per test case.
+ */
+void corretTEST_MontMul(int test_cnt);
+
+/**
+ * @brief Correctness Test for the Barrett Context
+ * @details Builds a Barrett context for a random modulus of either parity, sometimes with a top word of one, and
+ *          checks BARRETT_Mul, BARRETT_Sqr and BARRETT_Reduce (on an input of up to three times the modulus length)
+ *          against Python in one assertion.
+ * @param test_cnt The number of test cases to be executed.
+ * @pre init_barrett_ctx, BARRETT_Mul, BARRETT_Sqr and BARRETT_Reduce must be implemented.
+ * @post Outputs one Python assertion per test case.
+ */
+void corretTEST_BarrettMul(int test_cnt);
+
+/**
+ * @brief Correctness Test for Fixed-Base Exponentiation
+ * @details Builds a fixed-base table for a random base and modulus with a random width and exponent bound, saves it
+ *          to disk and loads it back, then checks one exponent inside the bound and one beyond it (the fallback)
+ *          against Python's pow().
+ * @param test_cnt The number of test cases to be executed.
+ * @pre init_fixed_base, FB_Save, FB_Load and EXP_MOD_FixedBase must be implemented.
+ * @post Outputs one Python assertion per test case and leaves no file behind.
+ */
+void corretTEST_FixedBase(int test_cnt);
+
+/**
+ * @brief Correctness Test for the BINT Arena
+ * @details Runs a Karatsuba multiplication, a binary long division and a loop of textbook multiplications that rolls
+ *          the arena back after every round inside one scope, then checks the objects carried out of the scope
+ *          against Python's arithmetic. A multiplication and a division repeated outside the scope must not call
+ *          malloc, as their scratch comes from the arena. The arena is released with bint_arena_release_thread
+ *          after every other test case.
+ * @param test_cnt The number of test cases to be executed.
+ * @pre bint_arena_begin, bint_arena_rollback, bint_arena_end, bint_arena_release_thread and
+ *      bint_heap_calls must be implemented.
+ * @post Outputs one Python assertion per test case.
+ */
+void corretTEST_Arena(int test_cnt);
+
+/**
+ * @brief Correctness Test for the mpn Word Kernels
+ * @details Runs mpn_mul, mpn_sqr_n, the Comba kernels, mpn_div_qr, mpn_div_binary and a left/right shift pair
+ *          directly on the words of caller-owned BINTs, and ADD, SUB, their in-place variants and MUL_Core_Krtsb_xyz
+ *          on signed operands with the output aliasing an input, then checks everything against Python's arithmetic.
+ * @param test_cnt The number of test cases to be executed.
+ * @pre The kernels of mpn.h must be implemented.
+ * @post Outputs one Python assertion per test case.
+ */
+void corretTEST_Mpn(int test_cnt);
+
+/**
+ * @brief Correctness Test for Toom-Cook Multiplication
+ * @details Lowers the Karatsuba, Toom-3 and Toom-4 thresholds to a few words so that MUL_Core_Krtsb_xyz and
+ *          SQU_Krtsb_xz recurse through every algorithm, then checks signed, balanced and unbalanced products and
+ *          squares, some of all-ones operands, against Python's arithmetic. The thresholds are restored afterwards.
+ * @param test_cnt The number of test cases to be executed.
+ * @pre The Toom-3 and Toom-4 kernels of mpn.c must be implemented.
+ * @post Outputs one Python assertion per test case.
+ */
+void corretTEST_Toom(int test_cnt);
+
+/**
+ * @brief Correctness Test for Knuth's Algorithm D
+ * @details Checks DIV_Long against Python's divmod on signed operands of any relative lengths, including dividends
+ *          shorter than or equal to the divisor, one-word divisors, all-ones and lone-top-bit words, and dividends
+ *          that begin with the divisor less one, which reach the branches of mpn_div_qr that random operands
+ *          almost never do.
+ * @param test_cnt The number of test cases to be executed.
+ * @pre mpn_div_qr must be implemented.
+ * @post Outputs one Python assertion per test case.
+ */
+void corretTEST_KnuthDIV(int test_cnt);
+
+/**
+ * @brief Correctness Test for Burnikel-Ziegler Division
+ * @details Lowers the Burnikel-Ziegler and Karatsuba thresholds to a few words so that DIV_Long recurses down to
+ *          the schoolbook rows, then checks operands built as in corretTEST_KnuthDIV, with dividends of up to four
+ *          times the divisor's length, against Python's divmod. The thresholds are restored afterwards.
+ * @param test_cnt The number of test cases to be executed.
+ * @pre mpn_div_qr must be implemented.
+ * @post Outputs one Python assertion per test case.
+ */
+void corretTEST_BZDIV(int test_cnt);
+
+/**
+ * @brief Correctness Test for Division by Invariant Divisors
+ * @details Creates a DivCtx for a signed divisor built as in corretTEST_KnuthDIV and checks its Newton reciprocal,
+ *          then four numerators of any length divided with DIV_Invariant, against Python's arithmetic. Half of the
+ *          cases lower the Burnikel-Ziegler and Karatsuba thresholds so that the Newton recursion and the
+ *          preinverted blocks run; the thresholds are restored afterwards.
+ * @param test_cnt The number of divisors to be tested.
+ * @pre mpn_invert and mpn_div_qr_preinv must be implemented.
+ * @post Outputs five Python assertions per divisor.
+ */
+void corretTEST_DivInvariant(int test_cnt);
+
+/**
+ * @brief Correctness Test for NTT Multiplication
+ * @details Lowers the NTT thresholds to a few words so that MUL_Core_Krtsb_xyz and SQU_Krtsb_xz multiply by the
+ *          transform, then checks signed, balanced and unbalanced products and squares, some of all-ones operands,
+ *          against Python's arithmetic. The thresholds are restored afterwards.
+ * @param test_cnt The number of test cases to be executed.
+ * @pre mpn_mul_fft and mpn_sqr_fft must be implemented.
+ * @post Outputs one Python assertion per test case.
+ */
+void corretTEST_FFT(int test_cnt);
+
 /**
  * @brief Correctness Test for Barrett Reduction
  * @details This function performs a series of tests to assess the correctness of the Barrett Reduction algorithm. 
@@ -240,6 +379,93 @@ void corretTEST_BarrettRed(int test_cnt);
  */
 void corretTEST_EEA(int test_cnt);
 
+/**
+ * @brief Correctness Test for the Lehmer and Half-GCD Steps of EEA
+ * @details Runs EEA on signed multiples of a common factor, with cofactors of unrelated lengths and now and then a
+ *          zero operand, and checks Bézout's identity and the GCD against Python's math.gcd. Half of the cases lower
+ *          the half-GCD and Karatsuba thresholds so that the recursion runs several levels deep; the thresholds
+ *          are restored afterwards.
+ * @param test_cnt The number of operand pairs to be tested.
+ * @pre mpn_gcd_lehmer and EEA must be implemented.
+ * @post Outputs one Python assertion per test case.
+ */
+void corretTEST_HGCD(int test_cnt);
+
+/**
+ * @brief Correctness Test for the Binary GCD
+ * @details Runs GCD_Binary on signed multiples of a common factor that carries a power of two, with cofactors of
+ *          unrelated lengths and now and then a zero operand, and checks the result against Python's math.gcd.
+ * @param test_cnt The number of operand pairs to be tested.
+ * @pre mpn_gcd_binary must be implemented.
+ * @post Outputs one Python assertion per test case.
+ */
+void corretTEST_BinaryGCD(int test_cnt);
+
+/**
+ * @brief Correctness Test for Constant-Time Modular Inversion
+ * @details Inverts values modulo odd products g * a with INV_MOD_SafeGCD: reduced values, multiples of g that
+ *          have no inverse, and short ones, half of them padded to the words of n. Checks the reported
+ *          invertibility against Python's math.gcd and, where there is an inverse, that it lies in [0, n) and
+ *          inverts X.
+ * @param test_cnt The number of moduli to be tested.
+ * @pre mpn_sec_invert must be implemented.
+ * @post Outputs one Python assertion per test case.
+ */
+void corretTEST_SafeGCD(int test_cnt);
+
+/**
+ * @brief Correctness Test for Baby-Step Giant-Step
+ * @details Solves random discrete logarithm instances g^x = h (mod p) in prime-order subgroups with DLP_BSGS
+ *          and prints a Python check that the returned exponent maps g to h.
+ * @param test_cnt The number of test cases to run.
+ * @pre DLP_BSGS must be implemented and the test parameter table must hold valid (p, cofactor, order, base) rows.
+ * @post Outputs one Python assertion per test case.
+ * @note The instances use subgroup orders of 24 to 36 bits so that the test finishes in seconds.
+ */
+void corretTEST_BSGS(int test_cnt);
+
+/**
+ * @brief Correctness Test for Parallel Pollard Rho
+ * @details Solves random discrete logarithm instances g^x = h (mod p) in prime-order subgroups with DLP_Rho
+ *          on every online core and prints a Python check that the returned exponent maps g to h.
+ * @param test_cnt The number of test cases to run.
+ * @pre DLP_Rho must be implemented and the test parameter table must hold valid (p, cofactor, order, base) rows.
+ * @post Outputs one Python assertion per test case.
+ */
+void corretTEST_Rho(int test_cnt);
+
+/**
+ * @brief Correctness Test for Pohlig-Hellman
+ * @details Solves random discrete logarithm instances g^x = h (mod p) for generators g of F_p^* with smooth p-1
+ *          using DLP_PohligHellman and prints a Python check that the returned exponent maps g to h.
+ * @param test_cnt The number of test cases to run.
+ * @pre DLP_PohligHellman must be implemented and the test parameter table must hold complete factorizations of p-1.
+ * @post Outputs one Python assertion per test case.
+ */
+void corretTEST_PohligHellman(int test_cnt);
+
+/**
+ * @brief Correctness Test for Parallel Kangaroo
+ * @details Solves random discrete logarithm instances g^x = h (mod p) whose exponent is known to lie in a short
+ *          interval [a, b] with DLP_Kangaroo and prints a Python check that the returned exponent maps g to h
+ *          and lies in the interval.
+ * @param test_cnt The number of test cases to run.
+ * @pre DLP_Kangaroo must be implemented and the test parameter table must hold valid (p, cofactor, order, base) rows.
+ * @post Outputs one Python assertion per test case.
+ */
+void corretTEST_Kangaroo(int test_cnt);
+
+/**
+ * @brief Correctness Test for Index Calculus
+ * @details Builds an index calculus database for a safe prime field with IC_Precompute, round-trips it through
+ *          IC_Save and IC_Load, and solves random targets with DLP_IndexCalculus. Prints a Python check that
+ *          the returned logarithm is correct modulo q, where p = 2q + 1.
+ * @param test_cnt The number of targets to solve with the database.
+ * @pre IC_Precompute, IC_Save, IC_Load and DLP_IndexCalculus must be implemented and the working directory writable.
+ * @post Outputs one Python assertion per test case.
+ */
+void corretTEST_IndexCalculus(int test_cnt);
+
 void performTEST_MUL();
 void performTEST_SQU();
 void performTEST_DIV(int test_cnt);
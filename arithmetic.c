@@ -4,7 +4,8 @@
  *
  * This file contains the implementation of more complex arithmetic operations
  * for large integers (BINT), such as multiplication and division, building upon
- * the basic operations provided in utils.h and utils.c.
+ * the basic operations provided in utils.h and utils.c and on the word-array
+ * kernels of mpn.h.
  */
 
 #include <stdio.h>
@@ -12,6 +13,81 @@
 #include <string.h>
 
 #include "arithmetic.h"
+#include "mpn.h"
+
+/*
+ * BINT wrappers over the mpn kernels: signs, sizes and storage are handled here, the words in mpn.c
+ */
+
+// Number of significant words of X, at least one
+static int bint_size(const BINT* ptrX) {
+    int n = mpn_normalize(ptrX->val, ptrX->wordlen);
+    return n > 0 ? n : 1;
+}
+
+// Gives *pptrZ room for an n-word result without clearing it, so that Z may still be one of the operands
+static BINT* bint_result(BINT** pptrZ, int n) {
+    if (*pptrZ == NULL)
+        init_bint(pptrZ, n);
+    else
+        reserveBINT(*pptrZ, n);
+    (*pptrZ)->wordlen = n;
+    return *pptrZ;
+}
+
+// The object an out-of-place kernel writes to: Z itself, or the stack temporary when Z is one of the operands
+static BINT* bint_target(BINT** pptrZ, const BINT* ptrX, const BINT* ptrY, BINT* ptrTmp, int n) {
+    if (*pptrZ != NULL && (*pptrZ == ptrX || *pptrZ == ptrY))
+        return bint_result(&ptrTmp, n);
+    return bint_result(pptrZ, n);
+}
+
+// Moves a result written by bint_target into Z and sets its sign
+static void bint_settle(BINT** pptrZ, BINT* ptrOut, BINT* ptrTmp, bool sign) {
+    if (ptrOut == ptrTmp) {
+        swapBINT(pptrZ, &ptrTmp);
+        clear_bint(ptrTmp);
+    }
+    (*pptrZ)->sign = sign;
+    refineBINT(*pptrZ);
+}
+
+// Z <- |X| + |Y|; Z may be X or Y
+static void add_abs(BINT* ptrX, BINT* ptrY, BINT** pptrZ) {
+    int n = bint_size(ptrX), m = bint_size(ptrY);
+    if (n < m) {
+        BINT* ptrT = ptrX; ptrX = ptrY; ptrY = ptrT;
+        int t = n; n = m; m = t;
+    }
+    BINT* ptrZ = bint_result(pptrZ, n + 1);
+    ptrZ->val[n] = mpn_add(ptrZ->val, ptrX->val, n, ptrY->val, m);
+}
+
+// Z <- ||X| - |Y||, returns true when |Y| > |X|; Z may be X or Y
+static bool sub_abs(BINT* ptrX, BINT* ptrY, BINT** pptrZ) {
+    int n = bint_size(ptrX), m = bint_size(ptrY);
+    int cmp = n != m ? (n > m ? 1 : -1) : mpn_cmp(ptrX->val, ptrY->val, n);
+    if (cmp < 0) {
+        BINT* ptrT = ptrX; ptrX = ptrY; ptrY = ptrT;
+        int t = n; n = m; m = t;
+    }
+    BINT* ptrZ = bint_result(pptrZ, n);
+    mpn_sub(ptrZ->val, ptrX->val, n, ptrY->val, m);
+    return cmp < 0;
+}
+
+// Z <- X + Y or X - Y by the signs of the operands; X and Y are left as they are
+static void add_signed(BINT** pptrX, BINT** pptrY, BINT** pptrZ, bool negY) {
+    bool sgnX = (*pptrX)->sign;
+    bool sgnY = (*pptrY)->sign ^ negY;
+    bool sign = sgnX;
+    if (sgnX == sgnY)
+        add_abs(*pptrX, *pptrY, pptrZ);
+    else if (sub_abs(*pptrX, *pptrY, pptrZ))
+        sign = sgnY;
+    (*pptrZ)->sign = sign;
+    refineBINT(*pptrZ);
+}
 
 void OR_BINT(BINT** pptrX, BINT** pptrY, BINT** pptrZ) {
     int min_len = MINIMUM((*pptrX)->wordlen, (*pptrY)->wordlen);
@@ -30,710 +106,880 @@ void OR_BINT(BINT** pptrX, BINT** pptrY, BINT** pptrZ) {
 }
 
 void add_carry(WORD x, WORD y, WORD k, WORD* ptrQ, WORD* ptrR) {
-    WORD sum = x + y;
-	*ptrQ = 0x00;
-	if(sum < x)
-		*ptrQ = WORD_ONE;
-	sum += k;
-	*ptrR = sum;
-	if(sum < k)
-		*ptrQ += WORD_ONE;
+    // Both carries are comparison results, so there is no branch to mispredict
+    WORD sum = (WORD)(x + y);
+    WORD carry = sum < x;
+    sum = (WORD)(sum + k);
+    carry += sum < k;
+    *ptrQ = carry;
+    *ptrR = sum;
 }
 
 void add_core_xyz(BINT** pptrX, BINT** pptrY, BINT** pptrZ) {
     CHECK_PTR_AND_DEREF(pptrX, "pptrX", "add_core_xyz");
     CHECK_PTR_AND_DEREF(pptrY, "pptrY", "add_core_xyz");
-    if (!compare_abs_bint(*pptrX,*pptrY)) {
-        add_core_xyz(pptrY, pptrX, pptrZ);
-        return;
-    }  
-
-    init_bint(pptrZ, (*pptrX)->wordlen + 1);
-    CHECK_PTR_AND_DEREF(pptrZ, "pptrZ", "add_core_xyz");
-
-    WORD res = 0x00;
-    WORD carry = 0x00;
-    int k = 0x00;
-
-    for(int i = 0; i < (*pptrY)->wordlen; i++) {
-        add_carry((*pptrX)->val[i], (*pptrY)->val[i], k, &carry, &res);
-        (*pptrZ)->val[i] = res;
-        k = carry;
-    }
-    for (int i = (*pptrY)->wordlen; i < (*pptrX)->wordlen; i++) {
-        add_carry((*pptrX)->val[i],(WORD)0, k, &carry, &res);
-        (*pptrZ)->val[i] = res;
-        k = carry;
-    }
-    (*pptrZ)->val[(*pptrX)->wordlen] = k;
+    exit_on_null_error(pptrZ, "pptrZ", "add_core_xyz");
+    add_abs(*pptrX, *pptrY, pptrZ);
+    (*pptrZ)->sign = false;
     refineBINT(*pptrZ);
 }
 
 void ADD(BINT** pptrX, BINT** pptrY, BINT** pptrZ) {
     CHECK_PTR_AND_DEREF(pptrX, "pptrX", "ADD");
     CHECK_PTR_AND_DEREF(pptrY, "pptrY", "ADD");
-    if (!compare_abs_bint(*pptrX, *pptrY)) {
-        ADD(pptrY, pptrX, pptrZ);
-        swapBINT(pptrX,pptrY);
-        return;
-    }    
-    int n = (*pptrX)->wordlen;
-
-    init_bint(pptrZ, n+1);
-    CHECK_PTR_AND_DEREF(pptrZ, "pptrZ", "ADD");
-    
-    if ((*pptrX)->sign == (*pptrY)->sign) {
-        // If signs are the same, add the numbers
-        add_core_xyz(pptrX, pptrY, pptrZ);
-        if ((*pptrX)->sign) {
-            // If both numbers are negative, then result is negative
-            (*pptrZ)->sign = true;
-        }
-    } else {
-        // If signs are different, subtract the numbers
-        sub_core_xyz(pptrX, pptrY, pptrZ);
-        if ((*pptrX)->sign) {
-            // If X is negative and Y is positive, then result is negative
-            (*pptrZ)->sign = true;
-        }
-    }
+    exit_on_null_error(pptrZ, "pptrZ", "ADD");
+    add_signed(pptrX, pptrY, pptrZ, false);
 }
 
 void sub_borrow(WORD x, WORD y, WORD* ptrQ, WORD* ptrR) {
-    WORD tmp = (WORD)x - *ptrQ;
-    *ptrQ = 0x00;
-    if (x < tmp)
-        *ptrQ = 0x01;
-    if (tmp < y)
-        *ptrQ += 0x01;
-    tmp = (WORD)tmp-y;
-    *ptrR = tmp;
+    WORD tmp = (WORD)(x - *ptrQ);
+    WORD borrow = (WORD)(x < tmp) + (WORD)(tmp < y);
+    *ptrQ = borrow;
+    *ptrR = (WORD)(tmp - y);
 }
+
 void sub_core_xyz(BINT** pptrX, BINT** pptrY, BINT** pptrZ) {
     CHECK_PTR_AND_DEREF(pptrX, "pptrX", "sub_core_xyz");
     CHECK_PTR_AND_DEREF(pptrY, "pptrY", "sub_core_xyz");
-    int n = (*pptrX)->wordlen; int m = (*pptrY)->wordlen;
-    bool xGeqy = compare_abs_bint(*pptrX, *pptrY);
-    if (!xGeqy) {
-        sub_core_xyz(pptrY, pptrX, pptrZ);
-        swapBINT(pptrX,pptrY);
-        return;
-    }  
-
-    init_bint(pptrZ, MAXIMUM(n,m));
-    CHECK_PTR_AND_DEREF(pptrZ, "pptrZ", "sub_core_xyz");
-    
-    WORD res = 0x00;
-    WORD borrow = 0x00;
-
-    matchSize(*pptrX,*pptrY);
-    for(int i = 0; i < m; i++) {
-        sub_borrow((*pptrX)->val[i], (*pptrY)->val[i], &borrow, &res);
-        (*pptrZ)->val[i] = res;
-    }
-    for(int i = m; i < n; i++) {
-        sub_borrow((*pptrX)->val[i], (WORD)0, &borrow, &res);
-        (*pptrZ)->val[i] = res;
-    }
-    refineBINT(*pptrX); refineBINT(*pptrY); refineBINT(*pptrZ);
-    if(!xGeqy) swapBINT(pptrX,pptrY);
+    exit_on_null_error(pptrZ, "pptrZ", "sub_core_xyz");
+    sub_abs(*pptrX, *pptrY, pptrZ);
+    (*pptrZ)->sign = false;
+    refineBINT(*pptrZ);
 }
+
 void SUB(BINT** pptrX, BINT** pptrY, BINT** pptrZ) {
     CHECK_PTR_AND_DEREF(pptrX, "pptrX", "SUB");
     CHECK_PTR_AND_DEREF(pptrY, "pptrY", "SUB");
-    int n = (*pptrX)->wordlen;
-    int m = (*pptrY)->wordlen;
-    bool sgnX = (*pptrX)->sign;
-    bool sgnY = (*pptrY)->sign;
-    
-    init_bint(pptrZ, MAXIMUM(n,m));
-    CHECK_PTR_AND_DEREF(pptrZ, "pptrZ", "SUB");
-
-
-    bool xGeqy = compare_bint(*pptrX, *pptrY);
-    if ((*pptrY)->sign == false && xGeqy) {
-        sub_core_xyz(pptrX,pptrY,pptrZ);
-    } else if ((*pptrX)->sign == false && !xGeqy) {
-        sub_core_xyz(pptrY,pptrX,pptrZ);
-        (*pptrZ)->sign = true;
-    } else if ((*pptrX)->sign == true && xGeqy) {
-        (*pptrX)->sign = false;
-        (*pptrY)->sign = false;
-        sub_core_xyz(pptrY,pptrX,pptrZ);
-    } else if ((*pptrY)->sign == true && !xGeqy) {
-        (*pptrX)->sign = false;
-        (*pptrY)->sign = false;
-        sub_core_xyz(pptrX,pptrY,pptrZ);
-        (*pptrZ)->sign = true;
-    } else if ((*pptrX)->sign == false && (*pptrY)->sign == true) {
-        (*pptrY)->sign = false;
-        ADD(pptrX,pptrY,pptrZ);
-    } else {
-        (*pptrX)->sign = false;
-        ADD(pptrX,pptrY,pptrZ);
-        (*pptrZ)->sign = true;
-    }
+    exit_on_null_error(pptrZ, "pptrZ", "SUB");
+    add_signed(pptrX, pptrY, pptrZ, true);
+}
 
-    (*pptrX)->sign = sgnX;
-    (*pptrY)->sign = sgnY;
+void ADD_Inplace(BINT** pptrX, BINT** pptrY) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "ADD_Inplace");
+    CHECK_PTR_AND_DEREF(pptrY, "pptrY", "ADD_Inplace");
+    add_signed(pptrX, pptrY, pptrX, false);
+}
+
+void SUB_Inplace(BINT** pptrX, BINT** pptrY) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "SUB_Inplace");
+    CHECK_PTR_AND_DEREF(pptrY, "pptrY", "SUB_Inplace");
+    add_signed(pptrX, pptrY, pptrX, true);
 }
 
 
 void mul_xyz(WORD valX, WORD valY, BINT** pptrZ) {
     CHECK_PTR_AND_DEREF(pptrZ, "pptrZ", "mul_xyz");
 
-    const int half_w = WORD_BITLEN / 2; // if w=32, half_w = 16 = 2^4
-	const WORD MASK = (WORD_ONE << half_w) - 1;
-	
-    // Split the WORDs into halves
-	WORD X0 = valX & MASK;
-	WORD X1 = valX >> half_w;
-	WORD Y0 = valY & MASK;
-	WORD Y1 = valY >> half_w;
-
-    // Cross multiplication
-	WORD T0 = X0 * Y1;
-	WORD T1 = X1 * Y0;
-	T0 = T0 + T1;
-	T1 = T0 < T1; // overflow
-
-    // Direct multiplication
-	WORD Z0 = X0 * Y0;
-	WORD Z1 = X1 * Y1;
-	
-    // Adjust for overflows
-	WORD T = Z0;
-	Z0 += (T0 << half_w);
-	Z1 += (T1 << half_w) + (T0 >> half_w) + (Z0 < T);
-	
-    // Set results
-	(*pptrZ)->val[0] = Z0;
-	(*pptrZ)->val[1] = Z1;
+    // One full-width product in the double-word type, a single 64x64 -> 128 multiply for 64-bit words
+    DWORD prod = (DWORD)valX * valY;
+    (*pptrZ)->val[0] = (WORD)prod;
+    (*pptrZ)->val[1] = (WORD)(prod >> WORD_BITLEN);
 }
 void mul_core_TxtBk_xyz(BINT** pptrX, BINT** pptrY, BINT** pptrZ) {
     CHECK_PTR_AND_DEREF(pptrX, "pptrX", "mul_core_TxtBk_xyz");
     CHECK_PTR_AND_DEREF(pptrY, "pptrY", "mul_core_TxtBk_xyz");
-    int n = (*pptrX)->wordlen; int m = (*pptrY)->wordlen;
-
-    init_bint(pptrZ, n+m);
-    CHECK_PTR_AND_DEREF(pptrZ, "pptrZ", "mul_core_TxtBk_xyz");
-
-    BINT* ptrWordMul = NULL;
-    BINT* ptrTemp = NULL;
-    init_bint(&ptrTemp, m+n);
-
-    for(int i = 0; i < n; i++) {
-        for(int j = 0; j < m; j++) {
-            init_bint(&ptrWordMul, 2);
-            mul_xyz((*pptrX)->val[i], (*pptrY)->val[j], &ptrWordMul);
-            left_shift_word(&ptrWordMul, (i+j));
-            add_core_xyz(pptrZ, &ptrWordMul , &ptrTemp);
-            copyBINT(pptrZ,&ptrTemp);
+    exit_on_null_error(pptrZ, "pptrZ", "mul_core_TxtBk_xyz");
+    BINT* ptrX = *pptrX; BINT* ptrY = *pptrY;
+    int n = bint_size(ptrX), m = bint_size(ptrY);
+    bool sign = ptrX->sign != ptrY->sign;
+
+    BINT tmp = BINT_INITIALIZER(tmp);
+    BINT* ptrZ = bint_target(pptrZ, ptrX, ptrY, &tmp, n + m);
+    mpn_mul_basecase(ptrZ->val, ptrX->val, n, ptrY->val, m);
+    bint_settle(pptrZ, ptrZ, &tmp, sign);
+}
+
+// r <- a * b, an + bn words, by the improved textbook method: for each word of b, the products with the even
+// and with the odd words of a are 2-word blocks that do not overlap, so they are laid side by side in t0 and t1
+// without carries and added to r as two whole rows. t takes 2 * an + 2 words.
+static void mul_imptxtbk_words(WORD* r, const WORD* a, int an, const WORD* b, int bn, WORD* t) {
+    int p = (an + 1) / 2, q = an / 2;
+    WORD* t0 = t;
+    WORD* t1 = t + 2 * p;
+    mpn_zero(r, an + bn);
+    for (int j = 0; j < bn; j++) {
+        for (int k = 0; k < p; k++) {
+            DWORD e = (DWORD)a[2 * k] * b[j];
+            t0[2 * k] = (WORD)e;
+            t0[2 * k + 1] = (WORD)(e >> WORD_BITLEN);
+        }
+        for (int k = 0; k < q; k++) {
+            DWORD o = (DWORD)a[2 * k + 1] * b[j];
+            t1[2 * k] = (WORD)o;
+            t1[2 * k + 1] = (WORD)(o >> WORD_BITLEN);
+        }
+        WORD c = mpn_add_n(r + j, r + j, t0, 2 * p);
+        mpn_add_1(r + j + 2 * p, r + j + 2 * p, an + bn - j - 2 * p, c);
+        if (q > 0) {
+            c = mpn_add_n(r + j + 1, r + j + 1, t1, 2 * q);
+            mpn_add_1(r + j + 1 + 2 * q, r + j + 1 + 2 * q, an + bn - j - 1 - 2 * q, c);
         }
     }
-    delete_bint(&ptrWordMul);
-    delete_bint(&ptrTemp);
-    if((*pptrX)->sign != (*pptrY)->sign)
-        (*pptrZ)->sign = true;
 }
 
 void MUL_Core_ImpTxtBk_xyz(BINT** pptrX, BINT** pptrY, BINT** pptrZ) {
-    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "mul_core_ImpTxtBk_test");
-    CHECK_PTR_AND_DEREF(pptrY, "pptrY", "mul_core_ImpTxtBk_test");
-    matchSize(*pptrX, *pptrY);
-    makeEven(*pptrX); makeEven(*pptrY);
-    int n = (*pptrX)->wordlen; int m = (*pptrX)->wordlen;
-
-    init_bint(pptrZ, n+m);
-    CHECK_PTR_AND_DEREF(pptrZ, "pptrZ", "mul_core_ImpTxtBk_test");
-
-    int p = n / 2; int q = n / 2;
-
-    BINT* ptrT = NULL;
-    init_bint(&ptrT, n+m);
-    BINT* ptrT0 = NULL;
-    init_bint(&ptrT0, 2*p);
-    BINT* ptrT1 = NULL;
-    init_bint(&ptrT1, 2*p+1);
-    BINT* ptrTmp0 = NULL;
-    init_bint(&ptrTmp0, 2*p);
-    BINT* ptrTmp1 = NULL;
-    init_bint(&ptrTmp1, 2*p+1);
-    BINT* ptrTmpZ = NULL;
-    init_bint(&ptrTmpZ, (*pptrZ)->wordlen);
-
-    for(int j = 0; j < 2 * q; j++) {
-        for(int k = 0; k < p; k++) {
-            resetBINT(ptrTmp0); resetBINT(ptrTmp1);
-            mul_xyz((*pptrX)->val[2*k], (*pptrY)->val[j], &ptrTmp0);
-            mul_xyz((*pptrX)->val[2*k+1], (*pptrY)->val[j], &ptrTmp1);
-            if (!k) {
-                copyBINT(&ptrT0, &ptrTmp0);
-                copyBINT(&ptrT1, &ptrTmp1);
-            } else {
-                left_shift_word(&ptrTmp0, 2*k);
-                refine_BINT_word(ptrTmp0, 2*k);
-                OR_BINT(&ptrTmp0, &ptrT0, &ptrT0);
-                left_shift_word(&ptrTmp1, 2*k);
-                refine_BINT_word(ptrTmp1, 2*k);
-                OR_BINT(&ptrTmp1, &ptrT1, &ptrT1);
-            }
-        }
-        left_shift_word(&ptrT1, 1);
-
-        ADD(&ptrT1, &ptrT0, &ptrT);
-        
-        left_shift_word(&ptrT, j);
-
-        copyBINT(&ptrTmpZ, pptrZ);
-        ADD(&ptrTmpZ, &ptrT, pptrZ);
-    }
-    // Cleanup
-    delete_bint(&ptrT);
-    delete_bint(&ptrT0); delete_bint(&ptrT1);
-    delete_bint(&ptrTmp0); delete_bint(&ptrTmp1);
-    delete_bint(&ptrTmpZ);
-    refineBINT(*pptrX); refineBINT(*pptrY);
-    if((*pptrX)->sign != (*pptrY)->sign)
-        (*pptrZ)->sign = true;
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "MUL_Core_ImpTxtBk_xyz");
+    CHECK_PTR_AND_DEREF(pptrY, "pptrY", "MUL_Core_ImpTxtBk_xyz");
+    exit_on_null_error(pptrZ, "pptrZ", "MUL_Core_ImpTxtBk_xyz");
+    BINT* ptrX = *pptrX; BINT* ptrY = *pptrY;
+    int n = bint_size(ptrX), m = bint_size(ptrY);
+    bool sign = ptrX->sign != ptrY->sign;
+
+    // The result is sized before the scope opens, so that only the scratch goes back with it
+    BINT tmp = BINT_INITIALIZER(tmp), ws = BINT_INITIALIZER(ws);
+    BINT* ptrZ = bint_target(pptrZ, ptrX, ptrY, &tmp, n + m);
+    ArenaMark mark = bint_arena_begin();
+    reserveBINT(&ws, 2 * n + 2);
+    mul_imptxtbk_words(ptrZ->val, ptrX->val, n, ptrY->val, m, ws.val);
+    clear_bint(&ws);
+    bint_arena_end(mark, NULL, 0);
+    bint_settle(pptrZ, ptrZ, &tmp, sign);
 }
 
 void MUL_Core_Krtsb_xyz(BINT** pptrX, BINT** pptrY, BINT** pptrZ) {
     CHECK_PTR_AND_DEREF(pptrX, "pptrX", "MUL_Core_Krtsb_xyz");
     CHECK_PTR_AND_DEREF(pptrY, "pptrY", "MUL_Core_Krtsb_xyz");
-    int n = (*pptrX)->wordlen; int m = (*pptrY)->wordlen;
-    // static int lenZ = -1; // Declare lenZ as a static variable
-    // if (lenZ == -1) {
-    //     lenZ = n + m; // Calculate lenZ only if it hasn't been initialized yet
-    //     init_bint(pptrZ, lenZ);
-    //     CHECK_PTR_AND_DEREF(pptrZ, "pptrZ", "MUL_Core_Krtsb_xyz");
-    // }
-    if (FLAG >= MINIMUM(n,m)) {
-        BINT* tmpTxtBk_X = NULL; BINT* tmpTxtBk_Y = NULL;
-        copyBINT(&tmpTxtBk_X, pptrX); copyBINT(&tmpTxtBk_Y, pptrY);
-        MUL_Core_ImpTxtBk_xyz(&tmpTxtBk_X,&tmpTxtBk_Y,pptrZ);
-        delete_bint(&tmpTxtBk_X); delete_bint(&tmpTxtBk_Y);
-        return;
+    exit_on_null_error(pptrZ, "pptrZ", "MUL_Core_Krtsb_xyz");
+    BINT* ptrX = *pptrX; BINT* ptrY = *pptrY;
+    bool sign = ptrX->sign != ptrY->sign;
+    if (bint_size(ptrX) < bint_size(ptrY)) {
+        ptrX = *pptrY; ptrY = *pptrX;
     }
-    init_bint(pptrZ, n+m);
-    CHECK_PTR_AND_DEREF(pptrZ, "pptrZ", "MUL_Core_Krtsb_xyz");
-    int l = (MAXIMUM(n,m) + 1) >> 1;
-
-    BINT* ptrX0 = NULL; BINT* ptrX1 = NULL;
-    BINT* ptrY0 = NULL; BINT* ptrY1 = NULL;
-    BINT* ptrT0 = NULL; BINT* ptrT1 = NULL;
-    BINT* ptrShiftT1 = NULL;
-    BINT* ptrS0 = NULL; BINT* ptrS1 = NULL;
-    BINT* ptrS = NULL;
-    init_bint(&ptrS, 2*l);
-
-    BINT* ptrR = NULL;
-    BINT* ptrTmpR = NULL;
-    init_bint(&ptrR, (*pptrZ)->wordlen);
-    BINT* ptrTmpST1 = NULL;
-    BINT* ptrTmpST0 = NULL;
-
-    matchSize(*pptrX, *pptrY);
-    copyBINT(&ptrX1, pptrX); right_shift_word(&ptrX1, l);
-    copyBINT(&ptrX0, pptrX); reduction(&ptrX0, l * WORD_BITLEN);
-    
-    copyBINT(&ptrY1, pptrY); right_shift_word(&ptrY1, l);
-    copyBINT(&ptrY0, pptrY); reduction(&ptrY0, l * WORD_BITLEN);
-    
-    MUL_Core_Krtsb_xyz(&ptrX1, &ptrY1, &ptrT1);
-    MUL_Core_Krtsb_xyz(&ptrX0, &ptrY0, &ptrT0);
-    
-    copyBINT(&ptrShiftT1, &ptrT1);
-    left_shift_word(&ptrShiftT1, 2*l);
-    OR_BINT(&ptrShiftT1, &ptrT0, &ptrR);
-    
-    SUB(&ptrX0, &ptrX1, &ptrS1);
-    SUB(&ptrY1, &ptrY0, &ptrS0);
-    
-    bool sgn_S = ((ptrS0)->sign) ^ ((ptrS1)->sign);
-    ptrS0->sign = false; ptrS1->sign = false;
-    MUL_Core_Krtsb_xyz(&ptrS1, &ptrS0, &ptrS);
-    ptrS->sign = sgn_S;
-    
-    ADD(&ptrS,&ptrT1,&ptrTmpST1);
-    copyBINT(&ptrS,&ptrTmpST1);
-    
-    copyBINT(&ptrTmpST0, &ptrS);
-    ADD(&ptrTmpST0,&ptrT0,&ptrS);
-    
-    left_shift_word(&ptrS, l);
-    
-    ADD(&ptrR, &ptrS, pptrZ);
-    
-    delete_bint(&ptrX0); delete_bint(&ptrX1);
-    delete_bint(&ptrY0); delete_bint(&ptrY1);
-    delete_bint(&ptrT0); delete_bint(&ptrT1);
-    delete_bint(&ptrShiftT1);
-    delete_bint(&ptrS0); delete_bint(&ptrS1);
-    delete_bint(&ptrS);
-    delete_bint(&ptrR); delete_bint(&ptrTmpR);
-    delete_bint(&ptrTmpST0); delete_bint(&ptrTmpST1);
-    refineBINT(*pptrX); refineBINT(*pptrY);
-    // refineBINT(*pptrZ);
+    int n = bint_size(ptrX), m = bint_size(ptrY);
+
+    BINT tmp = BINT_INITIALIZER(tmp), ws = BINT_INITIALIZER(ws);
+    BINT* ptrZ = bint_target(pptrZ, ptrX, ptrY, &tmp, n + m);
+    ArenaMark mark = bint_arena_begin();
+    reserveBINT(&ws, mpn_mul_itch(n, m));
+    mpn_mul(ptrZ->val, ptrX->val, n, ptrY->val, m, ws.val);
+    clear_bint(&ws);
+    bint_arena_end(mark, NULL, 0);
+    bint_settle(pptrZ, ptrZ, &tmp, sign);
 }
 
 void squ_core(WORD valX, BINT** pptrZ) {
-    const int half_w = WORD_BITLEN / 2; // if w=32, half_w = 16 = 2^4
-	const WORD MASK = (WORD_ONE << half_w) - 1;
-
-	BINT* C = NULL;
-    init_bint(&C,2);
-    BINT* T = NULL;
-    init_bint(&T,2);
-    BINT* Temp = NULL;
-    init_bint(&Temp,2);
-    // Split the WORDs into halves
-	WORD X0 = valX & MASK;
-	WORD X1 = valX >> half_w;
-	
-    // Cross multiplication
-	WORD C1 = X1 * X1;
-	WORD C0 = X0 * X0;
-    C->val[0] = C0;
-    C->val[1] = C1;
-	T->val[0] = X0 * X1;
-    left_shift_bit(&T,half_w + 1); 
-    ADD(&C,&T,&Temp);
-    
-    copyBINT(pptrZ,&Temp);
-    delete_bint(&C);
-    delete_bint(&T);
-    delete_bint(&Temp);
+    exit_on_null_error(pptrZ, "pptrZ", "squ_core");
+    BINT* ptrZ = bint_result(pptrZ, 2);
+    mpn_sqr_basecase(ptrZ->val, &valX, 1);
+    ptrZ->sign = false;
+    refineBINT(ptrZ);
 }
 
 void SQU_TxtBk_xz(BINT** pptrX, BINT** pptrZ) {
-    BINT* C1 = NULL;
-    init_bint(&C1, 1);
-    BINT* C2 = NULL;
-    init_bint(&C2, 1);
-    BINT* T1 = NULL;
-    BINT* T2=NULL;
-    init_bint(&T2, 2);
-    BINT* Temp = NULL;
-    BINT* Temp2 = NULL;
-    for(int j=0; j < (*pptrX)->wordlen; j++) {
-        squ_core((*pptrX)->val[j],&T1);
-        left_shift_word(&T1,(2*j));
-        add_core_xyz(&T1,&C1,&Temp);
-        copyBINT(&C1,&Temp);
-        for (int i = j+1; i < (*pptrX)->wordlen; i++) {
-            mul_xyz((*pptrX)->val[j],(*pptrX)->val[i],&T2);
-            left_shift_word(&T2,(i+j));
-            add_core_xyz(&C2,&T2,&Temp2);
-            copyBINT(&C2,&Temp2);
-            init_bint(&T2,2);
-        }
-    }
-    left_shift_bit(&C2,1);
-    add_core_xyz(&C1,&C2,pptrZ);
-    delete_bint(&C1);
-    delete_bint(&C2);
-    delete_bint(&T1);
-    delete_bint(&T2);
-    delete_bint(&Temp);
-    delete_bint(&Temp2);
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "SQU_TxtBk_xz");
+    exit_on_null_error(pptrZ, "pptrZ", "SQU_TxtBk_xz");
+    BINT* ptrX = *pptrX;
+    int n = bint_size(ptrX);
+
+    BINT tmp = BINT_INITIALIZER(tmp);
+    BINT* ptrZ = bint_target(pptrZ, ptrX, NULL, &tmp, 2 * n);
+    mpn_sqr_basecase(ptrZ->val, ptrX->val, n);
+    bint_settle(pptrZ, ptrZ, &tmp, false);
 }
 
 void SQU_Krtsb_xz(BINT** pptrX, BINT** pptrZ) {
     CHECK_PTR_AND_DEREF(pptrX, "pptrX", "SQU_Krtsb_xz");
-    int n = (*pptrX)->wordlen;
-    static int lenZ = -1; // Declare lenZ as a static variable
-    if (lenZ == -1) {
-        lenZ = 2 * n;
-        init_bint(pptrZ, lenZ);
-        CHECK_PTR_AND_DEREF(pptrZ, "pptrZ", "SQU_Krtsb_xz");
-    }
-    if (FLAG >= n) {
-        BINT* tmpTxtBk_X = NULL; copyBINT(&tmpTxtBk_X, pptrX);
-        SQU_TxtBk_xz(&tmpTxtBk_X, pptrZ);
-        delete_bint(&tmpTxtBk_X);
-        return;
-    }
-    init_bint(pptrZ, 2*n);
-    CHECK_PTR_AND_DEREF(pptrZ, "pptrZ", "SQU_Krtsb_xz");
-    int l = (n + 1) >> 1;
-
-    BINT* ptrX0 = NULL; BINT* ptrX1 = NULL;
-    BINT* ptrT0 = NULL; BINT* ptrT1 = NULL;
-    BINT* ptrShiftT1 = NULL;
-    BINT* ptrR = NULL;
-    BINT* ptrS = NULL;
-    init_bint(&ptrS, 2*l);
-
-    copyBINT(&ptrX1, pptrX); right_shift_word(&ptrX1, l);
-    copyBINT(&ptrX0, pptrX); reduction(&ptrX0, l * WORD_BITLEN);
-
-    SQU_Krtsb_xz(&ptrX1, &ptrT1);
-    SQU_Krtsb_xz(&ptrX0, &ptrT0);
+    exit_on_null_error(pptrZ, "pptrZ", "SQU_Krtsb_xz");
+    BINT* ptrX = *pptrX;
+    int n = bint_size(ptrX);
+
+    BINT tmp = BINT_INITIALIZER(tmp), ws = BINT_INITIALIZER(ws);
+    BINT* ptrZ = bint_target(pptrZ, ptrX, NULL, &tmp, 2 * n);
+    ArenaMark mark = bint_arena_begin();
+    reserveBINT(&ws, mpn_mul_n_itch(n));
+    mpn_sqr_n(ptrZ->val, ptrX->val, n, ws.val);
+    clear_bint(&ws);
+    bint_arena_end(mark, NULL, 0);
+    bint_settle(pptrZ, ptrZ, &tmp, false);
+}
 
-    copyBINT(&ptrShiftT1, &ptrT1);
-    left_shift_word(&ptrShiftT1, 2*l);
-    ADD(&ptrShiftT1, &ptrT0, &ptrR);
+void DIV_Binary_Long(BINT** pptrDividend, BINT** pptrDivisor, BINT** pptrQ, BINT** pptrR) {
+    CHECK_PTR_AND_DEREF(pptrDividend, "pptrDividend", "DIV_Binary_Long");
+    CHECK_PTR_AND_DEREF(pptrDivisor, "pptrDivisor", "DIV_Binary_Long");
+    exit_on_null_error(pptrQ, "pptrQ", "DIV_Binary_Long");
+    exit_on_null_error(pptrR, "pptrR", "DIV_Binary_Long");
+    BINT* ptrX = *pptrDividend; BINT* ptrY = *pptrDivisor;
+    if (mpn_normalize(ptrY->val, ptrY->wordlen) == 0) {
+        fprintf(stderr, "Division by zero error.\n");
+        exit(1);
+    }
+    int n = bint_size(ptrX), m = bint_size(ptrY);
+    bool sign = ptrX->sign ^ ptrY->sign;
+
+    BINT tmpQ = BINT_INITIALIZER(tmpQ), tmpR = BINT_INITIALIZER(tmpR);
+    BINT* ptrQ = bint_target(pptrQ, ptrX, ptrY, &tmpQ, n);
+    BINT* ptrR = bint_target(pptrR, ptrX, ptrY, &tmpR, m + 1);
+    mpn_div_binary(ptrQ->val, ptrR->val, ptrX->val, n, ptrY->val, m);
+    bint_settle(pptrQ, ptrQ, &tmpQ, sign);
+    bint_settle(pptrR, ptrR, &tmpR, false);
+}
 
-    MUL_Core_Krtsb_xyz(&ptrX1, &ptrX0, &ptrS);
-    left_shift_word(&ptrS, l);
-    left_shift_bit(&ptrS, 1);
+WORD quotient(WORD dividend1, WORD dividend0, WORD divisor) {
+    // (dividend1 * W + dividend0) / divisor in the double-word type, saturated at W - 1
+    DWORD q = (((DWORD)dividend1 << WORD_BITLEN) | dividend0) / divisor;
+    return q > (DWORD)(WORD)~(WORD)0 ? (WORD)~(WORD)0 : (WORD)q;
+}
 
-    ADD(&ptrR, &ptrS, pptrZ);
 
-    delete_bint(&ptrX0); delete_bint(&ptrX1);
-    delete_bint(&ptrT0); delete_bint(&ptrT1);
-    delete_bint(&ptrShiftT1);
-    delete_bint(&ptrS);
-    delete_bint(&ptrR);
+void DIV_Long(BINT** pptrDividend, BINT** pptrDivisor, BINT** pptrQ, BINT** pptrR) {
+    CHECK_PTR_AND_DEREF(pptrDividend, "pptrDividend", "DIV_Long");
+    CHECK_PTR_AND_DEREF(pptrDivisor, "pptrDivisor", "DIV_Long");
+    exit_on_null_error(pptrQ, "pptrQ", "DIV_Long");
+    exit_on_null_error(pptrR, "pptrR", "DIV_Long");
+    BINT* ptrX = *pptrDividend; BINT* ptrY = *pptrDivisor;
+    int n = bint_size(ptrX);
+    int m = mpn_normalize(ptrY->val, ptrY->wordlen);
+    if (m == 0) {
+        fprintf(stderr, "Division by zero error.\n");
+        exit(1);
+    }
+    bool sign = ptrX->sign ^ ptrY->sign;
+
+    BINT tmpQ = BINT_INITIALIZER(tmpQ), tmpR = BINT_INITIALIZER(tmpR), ws = BINT_INITIALIZER(ws);
+    BINT* ptrQ = bint_target(pptrQ, ptrX, ptrY, &tmpQ, n);
+    BINT* ptrR = bint_target(pptrR, ptrX, ptrY, &tmpR, m + 1);
+    ArenaMark mark = bint_arena_begin();
+    reserveBINT(&ws, mpn_div_qr_itch(n, m));
+    mpn_div_qr(ptrQ->val, ptrR->val, ptrX->val, n, ptrY->val, m, ws.val);
+    clear_bint(&ws);
+    bint_arena_end(mark, NULL, 0);
+    bint_settle(pptrQ, ptrQ, &tmpQ, sign);
+    bint_settle(pptrR, ptrR, &tmpR, false);
 }
 
-void DIV_Binary_Long(BINT** pptrDividend, BINT** pptrDivisor, BINT** pptrQ, BINT** pptrR) {
-    if((*pptrDivisor)->wordlen == 0 || ((*pptrDivisor)->wordlen == 1 && (*pptrDivisor)->val[0] == 0) ) {
+void init_div_ctx(DivCtx** pptrCtx, BINT* ptrDivisor) {
+    exit_on_null_error(pptrCtx, "pptrCtx", "init_div_ctx");
+    CHECK_PTR_AND_DEREF(&ptrDivisor, "ptrDivisor", "init_div_ctx");
+    delete_div_ctx(pptrCtx);
+
+    DivCtx* ctx = calloc(1, sizeof(DivCtx));
+    exit_on_null_error(ctx, "ctx", "init_div_ctx");
+    copyBINT(&ctx->ptrDiv, &ptrDivisor);
+    refineBINT(ctx->ptrDiv);
+    if (isZero(ctx->ptrDiv)) {
         fprintf(stderr, "Division by zero error.\n");
         exit(1);
     }
-    if (!(*pptrDividend)->sign && compare_bint(*pptrDivisor, *pptrDividend)) {
-        init_bint(pptrQ, 1);
-        copyBINT(pptrR, pptrDividend);
+    int k = ctx->wordlen = ctx->ptrDiv->wordlen;
+
+    ctx->d = calloc(k, sizeof(WORD));
+    ctx->inv = calloc(k, sizeof(WORD));
+    exit_on_null_error(ctx->d, "d", "init_div_ctx");
+    exit_on_null_error(ctx->inv, "inv", "init_div_ctx");
+    for (WORD top = ctx->ptrDiv->val[k - 1]; !(top >> (WORD_BITLEN - 1)); top = (WORD)(top << 1))
+        ctx->shift++;
+    if (ctx->shift > 0)
+        mpn_lshift(ctx->d, ctx->ptrDiv->val, k, ctx->shift);
+    else
+        mpn_copy(ctx->d, ctx->ptrDiv->val, k);
+    BINT ws = BINT_INITIALIZER(ws);
+    ArenaMark mark = bint_arena_begin();
+    reserveBINT(&ws, mpn_invert_itch(k));
+    mpn_invert(ctx->inv, ctx->d, k, ws.val);
+    clear_bint(&ws);
+    bint_arena_end(mark, NULL, 0);
+
+    *pptrCtx = ctx;
+}
+
+void delete_div_ctx(DivCtx** pptrCtx) {
+    if (pptrCtx == NULL || *pptrCtx == NULL)
         return;
+    delete_bint(&(*pptrCtx)->ptrDiv);
+    free((*pptrCtx)->d);
+    free((*pptrCtx)->inv);
+    free(*pptrCtx);
+    *pptrCtx = NULL;
+}
+
+void DIV_Invariant(BINT** pptrDividend, BINT** pptrQ, BINT** pptrR, DivCtx* ptrCtx) {
+    CHECK_PTR_AND_DEREF(pptrDividend, "pptrDividend", "DIV_Invariant");
+    CHECK_PTR_AND_DEREF(&ptrCtx, "ptrCtx", "DIV_Invariant");
+    exit_on_null_error(pptrQ, "pptrQ", "DIV_Invariant");
+    exit_on_null_error(pptrR, "pptrR", "DIV_Invariant");
+    BINT* ptrX = *pptrDividend;
+    int n = bint_size(ptrX), m = ptrCtx->wordlen;
+    bool sign = ptrX->sign ^ ptrCtx->ptrDiv->sign;
+
+    BINT tmpQ = BINT_INITIALIZER(tmpQ), tmpR = BINT_INITIALIZER(tmpR), ws = BINT_INITIALIZER(ws);
+    BINT* ptrQ = bint_target(pptrQ, ptrX, NULL, &tmpQ, n);
+    BINT* ptrR = bint_target(pptrR, ptrX, NULL, &tmpR, m + 1);
+    ArenaMark mark = bint_arena_begin();
+    reserveBINT(&ws, mpn_div_qr_preinv_itch(n, m));
+    mpn_div_qr_preinv(ptrQ->val, ptrR->val, ptrX->val, n, ptrCtx->d, m, ptrCtx->inv, ptrCtx->shift, ws.val);
+    clear_bint(&ws);
+    bint_arena_end(mark, NULL, 0);
+    bint_settle(pptrQ, ptrQ, &tmpQ, sign);
+    bint_settle(pptrR, ptrR, &tmpR, false);
+}
+
+void EXP_MOD_L2R(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BINT* ptrMod) {
+    CHECK_PTR_AND_DEREF(&ptrMod, "ptrMod", "EXP_MOD_L2R");
+    if (ptrMod->wordlen > 0 && (ptrMod->val[0] & 1)) {
+        MontCtx* ptrCtx = NULL;
+        init_mont_ctx(&ptrCtx, ptrMod);
+        EXP_MOD_L2R_Mont(pptrX, pptrY, pptrZ, ptrCtx);
+        delete_mont_ctx(&ptrCtx);
+    } else {
+        BarrettCtx* ptrCtx = NULL;
+        init_barrett_ctx(&ptrCtx, ptrMod);
+        EXP_MOD_L2R_Barrett(pptrX, pptrY, pptrZ, ptrCtx);
+        delete_barrett_ctx(&ptrCtx);
     }
-    int n = (*pptrDividend)->wordlen;
-    init_bint(pptrQ, 1);
-    (*pptrQ)-> sign = (*pptrDividend)->sign ^ (*pptrDivisor)->sign;
-    init_bint(pptrR, 1);
-    
-    BINT* ptrTmpSub = NULL;
-    init_bint(&ptrTmpSub, 1);
-    BINT* ptrTmpAdd = NULL;
-    init_bint(&ptrTmpAdd, 1);
-
-    matchSize(*pptrDividend,*pptrDivisor);
-    for(int i = n * WORD_BITLEN - 1; i >= 0 ; i--) {
-        left_shift_bit(pptrR, 1);  // R <- 2R
-        (*pptrR)->val[0] ^= GET_BIT(*pptrDividend, i); // R <- R + x_i
-        
-        matchSize(*pptrR,*pptrDivisor);
-        if(compare_bint(*pptrR, *pptrDivisor)) {   // R >= Y
-            SUB(pptrR,pptrDivisor,&ptrTmpSub);
-            copyBINT(pptrR,&ptrTmpSub);
-
-            init_bint(&ptrTmpAdd, 1);
-            ptrTmpAdd->val[0] = WORD_ONE;
-            left_shift_bit(&ptrTmpAdd, i);
-            matchSize(*pptrQ, ptrTmpAdd);
-            for(int j = 0; j < ptrTmpAdd->wordlen; j++) {
-                (*pptrQ)->val[j] ^= ptrTmpAdd->val[j];
-            }
-        }
+}
+
+void EXP_MOD_R2L(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BINT* ptrMod) {
+    CHECK_PTR_AND_DEREF(&ptrMod, "ptrMod", "EXP_MOD_R2L");
+    if (ptrMod->wordlen > 0 && (ptrMod->val[0] & 1)) {
+        MontCtx* ptrCtx = NULL;
+        init_mont_ctx(&ptrCtx, ptrMod);
+        EXP_MOD_R2L_Mont(pptrX, pptrY, pptrZ, ptrCtx);
+        delete_mont_ctx(&ptrCtx);
+    } else {
+        BarrettCtx* ptrCtx = NULL;
+        init_barrett_ctx(&ptrCtx, ptrMod);
+        EXP_MOD_R2L_Barrett(pptrX, pptrY, pptrZ, ptrCtx);
+        delete_barrett_ctx(&ptrCtx);
     }
-    refineBINT(*pptrDividend);
-    refineBINT(*pptrDivisor);
-    refineBINT(*pptrQ);
-    refineBINT(*pptrR);
+}
 
-    delete_bint(&ptrTmpAdd);
-    delete_bint(&ptrTmpSub);
+void EXP_MOD_Montgomery(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BINT* ptrMod) {
+    CHECK_PTR_AND_DEREF(&ptrMod, "ptrMod", "EXP_MOD_Montgomery");
+    if (ptrMod->wordlen > 0 && (ptrMod->val[0] & 1)) {
+        MontCtx* ptrCtx = NULL;
+        init_mont_ctx(&ptrCtx, ptrMod);
+        EXP_MOD_Ladder_Mont(pptrX, pptrY, pptrZ, ptrCtx);
+        delete_mont_ctx(&ptrCtx);
+    } else {
+        BarrettCtx* ptrCtx = NULL;
+        init_barrett_ctx(&ptrCtx, ptrMod);
+        EXP_MOD_Ladder_Barrett(pptrX, pptrY, pptrZ, ptrCtx);
+        delete_barrett_ctx(&ptrCtx);
+    }
 }
 
-WORD quotient(WORD dividend1, WORD dividend0, WORD divisor) {
-    WORD Q = 0;
-    WORD R = dividend1;
+void EXP_MOD_KAry(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BINT* ptrMod) {
+    CHECK_PTR_AND_DEREF(&ptrMod, "ptrMod", "EXP_MOD_KAry");
+    if (ptrMod->wordlen > 0 && (ptrMod->val[0] & 1)) {
+        MontCtx* ptrCtx = NULL;
+        init_mont_ctx(&ptrCtx, ptrMod);
+        EXP_MOD_KAry_Mont(pptrX, pptrY, pptrZ, ptrCtx);
+        delete_mont_ctx(&ptrCtx);
+    } else {
+        BarrettCtx* ptrCtx = NULL;
+        init_barrett_ctx(&ptrCtx, ptrMod);
+        EXP_MOD_KAry_Barrett(pptrX, pptrY, pptrZ, ptrCtx);
+        delete_barrett_ctx(&ptrCtx);
+    }
+}
 
-    int w1 = WORD_BITLEN;
-    for(int i = WORD_BITLEN-1; i>=0; i--) {
-        if((divisor >> i) == 0)
-            w1 -= 1;
-        else
-            break;
+void EXP_MOD_Sliding(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BINT* ptrMod) {
+    CHECK_PTR_AND_DEREF(&ptrMod, "ptrMod", "EXP_MOD_Sliding");
+    if (ptrMod->wordlen > 0 && (ptrMod->val[0] & 1)) {
+        MontCtx* ptrCtx = NULL;
+        init_mont_ctx(&ptrCtx, ptrMod);
+        EXP_MOD_Sliding_Mont(pptrX, pptrY, pptrZ, ptrCtx);
+        delete_mont_ctx(&ptrCtx);
+    } else {
+        BarrettCtx* ptrCtx = NULL;
+        init_barrett_ctx(&ptrCtx, ptrMod);
+        EXP_MOD_Sliding_Barrett(pptrX, pptrY, pptrZ, ptrCtx);
+        delete_barrett_ctx(&ptrCtx);
     }
+}
 
-    for(int j = w1; j>=0; j--) {
-        if(R >= (WORD)(WORD_ONE << w1)) {
-            Q += (WORD_ONE << j);
-            R += (dividend0 >> j);
-            R += (R-divisor);
-        } else {
-            R += (dividend0 >> j);
-            R += R;
-            if(R >= divisor) {
-                Q += (WORD_ONE << j);
-                R -= divisor;
-            }
-        }
+void EXP_MOD_Multi(BINT** ptrBases, BINT** ptrExps, int count, BINT** pptrZ, BINT* ptrMod) {
+    CHECK_PTR_AND_DEREF(&ptrMod, "ptrMod", "EXP_MOD_Multi");
+    if (ptrMod->wordlen > 0 && (ptrMod->val[0] & 1)) {
+        MontCtx* ptrCtx = NULL;
+        init_mont_ctx(&ptrCtx, ptrMod);
+        EXP_MOD_Multi_Mont(ptrBases, ptrExps, count, pptrZ, ptrCtx);
+        delete_mont_ctx(&ptrCtx);
+    } else {
+        BarrettCtx* ptrCtx = NULL;
+        init_barrett_ctx(&ptrCtx, ptrMod);
+        EXP_MOD_Multi_Barrett(ptrBases, ptrExps, count, pptrZ, ptrCtx);
+        delete_barrett_ctx(&ptrCtx);
     }
-    return Q;
 }
 
-void DIV_Long(BINT** pptrDividend, BINT** pptrDivisor, BINT** pptrQ, BINT** pptrR) {
-    init_bint(pptrQ, 1);  // Assume Q is no longer than 1 word.
-    init_bint(pptrR, (*pptrDividend)->wordlen); // R has the same word length as X for safety.
+/*
+ * Montgomery arithmetic
+ */
+
+// out <- t - n if the (k+1)-word value (carry, t) is at least n, else t; the result is below n for t < 2n
+static void mont_final(WORD* out, const WORD* t, WORD carry, MontCtx* ptrCtx) {
+    int k = ptrCtx->wordlen;
+    if (carry || mpn_cmp(t, ptrCtx->ptrMod->val, k) >= 0)
+        mpn_sub_n(out, t, ptrCtx->ptrMod->val, k);
+    else
+        mpn_copy(out, t, k);
+}
+
+// out <- t * R^(-1) mod n for t < n * R in 2k words, one mpn_addmul_1 row per word of t (separated operand
+// scanning); t needs one more word on top and is consumed
+static void mont_redc(WORD* out, WORD* t, MontCtx* ptrCtx) {
+    int k = ptrCtx->wordlen;
+    const WORD* n = ptrCtx->ptrMod->val;
+    t[2 * k] = 0;
+    for (int i = 0; i < k; i++) {
+        // m is chosen so that adding m * n * W^i clears word i
+        WORD m = (WORD)(t[i] * ptrCtx->nprime);
+        WORD c = mpn_addmul_1(t + i, n, k, m);
+        t[2 * k] += mpn_add_1(t + i + k, t + i + k, k - i, c);
+    }
+    mont_final(out, t + k, t[2 * k], ptrCtx);
+}
 
-    // Fetch bit lengths
-    int n = (*pptrDividend)->wordlen;  // Pass the address of the pointer
-    int m = (*pptrDivisor)->wordlen;  // Pass the address of the pointer
+// out <- a * b * R^(-1) mod n; out may alias a or b
+static void mont_mul_words(WORD* out, const WORD* a, const WORD* b, MontCtx* ptrCtx) {
+    WORD* t = ptrCtx->scratch;
+    mpn_mul_basecase(t, a, ptrCtx->wordlen, b, ptrCtx->wordlen);
+    mont_redc(out, t, ptrCtx);
+}
 
-    // Calculate W as 2^word size
-    WORD W = WORD_ONE << (WORD_BITLEN - 1); // Use one less bit to avoid overflow
+// out <- a^2 * R^(-1) mod n, the square taking each cross product once
+static void mont_sqr_words(WORD* out, const WORD* a, MontCtx* ptrCtx) {
+    WORD* t = ptrCtx->scratch;
+    mpn_sqr_basecase(t, a, ptrCtx->wordlen);
+    mont_redc(out, t, ptrCtx);
+}
 
-    // Get the most significant word from X and Y
-    WORD x_m = GET_WORD(*pptrDividend, m);     // assuming get_mth_word fetches the m-th WORD from BINT
-    WORD x_m1 = GET_WORD(*pptrDividend, m-1);
-    WORD y_m1 = GET_WORD(*pptrDivisor, m-1);
+// r <- 2r mod n for r < n
+static void mont_double_words(WORD* r, MontCtx* ptrCtx) {
+    WORD top = mpn_lshift(r, r, ptrCtx->wordlen, 1);
+    mont_final(r, r, top, ptrCtx);
+}
 
-    // Main algorithm as per the pseudocode
-    if (n == m) {
-        (*pptrQ)->val[0] = x_m1 / y_m1;
+// out <- X * R mod n for any non-negative X
+static void mont_enter(WORD* out, BINT* ptrX, MontCtx* ptrCtx) {
+    int k = ptrCtx->wordlen;
+    WORD* a = ptrCtx->scratch + 2 * k + 2;
+    BINT *ptrT = NULL, *ptrN = NULL, *ptrQ = NULL, *ptrR = NULL;
+    int len = ptrX->wordlen;
+    while (len > 0 && ptrX->val[len - 1] == 0)
+        len--;
+    const WORD* src = ptrX->val;
+    if (len > k) {
+        // Multiplying by R^2 needs X < R
+        copyBINT(&ptrT, &ptrX);
+        copyBINT(&ptrN, &ptrCtx->ptrMod);
+        ptrT->sign = false;
+        DIV_Long(&ptrT, &ptrN, &ptrQ, &ptrR);
+        refineBINT(ptrR);
+        src = ptrR->val;
+        len = MINIMUM(ptrR->wordlen, k);
     }
-    if (n == m + 1) {
-        if (x_m == y_m1)
-            (*pptrQ)->val[0] = W - 1;
-        else
-            (*pptrQ)->val[0] = quotient(x_m,x_m1,y_m1);
+    memset(a, 0, k * sizeof(WORD));
+    memcpy(a, src, len * sizeof(WORD));
+    mont_mul_words(out, a, ptrCtx->R2, ptrCtx);
+    delete_bint(&ptrT); delete_bint(&ptrN); delete_bint(&ptrQ); delete_bint(&ptrR);
+}
+
+// Z <- t * R^(-1) mod n
+static void mont_leave(BINT** pptrZ, const WORD* t, MontCtx* ptrCtx) {
+    int k = ptrCtx->wordlen;
+    WORD* one = ptrCtx->scratch + 3 * k + 2;
+    memset(one, 0, k * sizeof(WORD));
+    one[0] = WORD_ONE;
+    init_bint(pptrZ, k);
+    mont_mul_words((*pptrZ)->val, t, one, ptrCtx);
+    refineBINT(*pptrZ);
+}
+
+// Copies the low k words of X into dst, zero-padded
+static void mont_load(WORD* dst, BINT* ptrX, int k) {
+    int len = MINIMUM(ptrX->wordlen, k);
+    memcpy(dst, ptrX->val, len * sizeof(WORD));
+    memset(dst + len, 0, (k - len) * sizeof(WORD));
+}
+
+static void mont_store(BINT** pptrZ, const WORD* src, int k) {
+    init_bint(pptrZ, k);
+    memcpy((*pptrZ)->val, src, k * sizeof(WORD));
+    refineBINT(*pptrZ);
+}
+
+void init_mont_ctx(MontCtx** pptrCtx, BINT* ptrMod) {
+    exit_on_null_error(pptrCtx, "pptrCtx", "init_mont_ctx");
+    CHECK_PTR_AND_DEREF(&ptrMod, "ptrMod", "init_mont_ctx");
+    if (ptrMod->wordlen == 0 || !(ptrMod->val[0] & 1)) {
+        fprintf(stderr, "Error: Montgomery arithmetic needs an odd modulus in 'init_mont_ctx'\n");
+        exit(1);
     }
-    // Calculate R = X - Y * Q
-    BINT* YQ = NULL;
-    init_bint(&YQ, (*pptrDivisor)->wordlen);
-    mul_core_TxtBk_xyz(pptrDivisor, pptrQ, &YQ);  // Pass the addresses of the pointers
-    // refineBINT(YQ);
+    delete_mont_ctx(pptrCtx);
+
+    MontCtx* ctx = calloc(1, sizeof(MontCtx));
+    exit_on_null_error(ctx, "ctx", "init_mont_ctx");
+    copyBINT(&ctx->ptrMod, &ptrMod);
+    refineBINT(ctx->ptrMod);
+    ctx->ptrMod->sign = false;
+    int k = ctx->wordlen = ctx->ptrMod->wordlen;
+
+    // n * inv = 1 mod 8 for odd n; each Newton step doubles the number of correct low bits
+    WORD n0 = ctx->ptrMod->val[0];
+    WORD inv = n0;
+    for (int i = 3; i < WORD_BITLEN; i *= 2)
+        inv = (WORD)(inv * (WORD)(2 - (WORD)(n0 * inv)));
+    ctx->nprime = (WORD)(0 - inv);
+
+    ctx->R1 = calloc(k, sizeof(WORD));
+    ctx->R2 = calloc(k, sizeof(WORD));
+    ctx->scratch = calloc(4 * k + 2, sizeof(WORD));
+    exit_on_null_error(ctx->R1, "R1", "init_mont_ctx");
+    exit_on_null_error(ctx->R2, "R2", "init_mont_ctx");
+    exit_on_null_error(ctx->scratch, "scratch", "init_mont_ctx");
+
+    // R mod n and R^2 mod n by doubling 1 modulo n, k * WORD_BITLEN times each
+    ctx->R2[0] = WORD_ONE;
+    mont_final(ctx->R2, ctx->R2, 0, ctx);
+    for (int i = 0; i < k * WORD_BITLEN; i++)
+        mont_double_words(ctx->R2, ctx);
+    memcpy(ctx->R1, ctx->R2, k * sizeof(WORD));
+    for (int i = 0; i < k * WORD_BITLEN; i++)
+        mont_double_words(ctx->R2, ctx);
+
+    *pptrCtx = ctx;
+}
 
-    SUB(pptrDividend, &YQ, pptrR);                 // Pass the addresses of the pointers
-    
-    BINT* ONE = NULL;
-    BINT* tmpQ = NULL;
-    BINT* tmpR = NULL;
-    BINT* tmpY = NULL;
-    init_bint(&ONE, (*pptrQ)->wordlen);
-    ONE->val[0] = WORD_ONE;
+void delete_mont_ctx(MontCtx** pptrCtx) {
+    if (pptrCtx == NULL || *pptrCtx == NULL)
+        return;
+    delete_bint(&(*pptrCtx)->ptrMod);
+    free((*pptrCtx)->R1);
+    free((*pptrCtx)->R2);
+    free((*pptrCtx)->scratch);
+    free(*pptrCtx);
+    *pptrCtx = NULL;
+}
 
-    // Correct R if it is negative
-    while ((*pptrR)->sign) {
-        copyBINT(&tmpY,pptrDivisor);
+void MONT_To(BINT** pptrX, BINT** pptrZ, MontCtx* ptrCtx) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "MONT_To");
+    int k = ptrCtx->wordlen;
+    WORD* b = ptrCtx->scratch + 3 * k + 2;
+    mont_enter(b, *pptrX, ptrCtx);
+    mont_store(pptrZ, b, k);
+}
 
-        SUB(pptrQ, &ONE, &tmpQ);            // Q = Q - 1
-        copyBINT(pptrQ, &tmpQ);
+void MONT_From(BINT** pptrX, BINT** pptrZ, MontCtx* ptrCtx) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "MONT_From");
+    int k = ptrCtx->wordlen;
+    WORD* a = ptrCtx->scratch + 2 * k + 2;
+    mont_load(a, *pptrX, k);
+    mont_leave(pptrZ, a, ptrCtx);
+}
+
+void MONT_Mul(BINT** pptrX, BINT** pptrY, BINT** pptrZ, MontCtx* ptrCtx) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "MONT_Mul");
+    CHECK_PTR_AND_DEREF(pptrY, "pptrY", "MONT_Mul");
+    int k = ptrCtx->wordlen;
+    WORD* a = ptrCtx->scratch + 2 * k + 2;
+    WORD* b = a + k;
+    mont_load(a, *pptrX, k);
+    mont_load(b, *pptrY, k);
+    mont_mul_words(a, a, b, ptrCtx);
+    mont_store(pptrZ, a, k);
+}
 
-        ADD(pptrR, &tmpY, &tmpR);              // R = R + Y
+void MONT_Sqr(BINT** pptrX, BINT** pptrZ, MontCtx* ptrCtx) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "MONT_Sqr");
+    int k = ptrCtx->wordlen;
+    WORD* a = ptrCtx->scratch + 2 * k + 2;
+    mont_load(a, *pptrX, k);
+    mont_sqr_words(a, a, ptrCtx);
+    mont_store(pptrZ, a, k);
+}
 
-        copyBINT(pptrR, &tmpR);
+/*
+ * Exponentiation on a word-level modular context
+ */
 
-        refineBINT(*pptrQ);
-        refineBINT(*pptrR);    
+// The exponentiation loops only see k-word residues in the representation of a context (Montgomery form or
+// plain residues for Barrett) and the four operations below
+typedef struct {
+    int k;
+    void* ctx;
+    const WORD* one;                                            // 1 in the context's representation
+    void (*mul)(WORD* out, const WORD* a, const WORD* b, void* ctx);
+    void (*sqr)(WORD* out, const WORD* a, void* ctx);
+    void (*enter)(WORD* out, BINT* ptrX, void* ctx);           // any non-negative X
+    void (*leave)(BINT** pptrZ, const WORD* a, void* ctx);     // refined result in [0, n)
+} mod_engine;
+
+static void exp_l2r(mod_engine* e, BINT* ptrX, BINT* ptrY, BINT** pptrZ) {
+    WORD* x = calloc(2 * e->k, sizeof(WORD));
+    exit_on_null_error(x, "x", "exp_l2r");
+    WORD* t = x + e->k;
+
+    e->enter(x, ptrX, e->ctx);
+    memcpy(t, e->one, e->k * sizeof(WORD));
+    for (int i = BIT_LENGTH(ptrY) - 1; i >= 0; i--) {
+        e->sqr(t, t, e->ctx);
+        if (GET_BIT(ptrY, i))
+            e->mul(t, t, x, e->ctx);
     }
+    e->leave(pptrZ, t, e->ctx);
+    free(x);
+}
 
-    // Clean up
-    delete_bint(&YQ);
-    delete_bint(&ONE);
-    delete_bint(&tmpQ);
-    delete_bint(&tmpR);
-    delete_bint(&tmpY);
+static void exp_r2l(mod_engine* e, BINT* ptrX, BINT* ptrY, BINT** pptrZ) {
+    WORD* t0 = calloc(2 * e->k, sizeof(WORD));
+    exit_on_null_error(t0, "t0", "exp_r2l");
+    WORD* t1 = t0 + e->k;
+
+    memcpy(t0, e->one, e->k * sizeof(WORD));
+    e->enter(t1, ptrX, e->ctx);
+    int bit_len = BIT_LENGTH(ptrY);
+    for (int i = 0; i < bit_len; i++) {
+        if (GET_BIT(ptrY, i))
+            e->mul(t0, t0, t1, e->ctx);
+        if (i + 1 < bit_len)
+            e->sqr(t1, t1, e->ctx);
+    }
+    e->leave(pptrZ, t0, e->ctx);
+    free(t0);
 }
 
-void EXP_MOD_L2R(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BINT* ptrMod) {
-    int bit_len = BIT_LENGTH(*pptrY);
-    BINT* t0 = NULL;
-    BINT* temp = NULL;
-    BINT* temp2 = NULL;
-    BINT* Q1 = NULL;
-    init_bint(&t0, 1);
-    t0->val[0] = WORD_ONE;
-
-    for (int i = bit_len-1; i >= 0; i--){
-        init_bint(&temp,1);
-        init_bint(&temp2,1);
-        init_bint(&Q1,1);
-        if (GET_BIT(*pptrY,i)){
-            SQU_TxtBk_xz(&t0,&temp);
-            DIV_Binary_Long(&temp,&ptrMod,&Q1,&temp2);
-            MUL_Core_ImpTxtBk_xyz(&temp2,pptrX,&temp);
-            DIV_Binary_Long(&temp,&ptrMod,&Q1,&t0);
-        }
-        else{
-            SQU_TxtBk_xz(&t0,&temp);
-            DIV_Binary_Long(&temp, &ptrMod, &Q1, &t0);
+static void exp_ladder(mod_engine* e, BINT* ptrX, BINT* ptrY, BINT** pptrZ) {
+    WORD* t0 = calloc(2 * e->k, sizeof(WORD));
+    exit_on_null_error(t0, "t0", "exp_ladder");
+    WORD* t1 = t0 + e->k;
+
+    // Invariant: t1 = t0 * x
+    memcpy(t0, e->one, e->k * sizeof(WORD));
+    e->enter(t1, ptrX, e->ctx);
+    for (int i = BIT_LENGTH(ptrY) - 1; i >= 0; i--) {
+        if (GET_BIT(ptrY, i)) {
+            e->mul(t0, t0, t1, e->ctx);
+            e->sqr(t1, t1, e->ctx);
+        } else {
+            e->mul(t1, t0, t1, e->ctx);
+            e->sqr(t0, t0, e->ctx);
         }
     }
-    refineBINT(t0);
-    copyBINT(pptrZ,&t0);
-
-    delete_bint(&Q1);
-    delete_bint(&t0);
-    delete_bint(&temp);
-    delete_bint(&temp2);
-    refineBINT(ptrMod);
+    e->leave(pptrZ, t0, e->ctx);
+    free(t0);
 }
 
-void EXP_MOD_R2L(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BINT* ptrMod) {
-    int bit_len = BIT_LENGTH(*pptrY);
+// Window width for an exponent of the given bit length: the point where a wider table stops paying for itself
+static int exp_window_bits(int bit_len) {
+    if (bit_len > 671) return 6;
+    if (bit_len > 239) return 5;
+    if (bit_len > 79)  return 4;
+    if (bit_len > 23)  return 3;
+    return 1;
+}
 
-    BINT* t0 = NULL;
-    BINT* t1 = NULL;
-    BINT* temp = NULL;
-    BINT* Q = NULL;
-    init_bint(&t0, 1);
-    t0->val[0] = WORD_ONE;
-    copyBINT(&t1, pptrX);
+// Bits [lo, lo + w) of Y for w <= 8, read from at most two words
+static unsigned exp_bits(BINT* ptrY, int lo, int w) {
+    int idx = lo / WORD_BITLEN, off = lo % WORD_BITLEN;
+    DWORD v = ptrY->val[idx] >> off;
+    if (off + w > WORD_BITLEN && idx + 1 < ptrY->wordlen)
+        v |= (DWORD)ptrY->val[idx + 1] << (WORD_BITLEN - off);
+    return (unsigned)(v & ((1u << w) - 1));
+}
 
-    for (int i = 0; i < bit_len; i++) {
-        init_bint(&temp, 1);
-        if (GET_BIT(*pptrY, i)) {
-            MUL_Core_ImpTxtBk_xyz(&t0, &t1, &temp);
-            DIV_Binary_Long(&temp, &ptrMod, &Q, &t0);
-            SQU_TxtBk_xz(&t1, &temp);
-            DIV_Binary_Long(&temp, &ptrMod, &Q, &t1);
-        } else {
-            SQU_TxtBk_xz(&t1, &temp);
-            DIV_Binary_Long(&temp, &ptrMod, &Q, &t1);
+// Fixed windows: table of x^0 .. x^(2^w - 1), then w squarings and one multiplication per window
+static void exp_kary(mod_engine* e, BINT* ptrX, BINT* ptrY, BINT** pptrZ) {
+    int k = e->k;
+    int bit_len = BIT_LENGTH(ptrY);
+    int w = exp_window_bits(bit_len);
+    int size = 1 << w;
+    WORD* tab = calloc((size_t)(size + 1) * k, sizeof(WORD));
+    exit_on_null_error(tab, "tab", "exp_kary");
+    WORD* t = tab + (size_t)size * k;
+
+    memcpy(tab, e->one, k * sizeof(WORD));
+    e->enter(tab + k, ptrX, e->ctx);
+    for (int i = 2; i < size; i++)
+        e->mul(tab + (size_t)i * k, tab + (size_t)(i - 1) * k, tab + k, e->ctx);
+
+    memcpy(t, e->one, k * sizeof(WORD));
+    bool first = true;
+    for (int i = (bit_len - 1) / w; bit_len > 0 && i >= 0; i--) {
+        unsigned d = exp_bits(ptrY, i * w, w);
+        if (first) {
+            // The top window starts the accumulator directly instead of squaring one
+            memcpy(t, tab + (size_t)d * k, k * sizeof(WORD));
+            first = false;
+            continue;
         }
+        for (int j = 0; j < w; j++)
+            e->sqr(t, t, e->ctx);
+        if (d)
+            e->mul(t, t, tab + (size_t)d * k, e->ctx);
     }
+    e->leave(pptrZ, t, e->ctx);
+    free(tab);
+}
 
-    DIV_Binary_Long(&t0, &ptrMod, &Q, &temp);
-    refineBINT(temp);
+// Sliding windows (HAC 14.85): table of the odd powers x, x^3, .., x^(2^w - 1); runs of zero bits cost only
+// squarings and every window starts and ends on a set bit
+static void exp_sliding(mod_engine* e, BINT* ptrX, BINT* ptrY, BINT** pptrZ) {
+    int k = e->k;
+    int bit_len = BIT_LENGTH(ptrY);
+    int w = exp_window_bits(bit_len);
+    int size = 1 << (w - 1);
+    WORD* tab = calloc((size_t)(size + 2) * k, sizeof(WORD));
+    exit_on_null_error(tab, "tab", "exp_sliding");
+    WORD* x2 = tab + (size_t)size * k;
+    WORD* t = x2 + k;
+
+    e->enter(tab, ptrX, e->ctx);
+    if (size > 1) {
+        e->sqr(x2, tab, e->ctx);
+        for (int i = 1; i < size; i++)
+            e->mul(tab + (size_t)i * k, tab + (size_t)(i - 1) * k, x2, e->ctx);
+    }
 
-    copyBINT(pptrZ, &temp);
-    delete_bint(&Q);
-    delete_bint(&t0);
-    delete_bint(&t1);
-    delete_bint(&temp);
-    refineBINT(ptrMod);
+    memcpy(t, e->one, k * sizeof(WORD));
+    bool first = true;
+    int i = bit_len - 1;
+    while (i >= 0) {
+        if (!GET_BIT(ptrY, i)) {
+            if (!first)
+                e->sqr(t, t, e->ctx);
+            i--;
+            continue;
+        }
+        int lo = MAXIMUM(i - w + 1, 0);
+        while (!GET_BIT(ptrY, lo))
+            lo++;
+        int len = i - lo + 1;
+        unsigned d = exp_bits(ptrY, lo, len);
+        if (first) {
+            memcpy(t, tab + (size_t)(d >> 1) * k, k * sizeof(WORD));
+            first = false;
+        } else {
+            for (int j = 0; j < len; j++)
+                e->sqr(t, t, e->ctx);
+            e->mul(t, t, tab + (size_t)(d >> 1) * k, e->ctx);
+        }
+        i = lo - 1;
+    }
+    e->leave(pptrZ, t, e->ctx);
+    free(tab);
 }
 
-void EXP_MOD_Montgomery(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BINT* ptrMod) {
-    int bit_len = BIT_LENGTH(*pptrY);
-    BINT* t0 = NULL; BINT* t1 = NULL;
-    BINT* temp = NULL; BINT* temp2 = NULL;
-    BINT* Q1 = NULL; BINT* Q2 = NULL;
-   
-    init_bint(&t0,1);
-    t0->val[0] = WORD_ONE;
-    copyBINT(&t1,pptrX);
-    
-    for (int i= bit_len-1 ; i >= 0 ;i--){
-        init_bint(&temp,1);
-        init_bint(&temp2,1);
-        init_bint(&Q1,1);
-        init_bint(&Q2,1);
-
-        if (GET_BIT(*pptrY,i) == 0){
-            MUL_Core_ImpTxtBk_xyz(&t0,&t1,&temp);
-            DIV_Binary_Long(&temp,&ptrMod,&Q1,&t1);
-            SQU_TxtBk_xz(&t0,&temp2);
-            DIV_Binary_Long(&temp2,&ptrMod,&Q2,&t0);
+// Interleaved sliding windows (Straus/Moller): every base keeps its own table of odd powers and its own window
+// schedule, but all of them share a single chain of squarings of length max BIT_LENGTH(Y_j)
+static void exp_multi(mod_engine* e, BINT** ptrX, BINT** ptrY, int count, BINT** pptrZ) {
+    int k = e->k;
+    int max_bits = 0;
+    for (int j = 0; j < count; j++)
+        max_bits = MAXIMUM(max_bits, BIT_LENGTH(ptrY[j]));
+
+    int* offset = calloc(count + 1, sizeof(int));
+    exit_on_null_error(offset, "offset", "exp_multi");
+    for (int j = 0; j < count; j++)
+        offset[j + 1] = offset[j] + (1 << (exp_window_bits(BIT_LENGTH(ptrY[j])) - 1));
+    WORD* tab = calloc((size_t)(offset[count] + 2) * k, sizeof(WORD));
+    unsigned char* digit = calloc((size_t)MAXIMUM(count * max_bits, 1), 1);     // odd window value ending at a bit
+    exit_on_null_error(tab, "tab", "exp_multi");
+    exit_on_null_error(digit, "digit", "exp_multi");
+    WORD* x2 = tab + (size_t)offset[count] * k;
+    WORD* t = x2 + k;
+
+    for (int j = 0; j < count; j++) {
+        int bit_len = BIT_LENGTH(ptrY[j]);
+        int w = exp_window_bits(bit_len);
+        WORD* base = tab + (size_t)offset[j] * k;
+        e->enter(base, ptrX[j], e->ctx);
+        if (offset[j + 1] - offset[j] > 1) {
+            e->sqr(x2, base, e->ctx);
+            for (int i = 1; i < offset[j + 1] - offset[j]; i++)
+                e->mul(base + (size_t)i * k, base + (size_t)(i - 1) * k, x2, e->ctx);
         }
-        else{
-            MUL_Core_ImpTxtBk_xyz(&t0,&t1,&temp);
-            DIV_Binary_Long(&temp,&ptrMod,&Q1,&t0);
-            SQU_TxtBk_xz(&t1,&temp2);
-            DIV_Binary_Long(&temp2,&ptrMod,&Q2,&t1);
+        unsigned char* dj = digit + (size_t)j * max_bits;
+        for (int i = bit_len - 1; i >= 0; ) {
+            if (!GET_BIT(ptrY[j], i)) {
+                i--;
+                continue;
+            }
+            int lo = MAXIMUM(i - w + 1, 0);
+            while (!GET_BIT(ptrY[j], lo))
+                lo++;
+            dj[lo] = (unsigned char)exp_bits(ptrY[j], lo, i - lo + 1);
+            i = lo - 1;
         }
+    }
 
+    memcpy(t, e->one, k * sizeof(WORD));
+    bool first = true;
+    for (int i = max_bits - 1; i >= 0; i--) {
+        if (!first)
+            e->sqr(t, t, e->ctx);
+        for (int j = 0; j < count; j++) {
+            unsigned d = digit[(size_t)j * max_bits + i];
+            if (d == 0)
+                continue;
+            const WORD* entry = tab + (size_t)(offset[j] + (d >> 1)) * k;
+            if (first)
+                memcpy(t, entry, k * sizeof(WORD));
+            else
+                e->mul(t, t, entry, e->ctx);
+            first = false;
+        }
     }
-    copyBINT(pptrZ,&t0);
-    refineBINT(ptrMod);
-    refineBINT(*pptrZ);
-    delete_bint(&t0); delete_bint(&t1);
-    delete_bint(&temp); delete_bint(&temp2);
-    delete_bint(&Q1); delete_bint(&Q2);
+    e->leave(pptrZ, t, e->ctx);
+    free(offset); free(tab); free(digit);
+}
+
+static void mont_engine_mul(WORD* out, const WORD* a, const WORD* b, void* ctx) { mont_mul_words(out, a, b, ctx); }
+static void mont_engine_sqr(WORD* out, const WORD* a, void* ctx) { mont_sqr_words(out, a, ctx); }
+static void mont_engine_enter(WORD* out, BINT* ptrX, void* ctx) { mont_enter(out, ptrX, ctx); }
+static void mont_engine_leave(BINT** pptrZ, const WORD* a, void* ctx) { mont_leave(pptrZ, a, ctx); }
+
+static mod_engine mont_engine(MontCtx* ptrCtx) {
+    mod_engine e = { ptrCtx->wordlen, ptrCtx, ptrCtx->R1,
+                     mont_engine_mul, mont_engine_sqr, mont_engine_enter, mont_engine_leave };
+    return e;
+}
+
+void EXP_MOD_L2R_Mont(BINT** pptrX, BINT** pptrY, BINT** pptrZ, MontCtx* ptrCtx) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "EXP_MOD_L2R_Mont");
+    CHECK_PTR_AND_DEREF(pptrY, "pptrY", "EXP_MOD_L2R_Mont");
+    mod_engine e = mont_engine(ptrCtx);
+    exp_l2r(&e, *pptrX, *pptrY, pptrZ);
+}
+
+void EXP_MOD_R2L_Mont(BINT** pptrX, BINT** pptrY, BINT** pptrZ, MontCtx* ptrCtx) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "EXP_MOD_R2L_Mont");
+    CHECK_PTR_AND_DEREF(pptrY, "pptrY", "EXP_MOD_R2L_Mont");
+    mod_engine e = mont_engine(ptrCtx);
+    exp_r2l(&e, *pptrX, *pptrY, pptrZ);
+}
+
+void EXP_MOD_Ladder_Mont(BINT** pptrX, BINT** pptrY, BINT** pptrZ, MontCtx* ptrCtx) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "EXP_MOD_Ladder_Mont");
+    CHECK_PTR_AND_DEREF(pptrY, "pptrY", "EXP_MOD_Ladder_Mont");
+    mod_engine e = mont_engine(ptrCtx);
+    exp_ladder(&e, *pptrX, *pptrY, pptrZ);
+}
+
+void EXP_MOD_KAry_Mont(BINT** pptrX, BINT** pptrY, BINT** pptrZ, MontCtx* ptrCtx) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "EXP_MOD_KAry_Mont");
+    CHECK_PTR_AND_DEREF(pptrY, "pptrY", "EXP_MOD_KAry_Mont");
+    mod_engine e = mont_engine(ptrCtx);
+    exp_kary(&e, *pptrX, *pptrY, pptrZ);
+}
+
+void EXP_MOD_Sliding_Mont(BINT** pptrX, BINT** pptrY, BINT** pptrZ, MontCtx* ptrCtx) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "EXP_MOD_Sliding_Mont");
+    CHECK_PTR_AND_DEREF(pptrY, "pptrY", "EXP_MOD_Sliding_Mont");
+    mod_engine e = mont_engine(ptrCtx);
+    exp_sliding(&e, *pptrX, *pptrY, pptrZ);
+}
+
+void EXP_MOD_Multi_Mont(BINT** ptrBases, BINT** ptrExps, int count, BINT** pptrZ, MontCtx* ptrCtx) {
+    exit_on_null_error(ptrBases, "ptrBases", "EXP_MOD_Multi_Mont");
+    exit_on_null_error(ptrExps, "ptrExps", "EXP_MOD_Multi_Mont");
+    for (int j = 0; j < count; j++) {
+        CHECK_PTR_AND_DEREF(&ptrBases[j], "ptrBases[j]", "EXP_MOD_Multi_Mont");
+        CHECK_PTR_AND_DEREF(&ptrExps[j], "ptrExps[j]", "EXP_MOD_Multi_Mont");
+    }
+    mod_engine e = mont_engine(ptrCtx);
+    exp_multi(&e, ptrBases, ptrExps, count, pptrZ);
 }
 
 void Barrett_Reduction_TEST(BINT** pptrX, BINT** pptrN, BINT** pptrR) {
@@ -751,7 +997,7 @@ void Barrett_Reduction_TEST(BINT** pptrX, BINT** pptrN, BINT** pptrR) {
     init_bint(&W,(*pptrX)->wordlen+1);
     W->val[(*pptrX)->wordlen] = WORD_ONE;
 
-    DIV_Binary_Long(&W,&Y,&T,&temp);
+    DIV_Long(&W,&Y,&T,&temp);
     right_shift_word(&Q, n-1);
     MUL_Core_ImpTxtBk_xyz(&Q,&T,&temp);
     copyBINT(&Q,&temp);
@@ -785,6 +1031,7 @@ void Barrett_Reduction_TEST(BINT** pptrX, BINT** pptrN, BINT** pptrR) {
 }
 
 void Barrett_Reduction(BINT** pptrX, BINT** pptrN, BINT** pptrR, BINT** pptrPreT) {
+    ArenaMark mark = bint_arena_begin();
     BINT* Q = NULL;
     BINT* R = NULL;
     copyBINT(&Q, pptrX);
@@ -822,67 +1069,857 @@ void Barrett_Reduction(BINT** pptrX, BINT** pptrN, BINT** pptrR, BINT** pptrPreT
     delete_bint(&Q);
     delete_bint(&R);
     delete_bint(&temp);
+    bint_arena_end(mark, (BINT**[]){ pptrX, pptrN, pptrR, pptrPreT }, 4);
+}
+
+/*
+ * Barrett context
+ */
+
+// Scratch layout: product (2k words), q1 * mu (2k + 4 words), q3 * n (k + 1 words), two operands (k words each)
+#define BARRETT_PROD(ctx)  ((ctx)->scratch)
+#define BARRETT_ACC(ctx)   ((ctx)->scratch + 2 * (ctx)->wordlen)
+#define BARRETT_R2(ctx)    ((ctx)->scratch + 4 * (ctx)->wordlen + 4)
+#define BARRETT_OPS(ctx)   ((ctx)->scratch + 5 * (ctx)->wordlen + 5)
+
+// r <- x mod n for x below W^(2k) in 2k words; r gets k words and may alias x
+static void barrett_reduce_words(WORD* r, const WORD* x, BarrettCtx* ptrCtx) {
+    int k = ptrCtx->wordlen, ml = k + 2;
+    const WORD* n = ptrCtx->ptrMod->val;
+    const WORD* mu = ptrCtx->mu;
+    const WORD* q1 = x + k - 1;                     // floor(x / W^(k-1)), k + 1 words
+    WORD* acc = BARRETT_ACC(ptrCtx);
+    WORD* r2 = BARRETT_R2(ptrCtx);
+
+    // q3 = floor(q1 * mu / W^(k+1)). Columns below k - 1 are skipped: their carries can lower q3 by at most
+    // one, which the final correction absorbs.
+    mpn_zero(acc, 2 * k + 4);
+    for (int i = 0; i <= k; i++) {
+        int j = MAXIMUM(k - 1 - i, 0);
+        acc[i + ml] = mpn_addmul_1(acc + i + j, mu + j, ml - j, q1[i]);
+    }
+    const WORD* q3 = acc + k + 1;                   // k + 1 words
+
+    // r2 = q3 * n mod W^(k+1): only columns up to k
+    r2[k] = mpn_mul_1(r2, n, k, q3[0]);
+    for (int i = 1; i <= k; i++)
+        mpn_addmul_1(r2 + i, n, MINIMUM(k, k + 1 - i), q3[i]);
+
+    // r = x - r2 mod W^(k+1), then at most a few subtractions of n
+    WORD top = x[k];
+    WORD borrow = mpn_sub_n(r2, x, r2, k);
+    top = (WORD)(top - r2[k] - borrow);
+    while (top != 0 || mpn_cmp(r2, n, k) >= 0) {
+        borrow = mpn_sub_n(r2, r2, n, k);
+        top = (WORD)(top - borrow);
+    }
+    memcpy(r, r2, k * sizeof(WORD));
+}
+
+// mu <- floor(W^(2k) / n) in k + 2 words, by one mpn_div_qr, which recurses with Burnikel-Ziegler for large
+// moduli. mu can reach W^(k+1) when n = W^(k-1).
+static void barrett_mu_words(WORD* mu, const WORD* n, int k) {
+    int xn = 2 * k + 1;
+    BINT ws = BINT_INITIALIZER(ws);
+    ArenaMark mark = bint_arena_begin();
+    reserveBINT(&ws, 2 * xn + k + 1 + mpn_div_qr_itch(xn, k));
+    WORD* x = ws.val;
+    WORD* q = x + xn;
+    WORD* r = q + xn;
+    mpn_zero(x, xn);
+    x[2 * k] = WORD_ONE;
+    mpn_div_qr(q, r, x, xn, n, k, r + k + 1);
+    memcpy(mu, q, (k + 2) * sizeof(WORD));
+    clear_bint(&ws);
+    bint_arena_end(mark, NULL, 0);
+}
+
+// out <- a * b mod n for a, b below W^k
+static void barrett_mul_words(WORD* out, const WORD* a, const WORD* b, BarrettCtx* ptrCtx) {
+    WORD* t = BARRETT_PROD(ptrCtx);
+    mpn_mul_basecase(t, a, ptrCtx->wordlen, b, ptrCtx->wordlen);
+    barrett_reduce_words(out, t, ptrCtx);
+}
+
+static void barrett_sqr_words(WORD* out, const WORD* a, BarrettCtx* ptrCtx) {
+    WORD* t = BARRETT_PROD(ptrCtx);
+    mpn_sqr_basecase(t, a, ptrCtx->wordlen);
+    barrett_reduce_words(out, t, ptrCtx);
+}
+
+// out <- X mod n for any non-negative X
+static void barrett_enter(WORD* out, BINT* ptrX, BarrettCtx* ptrCtx) {
+    int k = ptrCtx->wordlen;
+    int len = ptrX->wordlen;
+    while (len > 0 && ptrX->val[len - 1] == 0)
+        len--;
+    if (len > 2 * k) {
+        BINT *ptrT = NULL, *ptrN = NULL, *ptrQ = NULL, *ptrR = NULL;
+        copyBINT(&ptrT, &ptrX);
+        copyBINT(&ptrN, &ptrCtx->ptrMod);
+        ptrT->sign = false;
+        DIV_Long(&ptrT, &ptrN, &ptrQ, &ptrR);
+        refineBINT(ptrR);
+        memset(out, 0, k * sizeof(WORD));
+        memcpy(out, ptrR->val, MINIMUM(ptrR->wordlen, k) * sizeof(WORD));
+        delete_bint(&ptrT); delete_bint(&ptrN); delete_bint(&ptrQ); delete_bint(&ptrR);
+        return;
+    }
+    WORD* t = BARRETT_PROD(ptrCtx);
+    memset(t, 0, 2 * k * sizeof(WORD));
+    memcpy(t, ptrX->val, len * sizeof(WORD));
+    barrett_reduce_words(out, t, ptrCtx);
+}
+
+// out <- X as k words; only operands wider than that are reduced first
+static void barrett_load(WORD* out, BINT* ptrX, BarrettCtx* ptrCtx) {
+    int len = ptrX->wordlen;
+    while (len > ptrCtx->wordlen && ptrX->val[len - 1] == 0)
+        len--;
+    if (len > ptrCtx->wordlen)
+        barrett_enter(out, ptrX, ptrCtx);
+    else
+        mont_load(out, ptrX, ptrCtx->wordlen);
+}
+
+static void barrett_leave(BINT** pptrZ, const WORD* a, BarrettCtx* ptrCtx) {
+    mont_store(pptrZ, a, ptrCtx->wordlen);
+}
+
+void init_barrett_ctx(BarrettCtx** pptrCtx, BINT* ptrMod) {
+    exit_on_null_error(pptrCtx, "pptrCtx", "init_barrett_ctx");
+    CHECK_PTR_AND_DEREF(&ptrMod, "ptrMod", "init_barrett_ctx");
+    delete_barrett_ctx(pptrCtx);
+
+    BarrettCtx* ctx = calloc(1, sizeof(BarrettCtx));
+    exit_on_null_error(ctx, "ctx", "init_barrett_ctx");
+    copyBINT(&ctx->ptrMod, &ptrMod);
+    refineBINT(ctx->ptrMod);
+    ctx->ptrMod->sign = false;
+    if (isZero(ctx->ptrMod)) {
+        fprintf(stderr, "Error: zero modulus in 'init_barrett_ctx'\n");
+        exit(1);
+    }
+    int k = ctx->wordlen = ctx->ptrMod->wordlen;
+
+    ctx->mu = calloc(k + 2, sizeof(WORD));
+    ctx->one = calloc(k, sizeof(WORD));
+    ctx->scratch = calloc(7 * k + 5, sizeof(WORD));
+    exit_on_null_error(ctx->mu, "mu", "init_barrett_ctx");
+    exit_on_null_error(ctx->one, "one", "init_barrett_ctx");
+    exit_on_null_error(ctx->scratch, "scratch", "init_barrett_ctx");
+    barrett_mu_words(ctx->mu, ctx->ptrMod->val, k);
+    ctx->one[0] = (k == 1 && ctx->ptrMod->val[0] == WORD_ONE) ? 0 : WORD_ONE;     // 1 mod n
+
+    *pptrCtx = ctx;
+}
+
+void delete_barrett_ctx(BarrettCtx** pptrCtx) {
+    if (pptrCtx == NULL || *pptrCtx == NULL)
+        return;
+    delete_bint(&(*pptrCtx)->ptrMod);
+    free((*pptrCtx)->mu);
+    free((*pptrCtx)->one);
+    free((*pptrCtx)->scratch);
+    free(*pptrCtx);
+    *pptrCtx = NULL;
+}
+
+void BARRETT_Reduce(BINT** pptrX, BINT** pptrZ, BarrettCtx* ptrCtx) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "BARRETT_Reduce");
+    WORD* a = BARRETT_OPS(ptrCtx);
+    barrett_enter(a, *pptrX, ptrCtx);
+    mont_store(pptrZ, a, ptrCtx->wordlen);
+}
+
+void BARRETT_Mul(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BarrettCtx* ptrCtx) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "BARRETT_Mul");
+    CHECK_PTR_AND_DEREF(pptrY, "pptrY", "BARRETT_Mul");
+    int k = ptrCtx->wordlen;
+    WORD* a = BARRETT_OPS(ptrCtx);
+    WORD* b = a + k;
+    barrett_load(a, *pptrX, ptrCtx);
+    barrett_load(b, *pptrY, ptrCtx);
+    barrett_mul_words(a, a, b, ptrCtx);
+    mont_store(pptrZ, a, k);
+}
+
+void BARRETT_Sqr(BINT** pptrX, BINT** pptrZ, BarrettCtx* ptrCtx) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "BARRETT_Sqr");
+    int k = ptrCtx->wordlen;
+    WORD* a = BARRETT_OPS(ptrCtx);
+    barrett_load(a, *pptrX, ptrCtx);
+    barrett_sqr_words(a, a, ptrCtx);
+    mont_store(pptrZ, a, k);
+}
+
+static void barrett_engine_mul(WORD* out, const WORD* a, const WORD* b, void* ctx) { barrett_mul_words(out, a, b, ctx); }
+static void barrett_engine_sqr(WORD* out, const WORD* a, void* ctx) { barrett_sqr_words(out, a, ctx); }
+static void barrett_engine_enter(WORD* out, BINT* ptrX, void* ctx) { barrett_enter(out, ptrX, ctx); }
+static void barrett_engine_leave(BINT** pptrZ, const WORD* a, void* ctx) { barrett_leave(pptrZ, a, ctx); }
+
+static mod_engine barrett_engine(BarrettCtx* ptrCtx) {
+    mod_engine e = { ptrCtx->wordlen, ptrCtx, ptrCtx->one,
+                     barrett_engine_mul, barrett_engine_sqr, barrett_engine_enter, barrett_engine_leave };
+    return e;
+}
+
+void EXP_MOD_L2R_Barrett(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BarrettCtx* ptrCtx) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "EXP_MOD_L2R_Barrett");
+    CHECK_PTR_AND_DEREF(pptrY, "pptrY", "EXP_MOD_L2R_Barrett");
+    mod_engine e = barrett_engine(ptrCtx);
+    exp_l2r(&e, *pptrX, *pptrY, pptrZ);
+}
+
+void EXP_MOD_R2L_Barrett(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BarrettCtx* ptrCtx) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "EXP_MOD_R2L_Barrett");
+    CHECK_PTR_AND_DEREF(pptrY, "pptrY", "EXP_MOD_R2L_Barrett");
+    mod_engine e = barrett_engine(ptrCtx);
+    exp_r2l(&e, *pptrX, *pptrY, pptrZ);
+}
+
+void EXP_MOD_Ladder_Barrett(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BarrettCtx* ptrCtx) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "EXP_MOD_Ladder_Barrett");
+    CHECK_PTR_AND_DEREF(pptrY, "pptrY", "EXP_MOD_Ladder_Barrett");
+    mod_engine e = barrett_engine(ptrCtx);
+    exp_ladder(&e, *pptrX, *pptrY, pptrZ);
+}
+
+void EXP_MOD_KAry_Barrett(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BarrettCtx* ptrCtx) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "EXP_MOD_KAry_Barrett");
+    CHECK_PTR_AND_DEREF(pptrY, "pptrY", "EXP_MOD_KAry_Barrett");
+    mod_engine e = barrett_engine(ptrCtx);
+    exp_kary(&e, *pptrX, *pptrY, pptrZ);
+}
+
+void EXP_MOD_Sliding_Barrett(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BarrettCtx* ptrCtx) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "EXP_MOD_Sliding_Barrett");
+    CHECK_PTR_AND_DEREF(pptrY, "pptrY", "EXP_MOD_Sliding_Barrett");
+    mod_engine e = barrett_engine(ptrCtx);
+    exp_sliding(&e, *pptrX, *pptrY, pptrZ);
+}
+
+void EXP_MOD_Multi_Barrett(BINT** ptrBases, BINT** ptrExps, int count, BINT** pptrZ, BarrettCtx* ptrCtx) {
+    exit_on_null_error(ptrBases, "ptrBases", "EXP_MOD_Multi_Barrett");
+    exit_on_null_error(ptrExps, "ptrExps", "EXP_MOD_Multi_Barrett");
+    for (int j = 0; j < count; j++) {
+        CHECK_PTR_AND_DEREF(&ptrBases[j], "ptrBases[j]", "EXP_MOD_Multi_Barrett");
+        CHECK_PTR_AND_DEREF(&ptrExps[j], "ptrExps[j]", "EXP_MOD_Multi_Barrett");
+    }
+    mod_engine e = barrett_engine(ptrCtx);
+    exp_multi(&e, ptrBases, ptrExps, count, pptrZ);
+}
+
+/*
+ * Fixed-base exponentiation
+ */
+
+#define FB_MAGIC "PUBAO-FB"
+#define FB_VERSION 1
+#define FB_HEX_MAX 2048
+
+static WORD* fb_entry(FixedBase* ptrFB, int i, unsigned d) {
+    size_t digits = ((size_t)1 << ptrFB->width) - 1;
+    return ptrFB->table + ((size_t)i * digits + (d - 1)) * ptrFB->wordlen;
+}
+
+// The table is shared and read-only, so every call runs on a shallow copy of the context with its own scratch
+// buffer: any number of threads may evaluate the same table at once
+static void fb_with_engine(FixedBase* ptrFB, void (*run)(mod_engine*, FixedBase*, void*), void* arg) {
+    int k = ptrFB->wordlen;
+    if (ptrFB->ptrMont) {
+        MontCtx local = *ptrFB->ptrMont;
+        local.scratch = calloc(4 * k + 2, sizeof(WORD));
+        exit_on_null_error(local.scratch, "scratch", "fb_with_engine");
+        mod_engine e = mont_engine(&local);
+        run(&e, ptrFB, arg);
+        free(local.scratch);
+    } else {
+        BarrettCtx local = *ptrFB->ptrBarrett;
+        local.scratch = calloc(7 * k + 5, sizeof(WORD));
+        exit_on_null_error(local.scratch, "scratch", "fb_with_engine");
+        mod_engine e = barrett_engine(&local);
+        run(&e, ptrFB, arg);
+        free(local.scratch);
+    }
+}
+
+// entry(i, d) = g^(d * 2^(i * w)): each entry is one multiplication away from the previous one
+static void fb_build(mod_engine* e, FixedBase* ptrFB, void* arg) {
+    unsigned digits = (1u << ptrFB->width) - 1;
+    e->enter(fb_entry(ptrFB, 0, 1), (BINT*)arg, e->ctx);
+    for (int i = 0; i < ptrFB->windows; i++) {
+        if (i > 0)
+            e->mul(fb_entry(ptrFB, i, 1), fb_entry(ptrFB, i - 1, digits), fb_entry(ptrFB, i - 1, 1), e->ctx);
+        for (unsigned d = 2; d <= digits; d++)
+            e->mul(fb_entry(ptrFB, i, d), fb_entry(ptrFB, i, d - 1), fb_entry(ptrFB, i, 1), e->ctx);
+    }
+}
+
+typedef struct {
+    BINT* ptrY;
+    BINT** pptrZ;
+} fb_exp_arg;
+
+static void fb_exp(mod_engine* e, FixedBase* ptrFB, void* arg) {
+    fb_exp_arg* fa = arg;
+    int bit_len = BIT_LENGTH(fa->ptrY);
+    if (bit_len > ptrFB->max_bits) {
+        // Longer than the table: fall back to a generic exponentiation of the stored base
+        exp_sliding(e, ptrFB->ptrBase, fa->ptrY, fa->pptrZ);
+        return;
+    }
+    WORD* t = calloc(e->k, sizeof(WORD));
+    exit_on_null_error(t, "t", "fb_exp");
+    memcpy(t, e->one, e->k * sizeof(WORD));
+    bool first = true;
+    for (int i = 0; i * ptrFB->width < bit_len; i++) {
+        unsigned d = exp_bits(fa->ptrY, i * ptrFB->width, ptrFB->width);
+        if (d == 0)
+            continue;
+        if (first)
+            memcpy(t, fb_entry(ptrFB, i, d), e->k * sizeof(WORD));
+        else
+            e->mul(t, t, fb_entry(ptrFB, i, d), e->ctx);
+        first = false;
+    }
+    e->leave(fa->pptrZ, t, e->ctx);
+    free(t);
+}
+
+// Allocates an empty table for base G (reduced mod n) and its context; entries are filled by the caller
+static FixedBase* fb_alloc(BINT* ptrG, BINT* ptrMod, int max_bits, int width) {
+    FixedBase* fb = calloc(1, sizeof(FixedBase));
+    exit_on_null_error(fb, "fb", "fb_alloc");
+    copyBINT(&fb->ptrMod, &ptrMod);
+    refineBINT(fb->ptrMod);
+    fb->ptrMod->sign = false;
+    if (fb->ptrMod->val[0] & 1)
+        init_mont_ctx(&fb->ptrMont, fb->ptrMod);
+    else
+        init_barrett_ctx(&fb->ptrBarrett, fb->ptrMod);
+    fb->wordlen = fb->ptrMod->wordlen;
+    fb->width = width;
+    fb->max_bits = max_bits;
+    fb->windows = (max_bits + width - 1) / width;
+
+    BINT *ptrQ = NULL, *ptrN = NULL, *ptrT = NULL;
+    copyBINT(&ptrT, &ptrG);
+    copyBINT(&ptrN, &fb->ptrMod);
+    ptrT->sign = false;
+    DIV_Long(&ptrT, &ptrN, &ptrQ, &fb->ptrBase);
+    refineBINT(fb->ptrBase);
+    delete_bint(&ptrQ); delete_bint(&ptrN); delete_bint(&ptrT);
+
+    size_t entries = (size_t)fb->windows * (((size_t)1 << width) - 1);
+    fb->table = calloc(MAXIMUM(entries, 1) * fb->wordlen, sizeof(WORD));
+    exit_on_null_error(fb->table, "table", "fb_alloc");
+    return fb;
+}
+
+void init_fixed_base(FixedBase** pptrFB, BINT** pptrG, BINT* ptrMod, int max_bits, int width) {
+    exit_on_null_error(pptrFB, "pptrFB", "init_fixed_base");
+    CHECK_PTR_AND_DEREF(pptrG, "pptrG", "init_fixed_base");
+    CHECK_PTR_AND_DEREF(&ptrMod, "ptrMod", "init_fixed_base");
+    delete_fixed_base(pptrFB);
+    if (width <= 0)
+        width = FB_DEFAULT_WIDTH;
+    if (width > FB_MAX_WIDTH || max_bits < 1) {
+        fprintf(stderr, "Error: invalid table shape in 'init_fixed_base'\n");
+        exit(1);
+    }
+    if (isZero(ptrMod)) {
+        fprintf(stderr, "Error: zero modulus in 'init_fixed_base'\n");
+        exit(1);
+    }
+    FixedBase* fb = fb_alloc(*pptrG, ptrMod, max_bits, width);
+    fb_with_engine(fb, fb_build, fb->ptrBase);
+    *pptrFB = fb;
+}
+
+void delete_fixed_base(FixedBase** pptrFB) {
+    if (pptrFB == NULL || *pptrFB == NULL)
+        return;
+    delete_bint(&(*pptrFB)->ptrMod);
+    delete_bint(&(*pptrFB)->ptrBase);
+    delete_mont_ctx(&(*pptrFB)->ptrMont);
+    delete_barrett_ctx(&(*pptrFB)->ptrBarrett);
+    free((*pptrFB)->table);
+    free(*pptrFB);
+    *pptrFB = NULL;
+}
+
+void EXP_MOD_FixedBase(FixedBase* ptrFB, BINT** pptrY, BINT** pptrZ) {
+    exit_on_null_error(ptrFB, "ptrFB", "EXP_MOD_FixedBase");
+    CHECK_PTR_AND_DEREF(pptrY, "pptrY", "EXP_MOD_FixedBase");
+    fb_exp_arg fa = { *pptrY, pptrZ };
+    fb_with_engine(ptrFB, fb_exp, &fa);
+}
+
+typedef struct {
+    FILE* fp;
+    bool ok;
+} fb_io_arg;
+
+// Entries go to disk as ordinary residues, so the file does not depend on WORD_BITLEN or the context type
+static void fb_write(mod_engine* e, FixedBase* ptrFB, void* arg) {
+    fb_io_arg* io = arg;
+    size_t digits = ((size_t)1 << ptrFB->width) - 1;
+    BINT* ptrT = NULL;
+    for (int i = 0; i < ptrFB->windows; i++) {
+        for (size_t d = 1; d <= digits; d++) {
+            e->leave(&ptrT, fb_entry(ptrFB, i, (unsigned)d), e->ctx);
+            write_bint_hex(io->fp, ptrT);
+            fputc('\n', io->fp);
+        }
+    }
+    delete_bint(&ptrT);
+}
+
+static void fb_read(mod_engine* e, FixedBase* ptrFB, void* arg) {
+    fb_io_arg* io = arg;
+    size_t digits = ((size_t)1 << ptrFB->width) - 1;
+    size_t cap = (size_t)ptrFB->wordlen * WORD_BITLEN / 4 + 3;
+    char* hex = calloc(cap + 1, 1);
+    char fmt[32];
+    exit_on_null_error(hex, "hex", "fb_read");
+    snprintf(fmt, sizeof(fmt), " %%%zus", cap);
+    BINT* ptrT = NULL;
+    for (int i = 0; io->ok && i < ptrFB->windows; i++) {
+        for (size_t d = 1; io->ok && d <= digits; d++) {
+            io->ok = fscanf(io->fp, fmt, hex) == 1 && read_bint_hex(&ptrT, hex);
+            if (io->ok)
+                e->enter(fb_entry(ptrFB, i, (unsigned)d), ptrT, e->ctx);
+        }
+    }
+    // The first entry is the base itself: a cheap check that the table belongs to the header
+    if (io->ok) {
+        e->leave(&ptrT, fb_entry(ptrFB, 0, 1), e->ctx);
+        io->ok = ptrT->wordlen == ptrFB->ptrBase->wordlen &&
+                 memcmp(ptrT->val, ptrFB->ptrBase->val, ptrT->wordlen * sizeof(WORD)) == 0;
+    }
+    free(hex);
+    delete_bint(&ptrT);
+}
+
+bool FB_Save(FixedBase* ptrFB, const char* path) {
+    exit_on_null_error(ptrFB, "ptrFB", "FB_Save");
+    FILE* fp = fopen(path, "w");
+    if (fp == NULL) {
+        fprintf(stderr, "Error: Unable to open '%s' in 'FB_Save'\n", path);
+        return false;
+    }
+    fprintf(fp, "%s %d\n", FB_MAGIC, FB_VERSION);
+    fputs("p ", fp); write_bint_hex(fp, ptrFB->ptrMod);  fputc('\n', fp);
+    fputs("g ", fp); write_bint_hex(fp, ptrFB->ptrBase); fputc('\n', fp);
+    fprintf(fp, "w %d %d\n", ptrFB->width, ptrFB->max_bits);
+    fb_io_arg io = { fp, true };
+    fb_with_engine(ptrFB, fb_write, &io);
+    return fclose(fp) == 0;
+}
+
+bool FB_Load(FixedBase** pptrFB, const char* path) {
+    exit_on_null_error(pptrFB, "pptrFB", "FB_Load");
+    delete_fixed_base(pptrFB);
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "Error: Unable to open '%s' in 'FB_Load'\n", path);
+        return false;
+    }
+    char magic[16], hex[FB_HEX_MAX + 1];
+    int version = 0, width = 0, max_bits = 0;
+    BINT *ptrP = NULL, *ptrG = NULL;
+    FixedBase* fb = NULL;
+    bool ok = fscanf(fp, "%15s %d", magic, &version) == 2 &&
+              strcmp(magic, FB_MAGIC) == 0 && version == FB_VERSION;
+    ok = ok && fscanf(fp, " p %2048s", hex) == 1 && read_bint_hex(&ptrP, hex) && !isZero(ptrP);
+    ok = ok && fscanf(fp, " g %2048s", hex) == 1 && read_bint_hex(&ptrG, hex);
+    ok = ok && fscanf(fp, " w %d %d", &width, &max_bits) == 2 &&
+         width >= 1 && width <= FB_MAX_WIDTH && max_bits >= 1;
+    if (ok) {
+        fb = fb_alloc(ptrG, ptrP, max_bits, width);
+        fb_io_arg io = { fp, true };
+        fb_with_engine(fb, fb_read, &io);
+        ok = io.ok;
+    }
+    fclose(fp);
+    delete_bint(&ptrP); delete_bint(&ptrG);
+    if (!ok) {
+        fprintf(stderr, "Error: Malformed table '%s' in 'FB_Load'\n", path);
+        delete_fixed_base(&fb);
+    }
+    *pptrFB = fb;
+    return ok;
+}
+
+/*
+ * Extended Euclid: runs of Lehmer steps below mpn_hgcd_threshold, the half-GCD recursion above it
+ */
+
+// Row matrix of a run of Euclid steps, as in mpn_gcd_lehmer: k steps take (a, b) to ((-1)^k (x0 a - y0 b),
+// (-1)^(k+1) (x1 a - y1 b)). The entries {x0, y0, x1, y1} hold n words each in buffers of cap words, and odd
+// is the parity of k; the entries move between the buffers of w as steps swap rows
+typedef struct {
+    WORD* e[4];
+    WORD* w;
+    int n, cap;
+    bool odd;
+} gcd_matrix;
+
+// The identity, with room for entries of cap - 2 words, which mpn_gcd_mul_1 needs
+static void gcd_matrix_init(gcd_matrix* m, int cap) {
+    WORD* w = calloc((size_t)4 * cap, sizeof(WORD));
+    exit_on_null_error(w, "w", "gcd_matrix_init");
+    for (int i = 0; i < 4; i++)
+        m->e[i] = w + (size_t)i * cap;
+    m->w = w;
+    m->e[0][0] = m->e[3][0] = WORD_ONE;
+    m->n = 1;
+    m->cap = cap;
+    m->odd = false;
+}
+
+static void gcd_matrix_free(gcd_matrix* m) {
+    free(m->w);
+}
+
+// Number of significant words of the larger of a and b
+static int gcd_len(const WORD* ap, const WORD* bp, int n) {
+    int an = mpn_normalize(ap, n), bn = mpn_normalize(bp, n);
+    return MAXIMUM(an, bn);
+}
+
+// rp <- ap * bp with ws grown to fit; returns the significant words of the product
+static int gcd_mul(WORD* rp, const WORD* ap, int an, const WORD* bp, int bn, BINT* ws) {
+    an = mpn_normalize(ap, an);
+    bn = mpn_normalize(bp, bn);
+    if (an == 0 || bn == 0)
+        return 0;
+    if (an < bn) {
+        const WORD* t = ap; ap = bp; bp = t;
+        int tn = an; an = bn; bn = tn;
+    }
+    reserveBINT(ws, mpn_mul_itch(an, bn));
+    mpn_mul(rp, ap, an, bp, bn, ws->val);
+    return mpn_normalize(rp, an + bn);
+}
+
+// rp <- ap + bp, or |ap - bp| when sub, zero-padded to n words; the result fits in them. Returns whether the
+// difference is bp - ap
+static bool gcd_combine(WORD* rp, int n, const WORD* ap, int an, const WORD* bp, int bn, bool sub) {
+    bool swap = an < bn || (sub && an == bn && mpn_cmp(ap, bp, an) < 0);
+    if (swap) {
+        const WORD* t = ap; ap = bp; bp = t;
+        int tn = an; an = bn; bn = tn;
+    }
+    WORD c = an == 0 ? 0 : sub ? mpn_sub(rp, ap, an, bp, bn) : mpn_add(rp, ap, an, bp, bn);
+    if (an < n) {
+        rp[an] = c;
+        mpn_zero(rp + an + 1, n - an - 1);
+    }
+    return swap;
+}
+
+// The four products r0 u, r1 v, r2 u, r3 v of the row matrix r and a column (u, v) of n words, at pn = r->n + n
+// words apart from the start of t; the scratch of mpn_mul goes to ws
+static void gcd_products(WORD* tp, int* len, const gcd_matrix* r, const WORD* up, const WORD* vp, int n, BINT* ws) {
+    int pn = r->n + n;
+    for (int i = 0; i < 4; i++)
+        len[i] = gcd_mul(tp + (size_t)i * pn, r->e[i], r->n, i % 2 ? vp : up, n, ws);
+}
+
+// m <- r m on the first cols columns of m: a run r that follows the run m
+static void gcd_matrix_mul(gcd_matrix* m, const gcd_matrix* r, int cols) {
+    BINT t = BINT_INITIALIZER(t), ws = BINT_INITIALIZER(ws);
+    ArenaMark mark = bint_arena_begin();
+    int pn = r->n + m->n, len = m->cap - 2;
+    reserveBINT(&t, 4 * pn);
+    for (int j = 0; j < cols; j++) {
+        // The new entries are sums of the products, so these fit in the entries' buffers
+        int l[4];
+        gcd_products(t.val, l, r, m->e[j], m->e[2 + j], m->n, &ws);
+        gcd_combine(m->e[j], len, t.val, l[0], t.val + pn, l[1], false);
+        gcd_combine(m->e[2 + j], len, t.val + 2 * pn, l[2], t.val + 3 * pn, l[3], false);
+    }
+    int n = 0;
+    for (int j = 0; j < cols; j++) {
+        int un = gcd_len(m->e[j], m->e[2 + j], len);
+        n = MAXIMUM(n, un);
+    }
+    m->n = MAXIMUM(n, 1);
+    m->odd ^= r->odd;
+    clear_bint(&t);
+    clear_bint(&ws);
+    bint_arena_end(mark, NULL, 0);
+}
+
+// m <- r m for a single-word run r of k steps from mpn_gcd_lehmer
+static void gcd_matrix_mul_1(gcd_matrix* m, int cols, const WORD* r, int k) {
+    int n = 0;
+    for (int j = 0; j < cols; j++) {
+        mpn_gcd_mul_1(m->e[j], m->e[2 + j], m->n, r);
+        int un = gcd_len(m->e[j], m->e[2 + j], m->n + 2);
+        n = MAXIMUM(n, un);
+    }
+    m->n = MAXIMUM(n, 1);
+    m->odd ^= k & 1;
+}
+
+// Completes on all n words of (a, b) the run r that has taken their top n - p words to (alpha, beta) in place:
+// with the low words a0 and b0, a <- alpha W^p + (-1)^k (x0 a0 - y0 b0) and b <- beta W^p - (-1)^k (x1 a0 - y1 b0)
+static void gcd_matrix_apply(const gcd_matrix* r, WORD* ap, WORD* bp, int n, int p) {
+    BINT t = BINT_INITIALIZER(t), ws = BINT_INITIALIZER(ws);
+    ArenaMark mark = bint_arena_begin();
+    int pn = r->n + p, l[4];
+    reserveBINT(&t, 6 * pn + 2);
+    WORD *da = t.val + 4 * pn, *db = da + pn + 1;
+    gcd_products(t.val, l, r, ap, bp, p, &ws);
+    bool nega = gcd_combine(da, pn + 1, t.val, l[0], t.val + pn, l[1], true) != r->odd;
+    bool negb = gcd_combine(db, pn + 1, t.val + 2 * pn, l[2], t.val + 3 * pn, l[3], true) == r->odd;
+    int an = mpn_normalize(da, pn + 1), bn = mpn_normalize(db, pn + 1);
+    mpn_zero(ap, p);
+    mpn_zero(bp, p);
+    if (nega)
+        mpn_sub(ap, ap, n, da, an);
+    else
+        mpn_add(ap, ap, n, da, an);
+    if (negb)
+        mpn_sub(bp, bp, n, db, bn);
+    else
+        mpn_add(bp, bp, n, db, bn);
+    clear_bint(&t);
+    clear_bint(&ws);
+    bint_arena_end(mark, NULL, 0);
+}
+
+// One Euclid step (a, b) <- (b, a mod b) on n-word values, carried into the first cols columns of m. With a
+// floor s >= 0, the step is not taken, and false returned, if a mod b < W^s
+static bool gcd_div_step(gcd_matrix* m, int cols, WORD* ap, WORD* bp, int n, int s) {
+    int an = mpn_normalize(ap, n), bn = mpn_normalize(bp, n);
+    BINT t = BINT_INITIALIZER(t), ws = BINT_INITIALIZER(ws);
+    ArenaMark mark = bint_arena_begin();
+    reserveBINT(&t, 2 * an + bn + m->n + 2);
+    WORD *qp = t.val, *rp = qp + MAXIMUM(an, 1), *p = rp + bn + 1;
+    reserveBINT(&ws, mpn_div_qr_itch(an, bn));
+    mpn_div_qr(qp, rp, ap, an, bp, bn, ws.val);
+    bool ok = s < 0 || mpn_normalize(rp, bn) > s;
+    if (ok) {
+        // (x, y) <- (y, x + q y) in each column
+        int qn = mpn_normalize(qp, an);
+        for (int j = 0; j < cols; j++) {
+            WORD *x = m->e[j], *y = m->e[2 + j];
+            int pn = gcd_mul(p, qp, qn, y, m->n, &ws);
+            gcd_combine(x, m->cap - 2, x, mpn_normalize(x, m->n), p, pn, false);
+            m->e[j] = y;
+            m->e[2 + j] = x;
+        }
+        int len = 0;
+        for (int j = 0; j < cols; j++) {
+            int un = gcd_len(m->e[j], m->e[2 + j], m->cap - 2);
+            len = MAXIMUM(len, un);
+        }
+        m->n = MAXIMUM(len, 1);
+        m->odd = !m->odd;
+        mpn_copy(ap, bp, n);
+        mpn_copy(bp, rp, bn);
+        mpn_zero(bp + bn, n - bn);
+    }
+    clear_bint(&t);
+    clear_bint(&ws);
+    bint_arena_end(mark, NULL, 0);
+    return ok;
+}
+
+static bool hgcd(gcd_matrix* m, WORD* ap, WORD* bp, int n);
+
+// Runs of Lehmer steps, and single steps where they decide none, while the remainders stay at or above W^s
+static bool hgcd_lehmer(gcd_matrix* m, WORD* ap, WORD* bp, int n, int s) {
+    bool progress = false;
+    for (;;) {
+        int len = gcd_len(ap, bp, n);
+        WORD r[4];
+        int k = mpn_gcd_lehmer(r, ap, bp, len, s);
+        if (k > 0) {
+            mpn_gcd_apply_1(ap, bp, len, r, k);
+            gcd_matrix_mul_1(m, 2, r, k);
+        } else if (!gcd_div_step(m, 2, ap, bp, len, s)) {
+            break;
+        }
+        progress = true;
+    }
+    return progress;
+}
+
+// The half-GCD of the top n - p words of (a, b), reduced in place, then completed on the low words and
+// carried into m
+static bool hgcd_top(gcd_matrix* m, WORD* ap, WORD* bp, int n, int p) {
+    int n1 = n - p;
+    gcd_matrix r;
+    gcd_matrix_init(&r, n1 - (n1 / 2 + 1) + 2);
+    bool progress = hgcd(&r, ap + p, bp + p, n1);
+    if (progress) {
+        gcd_matrix_apply(&r, ap, bp, n, p);
+        gcd_matrix_mul(m, &r, 2);
+    }
+    gcd_matrix_free(&r);
+    return progress;
+}
+
+// Half-GCD (Thull and Yap, "A unified approach to HGCD algorithms", 1990; Moller, "On Schonhage's algorithm
+// and subquadratic integer gcd computation", 2008): Euclid steps on the n-word values a and b, both above W^s
+// for s = n/2 + 1, for as long as the remainders stay at or above W^s, carried into m, whose entries then take
+// at most n - s words. Up to a last quotient, the steps on the top n1 words of a and b are also steps on the
+// full values, as their remainders, at or above W^(n1/2 + 1), outweigh what the lower words contribute through
+// cofactors of at most n1/2 words. Returns false if no step was taken
+static bool hgcd(gcd_matrix* m, WORD* ap, WORD* bp, int n) {
+    int s = n / 2 + 1;
+    if (mpn_normalize(ap, n) <= s || mpn_normalize(bp, n) <= s)
+        return false;
+    bool progress = false;
+    if (n >= mpn_hgcd_threshold) {
+        // Two recursions of about n/2 words each: the top half takes off about n/4 words, and the top
+        // 2 (n2 - s) words of what is left take them down to s
+        if (hgcd_top(m, ap, bp, n, n / 2))
+            progress = true;
+        int n2 = gcd_len(ap, bp, n);
+        if (n2 - s >= 2 && hgcd_top(m, ap, bp, n2, 2 * s - n2))
+            progress = true;
+    }
+    if (hgcd_lehmer(m, ap, bp, n, s))
+        progress = true;
+    return progress;
 }
 
 void EEA(BINT** pptrX, BINT** pptrY, BINT** pptrS, BINT** pptrT, BINT** pptrGCD) {
-    BINT *r1 = NULL, *r2 = NULL;
-    BINT *s1 = NULL, *s2 = NULL;
-    BINT *t1 = NULL, *t2 = NULL;   
-    BINT *q = NULL;
-    
-    init_bint(&s1, 1);
-    s1->val[0] = WORD_ONE;
-    init_bint(&t2, 1);
-    t2->val[0] = WORD_ONE;
-    
-    init_bint(&s2, 1);
-    init_bint(&t1, 1);
-    
-    copyBINT(&r1, pptrX);
-    copyBINT(&r2, pptrY); 
-
-    while ((r2)->wordlen != 1 || (r2)->val[0] != 0) {
-        BINT* temp = NULL;
-    
-        DIV_Binary_Long(&r1,&r2,&q, pptrGCD);
-
-        copyBINT(&r1, &r2);
-        copyBINT(&r2, pptrGCD);
-
-        MUL_Core_ImpTxtBk_xyz(&q, &s2, &temp);
-        // bool sgnQ1 = q->sign; bool sgnS2 = s2->sign;
-        // MUL_Core_Krtsb_xyz(&q, &s2, &temp);
-        // temp->sign = sgnQ1 ^ sgnS2;
-
-        SUB(&s1, &temp, pptrS);
-        
-        copyBINT(&s1, &s2);
-        copyBINT(&s2, pptrS);
-        
-        MUL_Core_ImpTxtBk_xyz(&q, &t2, &temp);
-        // bool sgnQ2 = q->sign; bool sgnT2 = t2->sign;
-        // MUL_Core_Krtsb_xyz(&q, &t2, &temp);
-        // temp->sign = sgnQ2 ^ sgnS2;
-        
-        SUB(&t1, &temp, pptrT);
-
-        copyBINT(&t1, &t2);
-        copyBINT(&t2, pptrT);
-        
-        delete_bint(&temp);
-        
-        refineBINT(r2);
-    }
-    
-    copyBINT(pptrGCD, &r1);
-    copyBINT(pptrS, &s1);
-    copyBINT(pptrT, &t1);    
-    
-    delete_bint(&q);
-    delete_bint(&r1);
-    delete_bint(&r2);
-    delete_bint(&s1);
-    delete_bint(&s2);
-    delete_bint(&t1);
-    delete_bint(&t2);
-}
\ No newline at end of file
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "EEA");
+    CHECK_PTR_AND_DEREF(pptrY, "pptrY", "EEA");
+    exit_on_null_error(pptrS, "pptrS", "EEA");
+    exit_on_null_error(pptrT, "pptrT", "EEA");
+    exit_on_null_error(pptrGCD, "pptrGCD", "EEA");
+    BINT* ptrX = *pptrX; BINT* ptrY = *pptrY;
+    int xn = mpn_normalize(ptrX->val, ptrX->wordlen), yn = mpn_normalize(ptrY->val, ptrY->wordlen);
+    int N = MAXIMUM(xn, yn) + 1;
+
+    // The reduction runs on |X| and |Y| and keeps only the first column of its matrix: at the end
+    // g = (-1)^k x0 |X| - (-1)^k y0 |Y|, and t follows from s
+    BINT a = BINT_INITIALIZER(a), b = BINT_INITIALIZER(b);
+    ArenaMark mark = bint_arena_begin();
+    reserveBINT(&a, N);
+    reserveBINT(&b, N);
+    mpn_zero(a.val, N);
+    mpn_zero(b.val, N);
+    mpn_copy(a.val, ptrX->val, xn);
+    mpn_copy(b.val, ptrY->val, yn);
+    gcd_matrix u;
+    gcd_matrix_init(&u, N + 2);
+
+    int n;
+    while ((n = gcd_len(a.val, b.val, N)) > 0 && mpn_normalize(b.val, n) > 0) {
+        int s = n / 2 + 1;
+        if (n >= mpn_hgcd_threshold && mpn_normalize(a.val, n) > s && mpn_normalize(b.val, n) > s) {
+            gcd_matrix m;
+            gcd_matrix_init(&m, n - s + 2);
+            bool progress = hgcd(&m, a.val, b.val, n);
+            if (progress)
+                gcd_matrix_mul(&u, &m, 1);
+            gcd_matrix_free(&m);
+            if (progress)
+                continue;
+        }
+        WORD r[4];
+        int k = mpn_gcd_lehmer(r, a.val, b.val, n, -1);
+        if (k > 0) {
+            mpn_gcd_apply_1(a.val, b.val, n, r, k);
+            gcd_matrix_mul_1(&u, 1, r, k);
+        } else {
+            gcd_div_step(&u, 1, a.val, b.val, n, -1);
+        }
+    }
+
+    BINT *ptrG = NULL, *ptrS = NULL, *ptrT = NULL, *ptrP = NULL, *ptrR = NULL;
+    int gn = MAXIMUM(mpn_normalize(a.val, N), 1);
+    init_bint(&ptrG, gn);
+    mpn_copy(ptrG->val, a.val, gn);
+    refineBINT(ptrG);
+    clear_bint(&a);
+    clear_bint(&b);
+    bint_arena_end(mark, (BINT**[]){ &ptrG }, 1);
+    init_bint(&ptrS, u.n);
+    mpn_copy(ptrS->val, u.e[0], u.n);
+    ptrS->sign = u.odd != ptrX->sign;
+    refineBINT(ptrS);
+    if (yn == 0) {
+        init_bint(&ptrT, 1);
+    } else {
+        // t = (g - s X) / Y exactly
+        MUL_Core_Krtsb_xyz(&ptrS, pptrX, &ptrP);
+        SUB(&ptrG, &ptrP, &ptrP);
+        DIV_Long(&ptrP, pptrY, &ptrT, &ptrR);
+    }
+    copyBINT(pptrGCD, &ptrG);
+    copyBINT(pptrS, &ptrS);
+    copyBINT(pptrT, &ptrT);
+
+    delete_bint(&ptrG); delete_bint(&ptrS); delete_bint(&ptrT);
+    delete_bint(&ptrP); delete_bint(&ptrR);
+    gcd_matrix_free(&u);
+}
+
+void GCD_Binary(BINT** pptrX, BINT** pptrY, BINT** pptrGCD) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "GCD_Binary");
+    CHECK_PTR_AND_DEREF(pptrY, "pptrY", "GCD_Binary");
+    exit_on_null_error(pptrGCD, "pptrGCD", "GCD_Binary");
+    BINT* ptrX = *pptrX; BINT* ptrY = *pptrY;
+    int n = bint_size(ptrX), m = bint_size(ptrY);
+
+    BINT tmp = BINT_INITIALIZER(tmp), ws = BINT_INITIALIZER(ws);
+    BINT* ptrZ = bint_target(pptrGCD, ptrX, ptrY, &tmp, MAXIMUM(n, m));
+    mpn_zero(ptrZ->val, ptrZ->wordlen);
+    ArenaMark mark = bint_arena_begin();
+    reserveBINT(&ws, mpn_gcd_binary_itch(n, m));
+    mpn_gcd_binary(ptrZ->val, ptrX->val, n, ptrY->val, m, ws.val);
+    clear_bint(&ws);
+    bint_arena_end(mark, NULL, 0);
+    bint_settle(pptrGCD, ptrZ, &tmp, false);
+}
+
+bool INV_MOD_SafeGCD(BINT** pptrX, BINT** pptrZ, BINT* ptrMod) {
+    CHECK_PTR_AND_DEREF(pptrX, "pptrX", "INV_MOD_SafeGCD");
+    CHECK_PTR_AND_DEREF(&ptrMod, "ptrMod", "INV_MOD_SafeGCD");
+    exit_on_null_error(pptrZ, "pptrZ", "INV_MOD_SafeGCD");
+    int k = mpn_normalize(ptrMod->val, ptrMod->wordlen);
+    if (k == 0 || !(ptrMod->val[0] & 1)) {
+        fprintf(stderr, "Error: Even or zero modulus in 'INV_MOD_SafeGCD'\n");
+        exit(1);
+    }
+
+    // X is copied as it is stored, up to its wordlen, which the caller pads to k words to keep it private: no
+    // branch and no length here depends on its value
+    BINT* ptrX = *pptrX;
+    if (ptrX->wordlen > k) {
+        fprintf(stderr, "Error: X has more words than the modulus in 'INV_MOD_SafeGCD'\n");
+        exit(1);
+    }
+    BINT a = BINT_INITIALIZER(a), tmp = BINT_INITIALIZER(tmp), ws = BINT_INITIALIZER(ws);
+    BINT* ptrZ = bint_target(pptrZ, ptrX, ptrMod, &tmp, k);
+    ArenaMark mark = bint_arena_begin();
+    reserveBINT(&a, k);
+    mpn_zero(a.val, k);
+    mpn_copy(a.val, ptrX->val, ptrX->wordlen);
+
+    reserveBINT(&ws, mpn_sec_invert_itch(k));
+    bool ok = mpn_sec_invert(ptrZ->val, a.val, ptrMod->val, k, ws.val);
+    clear_bint(&a);
+    clear_bint(&ws);
+    bint_arena_end(mark, NULL, 0);
+
+    // The inverse keeps all k words: refining it would trim its top zero words in time that depends on them
+    if (ptrZ == &tmp) {
+        BINT* ptrTmp = &tmp;
+        swapBINT(pptrZ, &ptrTmp);
+        clear_bint(ptrTmp);
+    }
+    (*pptrZ)->sign = false;
+    (*pptrZ)->wordlen = k;
+    return ok;
+}
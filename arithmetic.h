@@ -40,12 +40,13 @@ void add_carry(WORD x, WORD y, WORD k, WORD* ptrQ, WORD* ptrR);
 
 /**
  * @brief Adds two arbitrary-sized binary integers.
- * @details Sums the binary integers pointed to by pptrX and pptrY and stores the result in the location pointed to by pptrZ.
+ * @details Sums the magnitudes of the binary integers pointed to by pptrX and pptrY with mpn_add and stores the
+ *          non-negative result in the location pointed to by pptrZ.
  * @param pptrX A double pointer to a BINT representing the first addend.
  * @param pptrY A double pointer to a BINT representing the second addend.
- * @param pptrZ A double pointer to a BINT where the result is to be stored.
- * @pre pptrX and pptrY must point to valid BINT objects. pptrZ must be initialized to store the result.
- * @post *pptrZ contains the sum of *pptrX and *pptrY.
+ * @param pptrZ A double pointer to a BINT where the result is to be stored; may be NULL, or alias an operand.
+ * @pre pptrX and pptrY must point to valid BINT objects.
+ * @post *pptrZ contains |*pptrX| + |*pptrY|; the operands are unchanged unless *pptrZ is one of them.
  * @note It's assumed that the BINT structure and associated functions properly manage memory and handle arithmetic.
  */
 void add_core_xyz(BINT** pptrX, BINT** pptrY, BINT** pptrZ);
@@ -56,8 +57,9 @@ void add_core_xyz(BINT** pptrX, BINT** pptrY, BINT** pptrZ);
  * @param pptrX A double pointer to a BINT representing the first operand.
  * @param pptrY A double pointer to a BINT representing the second operand.
  * @param pptrZ A double pointer to a BINT where the result should be stored.
- * @pre pptrX and pptrY must point to valid BINT objects. pptrZ must be properly allocated to store the result.
- * @post The result of addition is stored in the location pointed to by pptrZ.
+ * @pre pptrX and pptrY must point to valid BINT objects. *pptrZ may be NULL, or one of the operands.
+ * @post The result of addition is stored in the location pointed to by pptrZ; the operands are unchanged unless
+ *       *pptrZ is one of them.
  * @note This function may call other helper functions to manage BINT arithmetic and memory.
  */
 void ADD(BINT** pptrX, BINT** pptrY, BINT** pptrZ);
@@ -77,12 +79,13 @@ void sub_borrow(WORD x, WORD y, WORD* ptrQ, WORD* ptrR);
 
 /**
  * @brief Subtracts two arbitrary-sized binary integers.
- * @details Computes the difference between the binary integers pointed to by pptrX and pptrY and stores the result in the location pointed to by pptrZ.
+ * @details Computes the distance between the magnitudes of the binary integers pointed to by pptrX and pptrY with
+ *          mpn_sub and stores the non-negative result in the location pointed to by pptrZ.
  * @param pptrX A double pointer to a BINT representing the minuend.
  * @param pptrY A double pointer to a BINT representing the subtrahend.
- * @param pptrZ A double pointer to a BINT where the result is to be stored.
- * @pre pptrX and pptrY must point to valid BINT objects. pptrZ must be initialized to store the result.
- * @post *pptrZ contains the difference of *pptrX and *pptrY.
+ * @param pptrZ A double pointer to a BINT where the result is to be stored; may be NULL, or alias an operand.
+ * @pre pptrX and pptrY must point to valid BINT objects.
+ * @post *pptrZ contains ||*pptrX| - |*pptrY||; the operands are unchanged unless *pptrZ is one of them.
  * @note Assumes proper BINT structure and memory management.
  */
 void sub_core_xyz(BINT** pptrX, BINT** pptrY, BINT** pptrZ);
@@ -93,12 +96,34 @@ void sub_core_xyz(BINT** pptrX, BINT** pptrY, BINT** pptrZ);
  * @param pptrX A double pointer to a BINT representing the first operand.
  * @param pptrY A double pointer to a BINT representing the second operand.
  * @param pptrZ A double pointer to a BINT where the result should be stored.
- * @pre pptrX and pptrY must point to valid BINT objects. pptrZ must be properly allocated to store the result.
- * @post The result of subtraction is stored in the location pointed to by pptrZ.
+ * @pre pptrX and pptrY must point to valid BINT objects. *pptrZ may be NULL, or one of the operands.
+ * @post The result of subtraction is stored in the location pointed to by pptrZ; the operands are unchanged unless
+ *       *pptrZ is one of them.
  * @note This function may utilize other helper functions for BINT arithmetic and memory management.
  */
 void SUB(BINT** pptrX, BINT** pptrY, BINT** pptrZ);
 
+/**
+ * @brief Adds a binary integer to another in place: X <- X + Y.
+ * @details The words of X are updated where they are and only grow when the sum needs more room, so
+ *          accumulation loops do not build a new result object on every step.
+ * @param pptrX A double pointer to the BINT to be updated.
+ * @param pptrY A double pointer to the BINT to be added; may be the same as pptrX.
+ * @pre pptrX and pptrY must point to valid BINT objects.
+ * @post *pptrX contains the sum; *pptrY is unchanged unless it is *pptrX.
+ */
+void ADD_Inplace(BINT** pptrX, BINT** pptrY);
+
+/**
+ * @brief Subtracts a binary integer from another in place: X <- X - Y.
+ * @details Works like ADD_Inplace.
+ * @param pptrX A double pointer to the BINT to be updated.
+ * @param pptrY A double pointer to the BINT to be subtracted; may be the same as pptrX.
+ * @pre pptrX and pptrY must point to valid BINT objects.
+ * @post *pptrX contains the difference; *pptrY is unchanged unless it is *pptrX.
+ */
+void SUB_Inplace(BINT** pptrX, BINT** pptrY);
+
 /**
  * @brief Multiplies two WORD values and stores the result in a BINT object.
  * @details Performs multiplication of valX and valY, and stores the result in the BINT object pointed to by pptrZ.
@@ -112,33 +137,38 @@ void mul_xyz(WORD valX, WORD valY, BINT** pptrZ);
 
 /**
  * @brief Core multiplication function using the textbook algorithm.
- * @details Multiplies the values in BINT objects pointed to by pptrX and pptrY, stores the result in pptrZ using the textbook multiplication algorithm.
+ * @details Multiplies the values in BINT objects pointed to by pptrX and pptrY, stores the result in pptrZ using the textbook multiplication algorithm
+ *          (mpn_mul_basecase: one multiply-accumulate row per word of Y).
  * @param pptrX A double pointer to the first BINT operand.
  * @param pptrY A double pointer to the second BINT operand.
  * @param pptrZ A double pointer to the BINT object to store the result.
- * @pre pptrX and pptrY must point to valid BINT objects; pptrZ must be initialized.
+ * @pre pptrX and pptrY must point to valid BINT objects; *pptrZ may be NULL, or one of the operands.
  * @post *pptrZ contains the result of the multiplication.
  */
 void mul_core_TxtBk_xyz(BINT** pptrX, BINT** pptrY, BINT** pptrZ);
 
 /**
  * @brief Core multiplication function using the improved textbook algorithm.
- * @details Multiplies BINT objects pointed to by pptrX and pptrY, stores the result in pptrZ using an improved textbook algorithm for efficiency.
+ * @details Multiplies BINT objects pointed to by pptrX and pptrY, stores the result in pptrZ using an improved textbook algorithm for efficiency:
+ *          for each word of Y, the products with the even and the odd words of X fill two carry-free rows that are added whole.
  * @param pptrX A double pointer to the first BINT operand.
  * @param pptrY A double pointer to the second BINT operand.
  * @param pptrZ A double pointer to the BINT object to store the result.
- * @pre pptrX and pptrY must point to valid BINT objects; pptrZ must be initialized.
+ * @pre pptrX and pptrY must point to valid BINT objects; *pptrZ may be NULL, or one of the operands.
  * @post *pptrZ contains the result of the multiplication.
  */
 void MUL_Core_ImpTxtBk_xyz(BINT** pptrX, BINT** pptrY, BINT** pptrZ);
 
 /**
  * @brief Core multiplication function using the Karatsuba algorithm.
- * @details Multiplies BINT objects pointed to by pptrX and pptrY, stores the result in pptrZ using the Karatsuba multiplication algorithm for efficiency.
+ * @details Multiplies BINT objects pointed to by pptrX and pptrY, stores the result in pptrZ using the Karatsuba multiplication algorithm for efficiency
+ *          (mpn_mul, on scratch words taken for the call); operands below mpn_mul_karatsuba_threshold words use the basecase,
+ *          and balanced parts from mpn_mul_toom3_threshold and mpn_mul_toom4_threshold words switch to Toom-3 and Toom-4.
+ *          From mpn_mul_fft_threshold words on, the three-prime NTT multiplies the operands whole.
  * @param pptrX A double pointer to the first BINT operand.
  * @param pptrY A double pointer to the second BINT operand.
  * @param pptrZ A double pointer to the BINT object to store the result.
- * @pre pptrX and pptrY must point to valid BINT objects; pptrZ must be initialized.
+ * @pre pptrX and pptrY must point to valid BINT objects; *pptrZ may be NULL, or one of the operands.
  * @post *pptrZ contains the result of the multiplication.
  */
 void MUL_Core_Krtsb_xyz(BINT** pptrX, BINT** pptrY, BINT** pptrZ);
@@ -158,17 +188,20 @@ void squ_core(WORD valX, BINT** pptrZ);
  * @details Squares the value in the BINT object pointed to by pptrX and stores the result in pptrZ using the textbook squaring algorithm.
  * @param pptrX A double pointer to the BINT object to be squared.
  * @param pptrZ A double pointer to the BINT object where the result will be stored.
- * @pre pptrX must point to a valid BINT object; pptrZ must be initialized.
+ * @pre pptrX must point to a valid BINT object; *pptrZ may be NULL, or the operand.
  * @post *pptrZ contains the result of squaring *pptrX.
  */
 void SQU_TxtBk_xz(BINT** pptrX, BINT** pptrZ);
 
 /**
  * @brief Squares a BINT object using the Karatsuba algorithm.
- * @details Squares the value in the BINT object pointed to by pptrX and stores the result in pptrZ using the Karatsuba squaring algorithm for efficiency.
+ * @details Squares the value in the BINT object pointed to by pptrX and stores the result in pptrZ using the Karatsuba squaring algorithm for efficiency
+ *          (mpn_sqr_n); operands below mpn_sqr_karatsuba_threshold words use the basecase,
+ *          and from mpn_sqr_toom3_threshold and mpn_sqr_toom4_threshold words squaring switches to Toom-3 and Toom-4,
+ *          then from mpn_sqr_fft_threshold words to the NTT, which transforms the operand once.
  * @param pptrX A double pointer to the BINT object to be squared.
  * @param pptrZ A double pointer to the BINT object where the result will be stored.
- * @pre pptrX must point to a valid BINT object; pptrZ must be initialized.
+ * @pre pptrX must point to a valid BINT object; *pptrZ may be NULL, or the operand.
  * @post *pptrZ contains the result of squaring *pptrX.
  */
 void SQU_Krtsb_xz(BINT** pptrX, BINT** pptrZ);
@@ -176,6 +209,8 @@ void SQU_Krtsb_xz(BINT** pptrX, BINT** pptrZ);
 /**
  * @brief Performs binary long division.
  * @details Divides the BINT objects pointed to by pptrDividend and pptrDivisor and stores the quotient and remainder in pptrQ and pptrR, respectively, using the binary long division algorithm.
+ *          It produces one quotient bit per step and is kept as the reference the tests check DIV_Long against;
+ *          the library itself divides with DIV_Long.
  * @param pptrDividend A double pointer to the BINT dividend.
  * @param pptrDivisor A double pointer to the BINT divisor.
  * @param pptrQ A double pointer to the BINT object to store the quotient.
@@ -189,23 +224,73 @@ WORD quotient(WORD dividend1, WORD dividend0, WORD divisor);
 
 /**
  * @brief Performs long division.
- * @details Divides the BINT objects pointed to by pptrDividend and pptrDivisor and stores the quotient and remainder in pptrQ and pptrR, respectively, using the binary long division algorithm.
+ * @details Divides the BINT objects pointed to by pptrDividend and pptrDivisor and stores the quotient and remainder in pptrQ and pptrR, respectively, by Knuth's Algorithm D
+ *          (mpn_div_qr): one quotient word per step, estimated with a precomputed reciprocal of the normalized
+ *          divisor and corrected by at most one add-back, for a cost of about (n - m) * m word products. Large
+ *          divisions, from mpn_div_bz_threshold words on, recurse with Burnikel-Ziegler on top of the Karatsuba,
+ *          Toom and NTT products instead.
  * @param pptrDividend A double pointer to the BINT dividend.
  * @param pptrDivisor A double pointer to the BINT divisor.
  * @param pptrQ A double pointer to the BINT object to store the quotient.
  * @param pptrR A double pointer to the BINT object to store the remainder.
  * @pre pptrDividend and pptrDivisor must point to valid BINT objects; pptrQ and pptrR must be initialized. 
- * @post *pptrQ and *pptrR contain the quotient and remainder of the division, respectively.
- * @note (*pptrDividend)->wordlen = (*pptrDivisor) + 1;
+ * @post *pptrQ and *pptrR contain the quotient and remainder of the division, respectively; the quotient is
+ *       negative when exactly one operand is, and the remainder is that of the magnitudes.
  */
 void DIV_Long(BINT** pptrDividend, BINT** pptrDivisor, BINT** pptrQ, BINT** pptrR);
 
+/**
+ * @struct DivCtx
+ * @brief Precomputed data for dividing many numerators by one divisor d.
+ * @details The divisor is kept shifted left until its top bit is set, together with its Newton reciprocal
+ *          (mpn_invert), so that in the NTT range each block of k quotient words costs two multiplications
+ *          rather than a recursive division. The context is only read after it is created, so
+ *          threads may share one.
+ */
+typedef struct {
+    BINT* ptrDiv;   /**< @brief The divisor d, refined; its sign sets the sign of the quotients. */
+    int wordlen;    /**< @brief k, the number of words of d. */
+    int shift;      /**< @brief s, the left shift that sets the top bit of d's top word. */
+    WORD* d;        /**< @brief |d| << s in k words. */
+    WORD* inv;      /**< @brief mpn_invert(|d| << s) in k words. */
+} DivCtx;
+
+/**
+ * @brief Creates a context for division by the invariant divisor ptrDivisor.
+ * @param pptrCtx A double pointer where the new context will be stored.
+ * @param ptrDivisor A pointer to the divisor.
+ * @pre The divisor must be non-zero; the program exits with an error otherwise.
+ * @post *pptrCtx must be released with delete_div_ctx.
+ */
+void init_div_ctx(DivCtx** pptrCtx, BINT* ptrDivisor);
+
+/**
+ * @brief Deletes a division context.
+ * @param pptrCtx A double pointer to the context; set to NULL afterwards.
+ */
+void delete_div_ctx(DivCtx** pptrCtx);
+
+/**
+ * @brief Divides by the divisor of a DivCtx, with the quotient and remainder of DIV_Long.
+ * @details Runs mpn_div_qr_preinv on the context's reciprocal. Worth it whenever one divisor serves several
+ *          numerators, as in CRT recombination or repeated reduction by one group order.
+ * @param pptrDividend A double pointer to the BINT dividend.
+ * @param pptrQ A double pointer to the BINT object to store the quotient.
+ * @param pptrR A double pointer to the BINT object to store the remainder.
+ * @param ptrCtx A pointer to the division context.
+ * @post *pptrQ and *pptrR are as DIV_Long would leave them for the context's divisor; either may alias the
+ *       dividend.
+ */
+void DIV_Invariant(BINT** pptrDividend, BINT** pptrQ, BINT** pptrR, DivCtx* ptrCtx);
+
 /**
  * @brief Performs left-to-right modular exponentiation on three BINT objects and stores the result in a fourth BINT object.
  * @details This function implements the left-to-right binary method for modular exponentiation. It iteratively computes the result 
  *          of raising the base (pointed to by pptrX) to the power of the exponent (pointed to by pptrY), modulo the modulus 
  *          (pointed to by ptrMod). The result is stored in the BINT object pointed to by pptrZ. This method iterates through the 
  *          bits of the exponent starting from the most significant bit towards the least significant bit.
+ *          Odd moduli are handled with Montgomery arithmetic through EXP_MOD_L2R_Mont, even ones with Barrett
+ *          reduction through EXP_MOD_L2R_Barrett.
  * @param pptrX A double pointer of the base BINT operand.
  * @param pptrY A double pointer of the exponent BINT operand.
  * @param pptrZ A double pointer where the modular exponentiation result will be stored.
@@ -220,6 +305,8 @@ void EXP_MOD_L2R(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BINT* ptrMod);
  *          the base (pointed to by pptrX) to the power of the exponent (pointed to by pptrY), modulo the modulus (pointed to by 
  *          ptrMod), and stores the result in the BINT object pointed to by pptrZ. This method processes the bits of the exponent 
  *          starting from the least significant bit towards the most significant bit, which can be more efficient in certain scenarios.
+ *          Odd moduli are handled with Montgomery arithmetic through EXP_MOD_R2L_Mont, even ones with Barrett
+ *          reduction through EXP_MOD_R2L_Barrett.
  * @param pptrX A double pointer of the base BINT operand.
  * @param pptrY A double pointer of the exponent BINT operand.
  * @param pptrZ A double pointer where the modular exponentiation result will be stored.
@@ -229,7 +316,10 @@ void EXP_MOD_L2R(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BINT* ptrMod);
 void EXP_MOD_R2L(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BINT* ptrMod);
 
 /**
- * @brief Performs modular exponentiation using the Montgomery method on three BINT objects and stores the result in a fourth BINT object.
+ * @brief Performs modular exponentiation using the Montgomery ladder on three BINT objects and stores the result in a fourth BINT object.
+ * @details Every step computes one product and one square whatever the exponent bit is. Despite the name this is the
+ *          ladder; for odd moduli both operations run on Montgomery (REDC) arithmetic through EXP_MOD_Ladder_Mont,
+ *          for even ones on Barrett reduction through EXP_MOD_Ladder_Barrett.
  * @param pptrX A double pointer of the base BINT operand.
  * @param pptrY A double pointer of the exponent BINT operand.
  * @param pptrZ A double pointer where the modular exponentiation result will be stored.
@@ -238,6 +328,174 @@ void EXP_MOD_R2L(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BINT* ptrMod);
  */
 void EXP_MOD_Montgomery(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BINT* ptrMod);
 
+/**
+ * @brief Performs fixed-window (k-ary) modular exponentiation.
+ * @details Precomputes x^0 .. x^(2^w - 1) and then consumes the exponent w bits at a time: w squarings and at most
+ *          one table multiplication per window. The width w is chosen from BIT_LENGTH of the exponent. Odd moduli
+ *          run on EXP_MOD_KAry_Mont, even ones on EXP_MOD_KAry_Barrett.
+ * @param pptrX A double pointer of the base BINT operand.
+ * @param pptrY A double pointer of the exponent BINT operand.
+ * @param pptrZ A double pointer where the modular exponentiation result will be stored.
+ * @param ptrMod A pointer of the modulus BINT operand.
+ */
+void EXP_MOD_KAry(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BINT* ptrMod);
+
+/**
+ * @brief Performs sliding-window modular exponentiation.
+ * @details Precomputes the odd powers x, x^3, .., x^(2^w - 1) and scans the exponent from the top. Zero bits cost
+ *          one squaring each and every window starts and ends on a set bit, so only about bits / (w + 1)
+ *          multiplications remain. The width w is chosen from BIT_LENGTH of the exponent. Odd moduli run on
+ *          EXP_MOD_Sliding_Mont, even ones on EXP_MOD_Sliding_Barrett.
+ * @param pptrX A double pointer of the base BINT operand.
+ * @param pptrY A double pointer of the exponent BINT operand.
+ * @param pptrZ A double pointer where the modular exponentiation result will be stored.
+ * @param ptrMod A pointer of the modulus BINT operand.
+ * @note This is the fastest of the generic EXP_MOD_* routines for long exponents, but its sequence of operations
+ *       depends on the exponent; use EXP_MOD_Montgomery when the exponent is secret.
+ */
+void EXP_MOD_Sliding(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BINT* ptrMod);
+
+/**
+ * @brief Simultaneous multi-exponentiation, Z = prod X_j^(Y_j) mod n.
+ * @details Interleaved sliding windows (Straus, with Moller's interleaving): each base gets its own table of odd
+ *          powers and window width chosen from its exponent, while all bases share one chain of squarings. A product
+ *          g^a * h^b thus costs about max(|a|, |b|) squarings instead of |a| + |b|. Odd moduli run on
+ *          EXP_MOD_Multi_Mont, even ones on EXP_MOD_Multi_Barrett.
+ * @param ptrBases An array of count pointers to the bases.
+ * @param ptrExps An array of count pointers to the non-negative exponents.
+ * @param count The number of base/exponent pairs; 0 yields 1 mod n.
+ * @param pptrZ A double pointer where the product will be stored.
+ * @param ptrMod A pointer of the modulus BINT operand.
+ */
+void EXP_MOD_Multi(BINT** ptrBases, BINT** ptrExps, int count, BINT** pptrZ, BINT* ptrMod);
+
+/**
+ * @struct MontCtx
+ * @brief Precomputed data for Montgomery arithmetic modulo an odd n.
+ * @details With k = n->wordlen and R = 2^(k * WORD_BITLEN), a value a is held in Montgomery form as aR mod n in
+ *          exactly k words. The context owns a scratch buffer, so one context must not be used by two threads at once.
+ */
+typedef struct {
+    BINT* ptrMod;   /**< @brief The odd modulus n, refined. */
+    int wordlen;    /**< @brief k, the number of words of n. */
+    WORD nprime;    /**< @brief n' = -n^(-1) mod 2^WORD_BITLEN. */
+    WORD* R1;       /**< @brief R mod n in k words, the Montgomery form of 1. */
+    WORD* R2;       /**< @brief R^2 mod n in k words, used to enter the Montgomery domain. */
+    WORD* scratch;  /**< @brief 4k + 2 words of workspace: the REDC accumulator and two operand buffers. */
+} MontCtx;
+
+/**
+ * @brief Creates a Montgomery context for an odd modulus.
+ * @details Computes n' by Newton iteration on the lowest word and R mod n, R^2 mod n by modular doubling on words,
+ *          so no multi-precision division is needed.
+ * @param pptrCtx A double pointer where the new context will be stored.
+ * @param ptrMod A pointer to the odd modulus.
+ * @pre The modulus must be odd; the program exits with an error otherwise.
+ * @post *pptrCtx must be released with delete_mont_ctx.
+ */
+void init_mont_ctx(MontCtx** pptrCtx, BINT* ptrMod);
+
+/**
+ * @brief Deletes a Montgomery context.
+ * @param pptrCtx A double pointer to the context; set to NULL afterwards.
+ */
+void delete_mont_ctx(MontCtx** pptrCtx);
+
+/**
+ * @brief Converts a value into Montgomery form, Z = X * R mod n.
+ * @param pptrX A double pointer to the value; any non-negative value is accepted.
+ * @param pptrZ A double pointer where the Montgomery form will be stored.
+ * @param ptrCtx A pointer to the Montgomery context.
+ */
+void MONT_To(BINT** pptrX, BINT** pptrZ, MontCtx* ptrCtx);
+
+/**
+ * @brief Converts a value out of Montgomery form, Z = X * R^(-1) mod n.
+ * @param pptrX A double pointer to a value in Montgomery form.
+ * @param pptrZ A double pointer where the ordinary representative in [0, n) will be stored.
+ * @param ptrCtx A pointer to the Montgomery context.
+ */
+void MONT_From(BINT** pptrX, BINT** pptrZ, MontCtx* ptrCtx);
+
+/**
+ * @brief Montgomery multiplication, Z = X * Y * R^(-1) mod n.
+ * @details Word-level SOS (separated operand scanning): the 2k-word product from mpn_mul_basecase is reduced by
+ *          k mpn_addmul_1 rows of REDC, each clearing one low word.
+ * @param pptrX A double pointer to the first operand in Montgomery form.
+ * @param pptrY A double pointer to the second operand in Montgomery form.
+ * @param pptrZ A double pointer where the product in Montgomery form will be stored; may alias an operand.
+ * @param ptrCtx A pointer to the Montgomery context.
+ * @pre The operands must be below n and have at most k words.
+ */
+void MONT_Mul(BINT** pptrX, BINT** pptrY, BINT** pptrZ, MontCtx* ptrCtx);
+
+/**
+ * @brief Montgomery squaring, Z = X^2 * R^(-1) mod n.
+ * @details Forms the full square with each cross product computed once, then applies word-level REDC.
+ * @param pptrX A double pointer to the operand in Montgomery form.
+ * @param pptrZ A double pointer where the square in Montgomery form will be stored; may alias the operand.
+ * @param ptrCtx A pointer to the Montgomery context.
+ * @pre The operand must be below n and have at most k words.
+ */
+void MONT_Sqr(BINT** pptrX, BINT** pptrZ, MontCtx* ptrCtx);
+
+/**
+ * @brief Left-to-right modular exponentiation on a Montgomery context.
+ * @details Same schedule as EXP_MOD_L2R. The base is converted once, all products and squares are REDC operations,
+ *          and the result is converted back. Reusing the context across calls saves its setup.
+ * @param pptrX A double pointer of the base BINT operand.
+ * @param pptrY A double pointer of the exponent BINT operand.
+ * @param pptrZ A double pointer where X^Y mod n will be stored.
+ * @param ptrCtx A pointer to the Montgomery context of n.
+ */
+void EXP_MOD_L2R_Mont(BINT** pptrX, BINT** pptrY, BINT** pptrZ, MontCtx* ptrCtx);
+
+/**
+ * @brief Right-to-left modular exponentiation on a Montgomery context.
+ * @param pptrX A double pointer of the base BINT operand.
+ * @param pptrY A double pointer of the exponent BINT operand.
+ * @param pptrZ A double pointer where X^Y mod n will be stored.
+ * @param ptrCtx A pointer to the Montgomery context of n.
+ */
+void EXP_MOD_R2L_Mont(BINT** pptrX, BINT** pptrY, BINT** pptrZ, MontCtx* ptrCtx);
+
+/**
+ * @brief Montgomery-ladder modular exponentiation on a Montgomery context.
+ * @param pptrX A double pointer of the base BINT operand.
+ * @param pptrY A double pointer of the exponent BINT operand.
+ * @param pptrZ A double pointer where X^Y mod n will be stored.
+ * @param ptrCtx A pointer to the Montgomery context of n.
+ */
+void EXP_MOD_Ladder_Mont(BINT** pptrX, BINT** pptrY, BINT** pptrZ, MontCtx* ptrCtx);
+
+/**
+ * @brief Fixed-window (k-ary) modular exponentiation on a Montgomery context.
+ * @param pptrX A double pointer of the base BINT operand.
+ * @param pptrY A double pointer of the exponent BINT operand.
+ * @param pptrZ A double pointer where X^Y mod n will be stored.
+ * @param ptrCtx A pointer to the Montgomery context of n.
+ */
+void EXP_MOD_KAry_Mont(BINT** pptrX, BINT** pptrY, BINT** pptrZ, MontCtx* ptrCtx);
+
+/**
+ * @brief Sliding-window modular exponentiation on a Montgomery context.
+ * @param pptrX A double pointer of the base BINT operand.
+ * @param pptrY A double pointer of the exponent BINT operand.
+ * @param pptrZ A double pointer where X^Y mod n will be stored.
+ * @param ptrCtx A pointer to the Montgomery context of n.
+ */
+void EXP_MOD_Sliding_Mont(BINT** pptrX, BINT** pptrY, BINT** pptrZ, MontCtx* ptrCtx);
+
+/**
+ * @brief Simultaneous multi-exponentiation on a Montgomery context, Z = prod X_j^(Y_j) mod n.
+ * @param ptrBases An array of count pointers to the bases.
+ * @param ptrExps An array of count pointers to the non-negative exponents.
+ * @param count The number of base/exponent pairs.
+ * @param pptrZ A double pointer where the product will be stored.
+ * @param ptrCtx A pointer to the Montgomery context of n.
+ */
+void EXP_MOD_Multi_Mont(BINT** ptrBases, BINT** ptrExps, int count, BINT** pptrZ, MontCtx* ptrCtx);
+
 /**
  * @brief Test Function for Barrett Reduction (Not pre-computation)
  * @details This function is designed to test the correctness and functionality of the Barrett Reduction algorithm. 
@@ -268,11 +526,220 @@ void Barrett_Reduction_TEST(BINT** pptrX, BINT** pptrN, BINT** pptrR);
  */
 void Barrett_Reduction(BINT** pptrX, BINT** pptrN, BINT** pptrR, BINT** pptrPreT);
 
+/**
+ * @struct BarrettCtx
+ * @brief Precomputed data for Barrett reduction modulo any non-zero n.
+ * @details With k = n->wordlen and W = 2^WORD_BITLEN, mu = floor(W^(2k) / n) is computed once when the context is
+ *          created, so each reduction costs two partial products instead of a division. Values are plain residues
+ *          in k words. The context owns a scratch buffer, so one context must not be used by two threads at once.
+ */
+typedef struct {
+    BINT* ptrMod;   /**< @brief The modulus n, refined and non-negative. */
+    int wordlen;    /**< @brief k, the number of words of n. */
+    WORD* mu;       /**< @brief floor(W^(2k) / n) in k + 2 words. */
+    WORD* one;      /**< @brief 1 mod n in k words. */
+    WORD* scratch;  /**< @brief 7k + 5 words of workspace: the product, the two partial products and two operand buffers. */
+} BarrettCtx;
+
+/**
+ * @brief Creates a Barrett context.
+ * @details Computes mu with a single long division; every later reduction reuses it.
+ * @param pptrCtx A double pointer where the new context will be stored.
+ * @param ptrMod A pointer to the modulus; its sign is ignored.
+ * @pre The modulus must be non-zero; the program exits with an error otherwise.
+ * @post *pptrCtx must be released with delete_barrett_ctx.
+ */
+void init_barrett_ctx(BarrettCtx** pptrCtx, BINT* ptrMod);
+
+/**
+ * @brief Deletes a Barrett context.
+ * @param pptrCtx A double pointer to the context; set to NULL afterwards.
+ */
+void delete_barrett_ctx(BarrettCtx** pptrCtx);
+
+/**
+ * @brief Barrett reduction, Z = X mod n.
+ * @details Follows HAC Algorithm 14.42: q1 * mu is formed only from the columns that can reach the quotient
+ *          estimate and q3 * n only up to word k, then a few subtractions of n finish the job. Inputs longer than
+ *          2k words fall back to a long division.
+ * @param pptrX A double pointer to the non-negative value to reduce.
+ * @param pptrZ A double pointer where the residue in [0, n) will be stored; may alias the operand.
+ * @param ptrCtx A pointer to the Barrett context.
+ */
+void BARRETT_Reduce(BINT** pptrX, BINT** pptrZ, BarrettCtx* ptrCtx);
+
+/**
+ * @brief Modular multiplication with Barrett reduction, Z = X * Y mod n.
+ * @param pptrX A double pointer to the first operand.
+ * @param pptrY A double pointer to the second operand.
+ * @param pptrZ A double pointer where the product in [0, n) will be stored; may alias an operand.
+ * @param ptrCtx A pointer to the Barrett context.
+ * @pre The operands must be non-negative. Operands of at most k significant words are used as they are; wider
+ *      ones are reduced first.
+ */
+void BARRETT_Mul(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BarrettCtx* ptrCtx);
+
+/**
+ * @brief Modular squaring with Barrett reduction, Z = X^2 mod n.
+ * @details Forms the square with each cross product computed once before reducing.
+ * @param pptrX A double pointer to the operand.
+ * @param pptrZ A double pointer where the square in [0, n) will be stored; may alias the operand.
+ * @param ptrCtx A pointer to the Barrett context.
+ * @pre The operand must be non-negative; operands wider than k significant words are reduced first.
+ */
+void BARRETT_Sqr(BINT** pptrX, BINT** pptrZ, BarrettCtx* ptrCtx);
+
+/**
+ * @brief Left-to-right modular exponentiation on a Barrett context.
+ * @details Same schedule as EXP_MOD_L2R_Mont, with every product and square reduced by BARRETT_Reduce's
+ *          word-level core. Works for even moduli, where Montgomery arithmetic does not apply.
+ * @param pptrX A double pointer of the base BINT operand.
+ * @param pptrY A double pointer of the exponent BINT operand.
+ * @param pptrZ A double pointer where X^Y mod n will be stored.
+ * @param ptrCtx A pointer to the Barrett context of n.
+ */
+void EXP_MOD_L2R_Barrett(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BarrettCtx* ptrCtx);
+
+/**
+ * @brief Right-to-left modular exponentiation on a Barrett context.
+ * @param pptrX A double pointer of the base BINT operand.
+ * @param pptrY A double pointer of the exponent BINT operand.
+ * @param pptrZ A double pointer where X^Y mod n will be stored.
+ * @param ptrCtx A pointer to the Barrett context of n.
+ */
+void EXP_MOD_R2L_Barrett(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BarrettCtx* ptrCtx);
+
+/**
+ * @brief Montgomery-ladder modular exponentiation on a Barrett context.
+ * @param pptrX A double pointer of the base BINT operand.
+ * @param pptrY A double pointer of the exponent BINT operand.
+ * @param pptrZ A double pointer where X^Y mod n will be stored.
+ * @param ptrCtx A pointer to the Barrett context of n.
+ */
+void EXP_MOD_Ladder_Barrett(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BarrettCtx* ptrCtx);
+
+/**
+ * @brief Fixed-window (k-ary) modular exponentiation on a Barrett context.
+ * @param pptrX A double pointer of the base BINT operand.
+ * @param pptrY A double pointer of the exponent BINT operand.
+ * @param pptrZ A double pointer where X^Y mod n will be stored.
+ * @param ptrCtx A pointer to the Barrett context of n.
+ */
+void EXP_MOD_KAry_Barrett(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BarrettCtx* ptrCtx);
+
+/**
+ * @brief Sliding-window modular exponentiation on a Barrett context.
+ * @param pptrX A double pointer of the base BINT operand.
+ * @param pptrY A double pointer of the exponent BINT operand.
+ * @param pptrZ A double pointer where X^Y mod n will be stored.
+ * @param ptrCtx A pointer to the Barrett context of n.
+ */
+void EXP_MOD_Sliding_Barrett(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BarrettCtx* ptrCtx);
+
+/**
+ * @brief Simultaneous multi-exponentiation on a Barrett context, Z = prod X_j^(Y_j) mod n.
+ * @param ptrBases An array of count pointers to the bases.
+ * @param ptrExps An array of count pointers to the non-negative exponents.
+ * @param count The number of base/exponent pairs.
+ * @param pptrZ A double pointer where the product will be stored.
+ * @param ptrCtx A pointer to the Barrett context of n.
+ */
+void EXP_MOD_Multi_Barrett(BINT** ptrBases, BINT** ptrExps, int count, BINT** pptrZ, BarrettCtx* ptrCtx);
+
+/**
+ * @def FB_DEFAULT_WIDTH
+ * @brief Digit width used by init_fixed_base when the caller passes 0.
+ */
+#define FB_DEFAULT_WIDTH 4
+
+/**
+ * @def FB_MAX_WIDTH
+ * @brief Largest digit width accepted by init_fixed_base; the table grows as 2^width per window.
+ */
+#define FB_MAX_WIDTH 8
+
+/**
+ * @struct FixedBase
+ * @brief Precomputed powers of one base g modulo n for fixed-base exponentiation.
+ * @details Writes exponents in radix 2^w and stores g^(d * 2^(i * w)) for every window i and digit 1 <= d < 2^w
+ *          (the BGMW table). g^y is then the product of one entry per non-zero digit of y, with no squarings.
+ *          Entries are kept in the representation of the modulus' context: Montgomery form for odd n, plain
+ *          residues for even n. The table is read-only after creation, so one table may serve many threads.
+ */
+typedef struct {
+    BINT* ptrMod;               /**< @brief The modulus n, refined and non-negative. */
+    BINT* ptrBase;              /**< @brief The base g reduced mod n. */
+    MontCtx* ptrMont;           /**< @brief The Montgomery context for odd n, or NULL. */
+    BarrettCtx* ptrBarrett;     /**< @brief The Barrett context for even n, or NULL. */
+    int wordlen;                /**< @brief k, the number of words of n and of every entry. */
+    int width;                  /**< @brief The digit width w in bits. */
+    int max_bits;               /**< @brief The longest exponent covered by the table. */
+    int windows;                /**< @brief ceil(max_bits / w), the number of digit positions. */
+    WORD* table;                /**< @brief windows * (2^w - 1) entries of k words, window-major. */
+} FixedBase;
+
+/**
+ * @brief Builds a fixed-base table for g modulo n.
+ * @details Costs one modular multiplication per entry, windows * (2^w - 1) in total, and as many entries of k words
+ *          of memory. It pays off once the same base is raised to more than a handful of exponents.
+ * @param pptrFB A double pointer where the new table will be stored.
+ * @param pptrG A double pointer to the base; it is reduced mod n.
+ * @param ptrMod A pointer to the modulus; its sign is ignored.
+ * @param max_bits The bit length of the longest exponent the table must cover, e.g. BIT_LENGTH of the group order.
+ * @param width The digit width w in [1, FB_MAX_WIDTH], or 0 for FB_DEFAULT_WIDTH.
+ * @pre The modulus must be non-zero and max_bits positive; the program exits with an error otherwise.
+ * @post *pptrFB must be released with delete_fixed_base.
+ */
+void init_fixed_base(FixedBase** pptrFB, BINT** pptrG, BINT* ptrMod, int max_bits, int width);
+
+/**
+ * @brief Deletes a fixed-base table.
+ * @param pptrFB A double pointer to the table; set to NULL afterwards.
+ */
+void delete_fixed_base(FixedBase** pptrFB);
+
+/**
+ * @brief Fixed-base modular exponentiation, Z = g^Y mod n.
+ * @details Multiplies one table entry per non-zero digit of Y, about max_bits / w multiplications and no squarings.
+ *          Exponents longer than max_bits fall back to a sliding-window exponentiation of g. Safe to call from
+ *          several threads on the same table.
+ * @param ptrFB A pointer to the table of g.
+ * @param pptrY A double pointer of the non-negative exponent.
+ * @param pptrZ A double pointer where g^Y mod n will be stored.
+ */
+void EXP_MOD_FixedBase(FixedBase* ptrFB, BINT** pptrY, BINT** pptrZ);
+
+/**
+ * @brief Saves a fixed-base table to a text file.
+ * @details The file holds n, g, the width and max_bits, then every entry as an ordinary residue in hexadecimal, so
+ *          it does not depend on WORD_BITLEN.
+ * @param ptrFB A pointer to the table.
+ * @param path The file to write.
+ * @return true on success, false if the file cannot be written.
+ */
+bool FB_Save(FixedBase* ptrFB, const char* path);
+
+/**
+ * @brief Loads a fixed-base table written by FB_Save.
+ * @details Rebuilds the context of n and converts the entries back into its representation; no entry has to be
+ *          recomputed. The first entry is checked against g.
+ * @param pptrFB A double pointer where the table will be stored; NULL on failure.
+ * @param path The file to read.
+ * @return true on success, false if the file is missing or malformed.
+ */
+bool FB_Load(FixedBase** pptrFB, const char* path);
+
 
 /**
  * @brief Executes the Extended Euclidean Algorithm.
  * @details Implements the Extended Euclidean Algorithm to compute the coefficients of Bézout's identity and the greatest common divisor (GCD) of two numbers.
  *          This algorithm finds integers x and y (Bézout coefficients) such that ax + by = gcd(a, b), where a and b are the input numbers represented as hexadecimal integers (BINTs).
+ *
+ *          The Euclid steps on |a| and |b| are decided from their leading words in runs (Lehmer, see mpn_gcd_lehmer), each applied to
+ *          the operands in one pass and kept as a 2x2 matrix of cofactors; only the cofactor of a is carried, and the other follows
+ *          from it with one exact division at the end. From mpn_hgcd_threshold words on, the operands are first reduced by the half-GCD
+ *          recursion, which finds the steps that halve them from their top halves and applies them with matrix products, so the
+ *          cost follows that of multiplication, about M(n) log n, rather than n^2. Signed operands give gcd(|a|, |b|) >= 0.
  * @param pptrX A double pointer to the first BINT, representing 'a'.
  * @param pptrY A double pointer to the second BINT, representing 'b'.
  * @param pptrS A double pointer to store the Bézout coefficient corresponding to 'a'.
@@ -285,4 +752,31 @@ void Barrett_Reduction(BINT** pptrX, BINT** pptrN, BINT** pptrR, BINT** pptrPreT
  */
 void EEA(BINT** pptrX, BINT** pptrY, BINT** pptrS, BINT** pptrT, BINT** pptrGCD);
 
+/**
+ * @brief Computes the greatest common divisor of two numbers by Stein's binary algorithm.
+ * @details Works on the words of |X| and |Y| with one scratch allocation, shifting and subtracting instead of
+ *          dividing; see mpn_gcd_binary. Its running time depends on the operands, so it is meant for public
+ *          values, and it gives no Bézout coefficients, for which EEA is the routine. Up to about 512 bits it is
+ *          faster than EEA; beyond that, the Lehmer steps of EEA remove more bits per pass over the words.
+ * @param pptrX A double pointer to the first BINT.
+ * @param pptrY A double pointer to the second BINT.
+ * @param pptrGCD A double pointer where gcd(|X|, |Y|) will be stored; may be X or Y. gcd(0, 0) = 0.
+ */
+void GCD_Binary(BINT** pptrX, BINT** pptrY, BINT** pptrGCD);
+
+/**
+ * @brief Computes X^(-1) mod n in time that does not depend on X.
+ * @details Bernstein-Yang safegcd, see mpn_sec_invert: a fixed number of divstep batches for the bit length of n,
+ *          with masks instead of branches and one scratch allocation, so that it can serve secret values where
+ *          the division loop of EEA would leak them through its timing.
+ * @param pptrX A double pointer to the value to invert, in [0, n). Its words are read up to its wordlen, at
+ *              most the k words of n, and its sign is ignored; reduce it beforehand and pad it to k words so
+ *              that neither its value nor its length shows in the timing. The range is not checked.
+ * @param pptrZ A double pointer where the inverse, in [0, n), will be stored as k words, top zero words
+ *              included (not refined); may be X.
+ * @param ptrMod The modulus n, odd and positive.
+ * @return true if gcd(X, n) = 1; otherwise Z holds no inverse.
+ */
+bool INV_MOD_SafeGCD(BINT** pptrX, BINT** pptrZ, BINT* ptrMod);
+
 #endif // _ARITHMETIC_H
\ No newline at end of file
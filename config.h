@@ -63,8 +63,16 @@ typedef unsigned long long u64;
 /**
  * @def WORD_BITLEN
  * @brief Define the size of a word in bits for BigInteger implementation.
+ * @details Native 64-bit words are the default wherever the compiler has unsigned __int128 for their full
+ *          products, 32-bit words elsewhere. A build can pick 8, 32 or 64 with -DWORD_BITLEN=...
  */
+#ifndef WORD_BITLEN
+#if defined(__SIZEOF_INT128__)
+#define WORD_BITLEN 64
+#else
 #define WORD_BITLEN 32
+#endif
+#endif
 
 // Conditional compilation based on the word size for data type flexibility
 #if WORD_BITLEN == 8
@@ -73,17 +81,30 @@ typedef unsigned long long u64;
  * @brief Type definition for WORD as an unsigned 8-bit integer when using 8-bit words.
  */
 typedef u8 WORD;
+/**
+ * @typedef DWORD
+ * @brief Double-word type holding the full product of two 8-bit words.
+ */
+typedef u32 DWORD;
 /**
  * @def WORD_ONE
  * @brief Define WORD_ONE as 1 in an 8-bit representation.
  */
 #define WORD_ONE 0x01
 #elif WORD_BITLEN == 64
+#if !defined(__SIZEOF_INT128__)
+#error "64-bit words need unsigned __int128 for their double-word products"
+#endif
 /**
  * @typedef WORD
  * @brief Type definition for WORD as an unsigned 64-bit integer when using 64-bit words.
  */
 typedef u64 WORD;
+/**
+ * @typedef DWORD
+ * @brief Double-word type holding the full product of two 64-bit words.
+ */
+typedef unsigned __int128 DWORD;
 /**
  * @def WORD_ONE
  * @brief Define WORD_ONE as 1 in a 64-bit representation.
@@ -95,6 +116,11 @@ typedef u64 WORD;
  * @brief Type definition for WORD as an unsigned 32-bit integer for the default word size.
  */
 typedef u32 WORD;
+/**
+ * @typedef DWORD
+ * @brief Double-word type holding the full product of two 32-bit words.
+ */
+typedef u64 DWORD;
 /**
  * @def WORD_ONE
  * @brief Define WORD_ONE as 1 in a 32-bit representation.
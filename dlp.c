@@ -0,0 +1,1606 @@
+/**
+ * @file dlp.c
+ * @brief Implementation of discrete logarithm solvers.
+ *
+ * This file contains the implementation of the discrete logarithm solvers
+ * declared in dlp.h. All group operations are multiplications modulo p on
+ * BINT objects, using the arithmetic provided by arithmetic.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+#include "dlp.h"
+#include "hash/hash.h"
+
+// Z <- X * Y mod p
+static void mul_mod(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BINT* ptrMod) {
+    BINT* ptrXY = NULL;
+    BINT* ptrQ = NULL;
+    MUL_Core_ImpTxtBk_xyz(pptrX, pptrY, &ptrXY);
+    DIV_Long(&ptrXY, &ptrMod, &ptrQ, pptrZ);
+    delete_bint(&ptrXY);
+    delete_bint(&ptrQ);
+}
+
+// Value equality that ignores leading zero words and never resizes its operands
+static bool equal_bint(BINT* ptrX, BINT* ptrY) {
+    int len = MAXIMUM(ptrX->wordlen, ptrY->wordlen);
+    for (int i = 0; i < len; i++) {
+        if (GET_WORD(ptrX, i) != GET_WORD(ptrY, i))
+            return false;
+    }
+    return isZero(ptrX) || ptrX->sign == ptrY->sign;
+}
+
+// Z <- X - Y mod n for X, Y in [0, n)
+static void sub_mod(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BINT* ptrMod) {
+    BINT* ptrT = NULL;
+    SUB(pptrX, pptrY, &ptrT);
+    if (ptrT->sign && !isZero(ptrT)) {
+        ptrT->sign = false;
+        SUB(&ptrMod, &ptrT, pptrZ);
+    } else {
+        ptrT->sign = false;
+        copyBINT(pptrZ, &ptrT);
+    }
+    refineBINT(*pptrZ);
+    refineBINT(ptrMod);
+    delete_bint(&ptrT);
+}
+
+// Z <- X^(-1) mod n, false if gcd(X, n) != 1
+static bool inv_mod(BINT** pptrX, BINT** pptrZ, BINT* ptrMod) {
+    BINT *ptrS = NULL, *ptrT = NULL, *ptrGCD = NULL, *ptrQ = NULL;
+    EEA(pptrX, &ptrMod, &ptrS, &ptrT, &ptrGCD);
+    refineBINT(ptrGCD);
+    bool ok = isOne(ptrGCD);
+    if (ok) {
+        // s may be negative: reduce |s| and reflect it back into [0, n)
+        bool neg = ptrS->sign;
+        ptrS->sign = false;
+        DIV_Long(&ptrS, &ptrMod, &ptrQ, pptrZ);
+        if (neg && !isZero(*pptrZ)) {
+            SUB(&ptrMod, pptrZ, &ptrT);
+            copyBINT(pptrZ, &ptrT);
+        }
+        refineBINT(*pptrZ);
+    }
+    delete_bint(&ptrS); delete_bint(&ptrT);
+    delete_bint(&ptrGCD); delete_bint(&ptrQ);
+    return ok;
+}
+
+// Per-thread xorshift64* generator; rand() is shared state and not meant for threads
+static u64 next_random(u64* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+
+// Z <- random value in [0, n)
+static void random_mod(BINT** pptrZ, BINT* ptrMod, u64* state) {
+    BINT* ptrR = NULL;
+    BINT* ptrQ = NULL;
+    init_bint(&ptrR, ptrMod->wordlen + 1);
+    for (int i = 0; i < ptrR->wordlen; i++)
+        ptrR->val[i] = (WORD)next_random(state);
+    DIV_Long(&ptrR, &ptrMod, &ptrQ, pptrZ);
+    delete_bint(&ptrR);
+    delete_bint(&ptrQ);
+}
+
+// Copies the low wordlen words of X into dst, zero-padded
+static void pack_words(WORD* dst, BINT* ptrX, int wordlen) {
+    for (int i = 0; i < wordlen; i++)
+        dst[i] = GET_WORD(ptrX, i);
+}
+
+static void unpack_words(BINT** pptrZ, const WORD* src, int wordlen) {
+    init_bint(pptrZ, wordlen);
+    memcpy((*pptrZ)->val, src, wordlen * sizeof(WORD));
+    refineBINT(*pptrZ);
+}
+
+#define U64_WORDS ((64 + WORD_BITLEN - 1) / WORD_BITLEN)
+
+static void pack_u64(WORD* dst, u64 value) {
+    for (int i = 0; i < U64_WORDS; i++) {
+        dst[i] = (WORD)value;
+        value = (value >> (WORD_BITLEN / 2)) >> (WORD_BITLEN - WORD_BITLEN / 2);   // by halves: 64-bit words shift it all out
+    }
+}
+
+static u64 unpack_u64(const WORD* src) {
+    u64 value = 0;
+    for (int i = 0; i < U64_WORDS; i++)
+        value |= (u64)src[i] << (i * WORD_BITLEN);
+    return value;
+}
+
+static int online_cores(void) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (int)cores : 1;
+}
+
+// Smallest s with s * s >= n
+static u64 isqrt_ceil(u64 n) {
+    u64 lo = 0, hi = 0xFFFFFFFFULL;
+    while (lo < hi) {
+        u64 mid = lo + (hi - lo) / 2;
+        if (mid * mid >= n)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo;
+}
+
+bool DLP_BSGS(BINT** pptrG, BINT** pptrH, BINT** pptrX, BINT* ptrMod, BINT* ptrOrder, size_t mem_budget) {
+    CHECK_PTR_AND_DEREF(pptrG, "pptrG", "DLP_BSGS");
+    CHECK_PTR_AND_DEREF(pptrH, "pptrH", "DLP_BSGS");
+    CHECK_PTR_AND_DEREF(&ptrMod, "ptrMod", "DLP_BSGS");
+    CHECK_PTR_AND_DEREF(&ptrOrder, "ptrOrder", "DLP_BSGS");
+    if (isZero(ptrOrder) || BIT_LENGTH(ptrOrder) > 64) {
+        fprintf(stderr, "Error: order must be in [1, 2^64) in 'DLP_BSGS'\n");
+        return false;
+    }
+    u64 order = get_bint_u64(ptrOrder);
+
+    // The table is the largest power of two inside the budget and at most half full
+    size_t capacity = 2;
+    while (capacity <= mem_budget / sizeof(u64) / 2)
+        capacity <<= 1;
+    u64 m = isqrt_ceil(order);
+    if (m > capacity / 2) m = capacity / 2;
+    if (m > RESIDUE_INDEX_MAX) m = RESIDUE_INDEX_MAX;
+    if (m == 0) m = 1;
+    u64 giant = order / m + (order % m != 0);
+
+    BINT* ptrE = NULL;
+    BINT* ptrTmp = NULL;
+    BINT* ptrQ = NULL;
+    BINT* ptrFactor = NULL;
+    BINT* ptrGamma = NULL;
+    BINT* ptrTarget = NULL;
+    BarrettCtx* ptrCtx = NULL;
+    init_barrett_ctx(&ptrCtx, ptrMod);
+
+    // Baby steps: g^j for 0 <= j < m
+    residue_table* table = create_residue_table(2 * m);
+    set_bint_u64(&ptrE, 1);
+    for (u64 j = 0; j < m; j++) {
+        residue_insert(table, hash_residue(ptrE->val, ptrE->wordlen), j);
+        BARRETT_Mul(&ptrE, pptrG, &ptrTmp, ptrCtx);
+        swapBINT(&ptrE, &ptrTmp);
+    }
+
+    // Giant step factor g^(-m) = g^(order - m mod order)
+    set_bint_u64(&ptrTmp, order - (m % order));
+    EXP_MOD_Sliding(pptrG, &ptrTmp, &ptrFactor, ptrMod);
+
+    DIV_Long(pptrH, &ptrMod, &ptrQ, &ptrTarget);
+    copyBINT(&ptrGamma, &ptrTarget);
+
+    bool found = false;
+    for (u64 i = 0; i < giant && !found; i++) {
+        u64 hash = hash_residue(ptrGamma->val, ptrGamma->wordlen);
+        size_t cursor = 0;
+        u64 j;
+        while (residue_search(table, hash, &cursor, &j)) {
+            // A fingerprint hit is only a candidate: confirm g^x = h
+            u64 x = i * m + j;
+            if (x < j || x >= order)
+                continue;
+            set_bint_u64(&ptrTmp, x);
+            EXP_MOD_Sliding(pptrG, &ptrTmp, &ptrE, ptrMod);
+            if (equal_bint(ptrE, ptrTarget)) {
+                copyBINT(pptrX, &ptrTmp);
+                found = true;
+                break;
+            }
+        }
+        BARRETT_Mul(&ptrGamma, &ptrFactor, &ptrTmp, ptrCtx);
+        swapBINT(&ptrGamma, &ptrTmp);
+    }
+
+    delete_residue_table(&table);
+    delete_barrett_ctx(&ptrCtx);
+    delete_bint(&ptrE);
+    delete_bint(&ptrTmp);
+    delete_bint(&ptrQ);
+    delete_bint(&ptrFactor);
+    delete_bint(&ptrGamma);
+    delete_bint(&ptrTarget);
+    return found;
+}
+
+/*
+ * Pollard rho
+ */
+
+#define WALK_RUNNING 0
+#define WALK_SOLVED  1
+#define WALK_FAILED  2
+
+typedef struct {
+    BINT* ptrG; BINT* ptrH;
+    BINT* ptrMod; BINT* ptrOrder;
+    BINT* ptrM[RHO_ADDING_WALK];        // M_k = g^c_k * h^d_k
+    BINT* ptrC[RHO_ADDING_WALK];
+    BINT* ptrD[RHO_ADDING_WALK];
+    FixedBase* ptrFG;                   // fixed-base tables of g and h for the walk starts
+    FixedBase* ptrFH;
+    int dp_bits;
+    u64 max_walk;
+    int point_words, scalar_words;
+    dp_table* table;
+    atomic_int status;
+    BINT* ptrX;
+    u64 seed;
+} rho_shared;
+
+typedef struct {
+    rho_shared* shared;
+    int id;
+} rho_worker_arg;
+
+// Z <- Z + sum_k cnt[k] * C[k] mod n, then clears cnt
+static void rho_fold(BINT** pptrZ, BINT** ptrC, u64* cnt, BINT* ptrMod) {
+    BINT *ptrK = NULL, *ptrT = NULL, *ptrS = NULL, *ptrQ = NULL;
+    for (int k = 0; k < RHO_ADDING_WALK; k++) {
+        if (!cnt[k])
+            continue;
+        set_bint_u64(&ptrK, cnt[k]);
+        MUL_Core_ImpTxtBk_xyz(&ptrK, &ptrC[k], &ptrT);
+        add_core_xyz(pptrZ, &ptrT, &ptrS);
+        swapBINT(pptrZ, &ptrS);
+    }
+    DIV_Long(pptrZ, &ptrMod, &ptrQ, &ptrS);
+    swapBINT(pptrZ, &ptrS);
+    delete_bint(&ptrK); delete_bint(&ptrT);
+    delete_bint(&ptrS); delete_bint(&ptrQ);
+}
+
+// x <- (a - a') / (b' - b) mod n for g^a h^b = g^a' h^b', confirmed against h
+static bool rho_solve(BINT** pptrA, BINT** pptrB, const WORD* other, BINT** pptrG, BINT** pptrH,
+                      BINT* ptrMod, BINT* ptrOrder, int scalar_words, BINT** pptrX) {
+    BINT *ptrA2 = NULL, *ptrB2 = NULL, *ptrDa = NULL, *ptrDb = NULL, *ptrInv = NULL, *ptrT = NULL;
+    unpack_words(&ptrA2, other, scalar_words);
+    unpack_words(&ptrB2, other + scalar_words, scalar_words);
+
+    bool ok = false;
+    sub_mod(&ptrB2, pptrB, &ptrDb, ptrOrder);
+    if (!isZero(ptrDb) && inv_mod(&ptrDb, &ptrInv, ptrOrder)) {
+        sub_mod(pptrA, &ptrA2, &ptrDa, ptrOrder);
+        mul_mod(&ptrDa, &ptrInv, pptrX, ptrOrder);
+        EXP_MOD_Sliding(pptrG, pptrX, &ptrT, ptrMod);
+        ok = equal_bint(ptrT, *pptrH);
+    }
+    delete_bint(&ptrA2); delete_bint(&ptrB2);
+    delete_bint(&ptrDa); delete_bint(&ptrDb);
+    delete_bint(&ptrInv); delete_bint(&ptrT);
+    return ok;
+}
+
+static void* rho_worker(void* arg) {
+    rho_shared* sh = ((rho_worker_arg*)arg)->shared;
+    u64 state = sh->seed ^ (0x9e3779b97f4a7c15ULL * (u64)(((rho_worker_arg*)arg)->id + 1));
+    if (!state) state = 1;
+
+    // Thread-local copies: the arithmetic kernels resize their operands in place
+    BINT *ptrG = NULL, *ptrH = NULL, *ptrMod = NULL, *ptrN = NULL;
+    BINT* ptrM[RHO_ADDING_WALK] = { NULL };
+    BINT* ptrC[RHO_ADDING_WALK] = { NULL };
+    BINT* ptrD[RHO_ADDING_WALK] = { NULL };
+    copyBINT(&ptrG, &sh->ptrG); copyBINT(&ptrH, &sh->ptrH);
+    copyBINT(&ptrMod, &sh->ptrMod); copyBINT(&ptrN, &sh->ptrOrder);
+    for (int k = 0; k < RHO_ADDING_WALK; k++) {
+        copyBINT(&ptrM[k], &sh->ptrM[k]);
+        copyBINT(&ptrC[k], &sh->ptrC[k]);
+        copyBINT(&ptrD[k], &sh->ptrD[k]);
+    }
+
+    BINT *ptrX = NULL, *ptrA = NULL, *ptrB = NULL;
+    BINT *ptrT = NULL, *ptrU = NULL;
+    BarrettCtx* ptrCtx = NULL;
+    init_barrett_ctx(&ptrCtx, ptrMod);
+    u64 cnt[RHO_ADDING_WALK];
+    int record_words = sh->point_words + 2 * sh->scalar_words;
+    WORD* record = malloc(record_words * sizeof(WORD));
+    exit_on_null_error(record, "record", "rho_worker");
+    u64 dp_mask = (1ULL << sh->dp_bits) - 1;
+
+    while (atomic_load_explicit(&sh->status, memory_order_relaxed) == WALK_RUNNING) {
+        // Fresh walk from X = g^a * h^b
+        random_mod(&ptrA, ptrN, &state);
+        random_mod(&ptrB, ptrN, &state);
+        EXP_MOD_FixedBase(sh->ptrFG, &ptrA, &ptrT);
+        EXP_MOD_FixedBase(sh->ptrFH, &ptrB, &ptrU);
+        mul_mod(&ptrT, &ptrU, &ptrX, ptrMod);
+        memset(cnt, 0, sizeof(cnt));
+
+        u64 steps = 0;
+        while (steps <= sh->max_walk &&
+               atomic_load_explicit(&sh->status, memory_order_relaxed) == WALK_RUNNING) {
+            u64 hash = hash_residue(ptrX->val, ptrX->wordlen);
+            if ((hash & dp_mask) == 0) {
+                // The coefficients are only brought up to date at distinguished points
+                rho_fold(&ptrA, ptrC, cnt, ptrN);
+                rho_fold(&ptrB, ptrD, cnt, ptrN);
+                memset(cnt, 0, sizeof(cnt));
+                pack_words(record, ptrX, sh->point_words);
+                pack_words(record + sh->point_words, ptrA, sh->scalar_words);
+                pack_words(record + sh->point_words + sh->scalar_words, ptrB, sh->scalar_words);
+
+                const WORD* other = NULL;
+                int res = dp_insert(sh->table, hash, record, &other);
+                if (res == DP_FULL) {
+                    int expected = WALK_RUNNING;
+                    atomic_compare_exchange_strong(&sh->status, &expected, WALK_FAILED);
+                    break;
+                }
+                if (res == DP_COLLISION) {
+                    if (rho_solve(&ptrA, &ptrB, other + sh->point_words, &ptrG, &ptrH,
+                                  ptrMod, ptrN, sh->scalar_words, &ptrT)) {
+                        int expected = WALK_RUNNING;
+                        if (atomic_compare_exchange_strong(&sh->status, &expected, WALK_SOLVED))
+                            copyBINT(&sh->ptrX, &ptrT);
+                    }
+                    break;  // Either solved or a useless collision: start over
+                }
+                steps = 0;
+            }
+            int k = (int)((hash >> 32) % RHO_ADDING_WALK);
+            BARRETT_Mul(&ptrX, &ptrM[k], &ptrT, ptrCtx);
+            swapBINT(&ptrX, &ptrT);
+            cnt[k]++;
+            steps++;
+        }
+    }
+
+    free(record);
+    delete_barrett_ctx(&ptrCtx);
+    delete_bint(&ptrG); delete_bint(&ptrH);
+    delete_bint(&ptrMod); delete_bint(&ptrN);
+    for (int k = 0; k < RHO_ADDING_WALK; k++) {
+        delete_bint(&ptrM[k]); delete_bint(&ptrC[k]); delete_bint(&ptrD[k]);
+    }
+    delete_bint(&ptrX); delete_bint(&ptrA); delete_bint(&ptrB);
+    delete_bint(&ptrT); delete_bint(&ptrU);
+    return NULL;
+}
+
+bool DLP_Rho(BINT** pptrG, BINT** pptrH, BINT** pptrX, BINT* ptrMod, BINT* ptrOrder, int num_threads) {
+    CHECK_PTR_AND_DEREF(pptrG, "pptrG", "DLP_Rho");
+    CHECK_PTR_AND_DEREF(pptrH, "pptrH", "DLP_Rho");
+    CHECK_PTR_AND_DEREF(&ptrMod, "ptrMod", "DLP_Rho");
+    CHECK_PTR_AND_DEREF(&ptrOrder, "ptrOrder", "DLP_Rho");
+    refineBINT(ptrMod); refineBINT(ptrOrder);
+    if (isZero(ptrOrder)) {
+        fprintf(stderr, "Error: order is zero in 'DLP_Rho'\n");
+        return false;
+    }
+    if (isOne(ptrOrder)) {
+        set_bint_u64(pptrX, 0);
+        return true;
+    }
+    if (num_threads <= 0)
+        num_threads = online_cores();
+
+    rho_shared sh;
+    memset(&sh, 0, sizeof(sh));
+    BINT* ptrQ = NULL;
+    copyBINT(&sh.ptrG, pptrG);
+    DIV_Long(pptrH, &ptrMod, &ptrQ, &sh.ptrH);
+    copyBINT(&sh.ptrMod, &ptrMod);
+    copyBINT(&sh.ptrOrder, &ptrOrder);
+
+    // About 2^8 distinguished points are expected before the first collision
+    int bits = BIT_LENGTH(ptrOrder);
+    sh.dp_bits = MAXIMUM(bits / 2 - 8, 0);
+    sh.dp_bits = MINIMUM(sh.dp_bits, 31);
+    sh.max_walk = 20ULL << sh.dp_bits;
+    sh.point_words = ptrMod->wordlen;
+    sh.scalar_words = ptrOrder->wordlen;
+    sh.seed = ((u64)time(NULL) << 20) ^ (u64)clock() ^ (u64)(size_t)&sh;
+    atomic_init(&sh.status, WALK_RUNNING);
+
+    // Every exponent below is smaller than the order: 2 * RHO_ADDING_WALK of them here and two per walk
+    init_fixed_base(&sh.ptrFG, &sh.ptrG, sh.ptrMod, bits, 0);
+    init_fixed_base(&sh.ptrFH, &sh.ptrH, sh.ptrMod, bits, 0);
+
+    u64 state = sh.seed | 1;
+    BINT *ptrT = NULL, *ptrU = NULL;
+    for (int k = 0; k < RHO_ADDING_WALK; k++) {
+        random_mod(&sh.ptrC[k], sh.ptrOrder, &state);
+        random_mod(&sh.ptrD[k], sh.ptrOrder, &state);
+        EXP_MOD_FixedBase(sh.ptrFG, &sh.ptrC[k], &ptrT);
+        EXP_MOD_FixedBase(sh.ptrFH, &sh.ptrD[k], &ptrU);
+        mul_mod(&ptrT, &ptrU, &sh.ptrM[k], sh.ptrMod);
+    }
+    sh.table = create_dp_table(RHO_TABLE_SIZE, sh.point_words, sh.point_words + 2 * sh.scalar_words);
+
+    pthread_t* threads = malloc(num_threads * sizeof(pthread_t));
+    rho_worker_arg* args = malloc(num_threads * sizeof(rho_worker_arg));
+    exit_on_null_error(threads, "threads", "DLP_Rho");
+    exit_on_null_error(args, "args", "DLP_Rho");
+    for (int i = 0; i < num_threads; i++) {
+        args[i].shared = &sh;
+        args[i].id = i;
+        if (pthread_create(&threads[i], NULL, rho_worker, &args[i]) != 0) {
+            fprintf(stderr, "Error: Unable to create thread in 'DLP_Rho'\n");
+            exit(1);
+        }
+    }
+    for (int i = 0; i < num_threads; i++)
+        pthread_join(threads[i], NULL);
+
+    bool found = atomic_load(&sh.status) == WALK_SOLVED;
+    if (found)
+        copyBINT(pptrX, &sh.ptrX);
+
+    free(threads); free(args);
+    delete_dp_table(&sh.table);
+    delete_fixed_base(&sh.ptrFG); delete_fixed_base(&sh.ptrFH);
+    delete_bint(&sh.ptrG); delete_bint(&sh.ptrH);
+    delete_bint(&sh.ptrMod); delete_bint(&sh.ptrOrder);
+    for (int k = 0; k < RHO_ADDING_WALK; k++) {
+        delete_bint(&sh.ptrM[k]); delete_bint(&sh.ptrC[k]); delete_bint(&sh.ptrD[k]);
+    }
+    delete_bint(&sh.ptrX);
+    delete_bint(&ptrQ); delete_bint(&ptrT); delete_bint(&ptrU);
+    return found;
+}
+
+/*
+ * Pohlig-Hellman
+ */
+
+bool DLP_CRT(BINT** ptrResidues, BINT** ptrModuli, int count, BINT** pptrX) {
+    BINT *ptrM = NULL, *ptrMi = NULL, *ptrR = NULL, *ptrY = NULL;
+    BINT *ptrT = NULL, *ptrS = NULL, *ptrQ = NULL;
+
+    // M = prod m_i
+    set_bint_u64(&ptrM, 1);
+    for (int i = 0; i < count; i++) {
+        MUL_Core_ImpTxtBk_xyz(&ptrM, &ptrModuli[i], &ptrT);
+        swapBINT(&ptrM, &ptrT);
+    }
+
+    // x = sum (r_i * (M/m_i)^(-1) mod m_i) * M/m_i
+    bool ok = true;
+    set_bint_u64(pptrX, 0);
+    for (int i = 0; i < count && ok; i++) {
+        DIV_Long(&ptrM, &ptrModuli[i], &ptrMi, &ptrT);
+        DIV_Long(&ptrMi, &ptrModuli[i], &ptrQ, &ptrR);
+        ok = inv_mod(&ptrR, &ptrY, ptrModuli[i]);
+        if (!ok)
+            break;
+        mul_mod(&ptrResidues[i], &ptrY, &ptrT, ptrModuli[i]);
+        MUL_Core_ImpTxtBk_xyz(&ptrT, &ptrMi, &ptrS);
+        add_core_xyz(pptrX, &ptrS, &ptrT);
+        swapBINT(pptrX, &ptrT);
+    }
+    if (ok) {
+        DIV_Long(pptrX, &ptrM, &ptrQ, &ptrT);
+        swapBINT(pptrX, &ptrT);
+    }
+
+    delete_bint(&ptrM); delete_bint(&ptrMi);
+    delete_bint(&ptrR); delete_bint(&ptrY);
+    delete_bint(&ptrT); delete_bint(&ptrS); delete_bint(&ptrQ);
+    return ok;
+}
+
+// x = log_g h modulo q^e, with the order of g equal to n; *pptrQe receives q^e. Digits go to DLP_BSGS with
+// tables of at most bsgs_memory bytes, or to DLP_Rho on rho_threads threads
+static bool ph_prime_power(BINT** pptrG, BINT** pptrH, BINT* ptrMod, BINT* ptrOrder, BINT* ptrPrime, int e,
+                           size_t bsgs_memory, int rho_threads, BINT** pptrX, BINT** pptrQe) {
+    // q^0, q^1, ..., q^e
+    BINT** ptrPow = calloc(e + 1, sizeof(BINT*));
+    exit_on_null_error(ptrPow, "ptrPow", "ph_prime_power");
+    set_bint_u64(&ptrPow[0], 1);
+    for (int k = 1; k <= e; k++)
+        MUL_Core_ImpTxtBk_xyz(&ptrPow[k - 1], &ptrPrime, &ptrPow[k]);
+
+    BINT *ptrCof = NULL, *ptrR = NULL, *ptrGi = NULL, *ptrHi = NULL, *ptrGamma = NULL;
+    BINT *ptrE = NULL, *ptrT = NULL, *ptrU = NULL, *ptrHk = NULL, *ptrD = NULL, *ptrQ = NULL;
+
+    // Project into the subgroup of order q^e, then to the one of order q
+    DIV_Long(&ptrOrder, &ptrPow[e], &ptrCof, &ptrR);
+    EXP_MOD_Sliding(pptrG, &ptrCof, &ptrGi, ptrMod);
+    EXP_MOD_Sliding(pptrH, &ptrCof, &ptrHi, ptrMod);
+    EXP_MOD_Sliding(&ptrGi, &ptrPow[e - 1], &ptrGamma, ptrMod);
+
+    // Every digit reduces by q^e
+    DivCtx* ptrCtx = NULL;
+    init_div_ctx(&ptrCtx, ptrPow[e]);
+
+    bool ok = true;
+    set_bint_u64(pptrX, 0);
+    for (int k = 0; k < e && ok; k++) {
+        // h_k = (h_i * g_i^(-x))^(q^(e-1-k)) = h_i^(q^(e-1-k)) * g_i^((q^e - x) * q^(e-1-k) mod q^e) has order
+        // dividing q; both powers share one squaring chain
+        SUB(&ptrPow[e], pptrX, &ptrE);
+        MUL_Core_ImpTxtBk_xyz(&ptrE, &ptrPow[e - 1 - k], &ptrT);
+        DIV_Invariant(&ptrT, &ptrQ, &ptrU, ptrCtx);
+        refineBINT(ptrU);
+        BINT* ptrBases[2] = { ptrHi, ptrGi };
+        BINT* ptrExps[2] = { ptrPow[e - 1 - k], ptrU };
+        EXP_MOD_Multi(ptrBases, ptrExps, 2, &ptrHk, ptrMod);
+        refineBINT(ptrHk);
+
+        if (isOne(ptrHk)) {
+            continue;  // digit is zero
+        } else if (BIT_LENGTH(ptrPrime) <= PH_BSGS_MAX_BITS) {
+            ok = DLP_BSGS(&ptrGamma, &ptrHk, &ptrD, ptrMod, ptrPrime, bsgs_memory);
+        } else {
+            ok = DLP_Rho(&ptrGamma, &ptrHk, &ptrD, ptrMod, ptrPrime, rho_threads);
+        }
+        if (!ok)
+            break;
+
+        // x <- x + d * q^k
+        MUL_Core_ImpTxtBk_xyz(&ptrD, &ptrPow[k], &ptrT);
+        add_core_xyz(pptrX, &ptrT, &ptrU);
+        swapBINT(pptrX, &ptrU);
+        refineBINT(*pptrX);
+    }
+    copyBINT(pptrQe, &ptrPow[e]);
+
+    delete_div_ctx(&ptrCtx);
+    for (int k = 0; k <= e; k++)
+        delete_bint(&ptrPow[k]);
+    free(ptrPow);
+    delete_bint(&ptrCof); delete_bint(&ptrR);
+    delete_bint(&ptrGi); delete_bint(&ptrHi); delete_bint(&ptrGamma);
+    delete_bint(&ptrE); delete_bint(&ptrT); delete_bint(&ptrU);
+    delete_bint(&ptrHk); delete_bint(&ptrD); delete_bint(&ptrQ);
+    return ok;
+}
+
+typedef struct {
+    BINT* ptrG; BINT* ptrH;
+    BINT* ptrMod; BINT* ptrOrder;
+    BINT** ptrPrimes;
+    int* exponents;
+    int num_factors;
+    size_t bsgs_memory;             // per worker, so that the tables of all of them fit BSGS_DEFAULT_MEMORY
+    int rho_threads;
+    BINT** ptrResidues;             // x mod q_i^e_i
+    BINT** ptrModuli;               // q_i^e_i
+    atomic_int next;
+    atomic_int failed;
+} ph_shared;
+
+static void* ph_worker(void* arg) {
+    ph_shared* sh = arg;
+
+    // Thread-local copies: the arithmetic kernels resize their operands in place
+    BINT *ptrG = NULL, *ptrH = NULL, *ptrMod = NULL, *ptrN = NULL, *ptrQ = NULL;
+    copyBINT(&ptrG, &sh->ptrG); copyBINT(&ptrH, &sh->ptrH);
+    copyBINT(&ptrMod, &sh->ptrMod); copyBINT(&ptrN, &sh->ptrOrder);
+
+    for (;;) {
+        int i = atomic_fetch_add(&sh->next, 1);
+        if (i >= sh->num_factors || atomic_load(&sh->failed))
+            break;
+        copyBINT(&ptrQ, &sh->ptrPrimes[i]);
+        if (!ph_prime_power(&ptrG, &ptrH, ptrMod, ptrN, ptrQ, sh->exponents[i], sh->bsgs_memory,
+                            sh->rho_threads, &sh->ptrResidues[i], &sh->ptrModuli[i]))
+            atomic_store(&sh->failed, 1);
+    }
+
+    delete_bint(&ptrG); delete_bint(&ptrH);
+    delete_bint(&ptrMod); delete_bint(&ptrN); delete_bint(&ptrQ);
+    return NULL;
+}
+
+bool DLP_PohligHellman(BINT** pptrG, BINT** pptrH, BINT** pptrX, BINT* ptrMod,
+                       BINT** ptrPrimes, int* exponents, int num_factors, int num_threads) {
+    CHECK_PTR_AND_DEREF(pptrG, "pptrG", "DLP_PohligHellman");
+    CHECK_PTR_AND_DEREF(pptrH, "pptrH", "DLP_PohligHellman");
+    CHECK_PTR_AND_DEREF(&ptrMod, "ptrMod", "DLP_PohligHellman");
+    exit_on_null_error(ptrPrimes, "ptrPrimes", "DLP_PohligHellman");
+    exit_on_null_error(exponents, "exponents", "DLP_PohligHellman");
+    if (num_factors <= 0) {
+        fprintf(stderr, "Error: no factors given in 'DLP_PohligHellman'\n");
+        return false;
+    }
+    if (num_threads <= 0)
+        num_threads = online_cores();
+    int workers = MINIMUM(num_threads, num_factors);
+
+    ph_shared sh;
+    memset(&sh, 0, sizeof(sh));
+    BINT *ptrQ = NULL, *ptrT = NULL;
+    copyBINT(&sh.ptrG, pptrG);
+    DIV_Long(pptrH, &ptrMod, &ptrQ, &sh.ptrH);
+    copyBINT(&sh.ptrMod, &ptrMod);
+
+    // n = prod q_i^e_i
+    set_bint_u64(&sh.ptrOrder, 1);
+    for (int i = 0; i < num_factors; i++) {
+        for (int k = 0; k < exponents[i]; k++) {
+            copyBINT(&ptrQ, &ptrPrimes[i]);
+            MUL_Core_ImpTxtBk_xyz(&sh.ptrOrder, &ptrQ, &ptrT);
+            swapBINT(&sh.ptrOrder, &ptrT);
+        }
+    }
+    refineBINT(sh.ptrOrder);
+
+    sh.ptrPrimes = ptrPrimes;
+    sh.exponents = exponents;
+    sh.num_factors = num_factors;
+    sh.bsgs_memory = BSGS_DEFAULT_MEMORY / workers;
+    sh.rho_threads = MAXIMUM(num_threads / workers, 1);
+    sh.ptrResidues = calloc(num_factors, sizeof(BINT*));
+    sh.ptrModuli = calloc(num_factors, sizeof(BINT*));
+    exit_on_null_error(sh.ptrResidues, "ptrResidues", "DLP_PohligHellman");
+    exit_on_null_error(sh.ptrModuli, "ptrModuli", "DLP_PohligHellman");
+    atomic_init(&sh.next, 0);
+    atomic_init(&sh.failed, 0);
+
+    pthread_t* threads = malloc(workers * sizeof(pthread_t));
+    exit_on_null_error(threads, "threads", "DLP_PohligHellman");
+    for (int i = 0; i < workers; i++) {
+        if (pthread_create(&threads[i], NULL, ph_worker, &sh) != 0) {
+            fprintf(stderr, "Error: Unable to create thread in 'DLP_PohligHellman'\n");
+            exit(1);
+        }
+    }
+    for (int i = 0; i < workers; i++)
+        pthread_join(threads[i], NULL);
+
+    bool found = !atomic_load(&sh.failed) &&
+                 DLP_CRT(sh.ptrResidues, sh.ptrModuli, num_factors, pptrX);
+
+    free(threads);
+    for (int i = 0; i < num_factors; i++) {
+        delete_bint(&sh.ptrResidues[i]);
+        delete_bint(&sh.ptrModuli[i]);
+    }
+    free(sh.ptrResidues); free(sh.ptrModuli);
+    delete_bint(&sh.ptrG); delete_bint(&sh.ptrH);
+    delete_bint(&sh.ptrMod); delete_bint(&sh.ptrOrder);
+    delete_bint(&ptrQ); delete_bint(&ptrT);
+    return found;
+}
+
+/*
+ * Pollard kangaroo (lambda)
+ */
+
+#define KANGAROO_TAME 0
+#define KANGAROO_WILD 1
+#define KANGAROO_MAX_JUMPS 62
+
+typedef struct {
+    BINT* ptrG;
+    BINT* ptrH;                         // h' = h * g^(-lower)
+    BINT* ptrMod;
+    BINT* ptrJ[KANGAROO_MAX_JUMPS];     // J_k = g^(2^k)
+    FixedBase* ptrFG;                   // fixed-base table of g for distances up to the width
+    int num_jumps;
+    u64 width;
+    int dp_bits;
+    int point_words;
+    dp_table* table;
+    atomic_int status;
+    u64 offset;                         // x - lower
+    u64 seed;
+} kangaroo_shared;
+
+typedef struct {
+    kangaroo_shared* shared;
+    int id;
+} kangaroo_worker_arg;
+
+typedef struct {
+    BINT* ptrPos;
+    u64 dist;
+    int type;
+} kangaroo;
+
+// Tame kangaroos start in [w/4, 3w/4], wild ones at x' + [0, w/2]
+static void kangaroo_spawn(kangaroo* kg, FixedBase* ptrFG, BINT** pptrH, BINT* ptrMod, u64 width, u64* state) {
+    BINT *ptrE = NULL, *ptrT = NULL;
+    if (kg->type == KANGAROO_TAME) {
+        kg->dist = width / 4 + next_random(state) % (width / 2 + 1);
+        set_bint_u64(&ptrE, kg->dist);
+        EXP_MOD_FixedBase(ptrFG, &ptrE, &kg->ptrPos);
+    } else {
+        kg->dist = next_random(state) % (width / 2 + 1);
+        set_bint_u64(&ptrE, kg->dist);
+        EXP_MOD_FixedBase(ptrFG, &ptrE, &ptrT);
+        mul_mod(pptrH, &ptrT, &kg->ptrPos, ptrMod);
+    }
+    delete_bint(&ptrE); delete_bint(&ptrT);
+}
+
+static void* kangaroo_worker(void* arg) {
+    kangaroo_shared* sh = ((kangaroo_worker_arg*)arg)->shared;
+    u64 state = sh->seed ^ (0x9e3779b97f4a7c15ULL * (u64)(((kangaroo_worker_arg*)arg)->id + 1));
+    if (!state) state = 1;
+
+    // Thread-local copies: the arithmetic kernels resize their operands in place
+    BINT *ptrH = NULL, *ptrMod = NULL, *ptrT = NULL, *ptrE = NULL;
+    BINT* ptrJ[KANGAROO_MAX_JUMPS] = { NULL };
+    copyBINT(&ptrH, &sh->ptrH); copyBINT(&ptrMod, &sh->ptrMod);
+    for (int k = 0; k < sh->num_jumps; k++)
+        copyBINT(&ptrJ[k], &sh->ptrJ[k]);
+    BarrettCtx* ptrCtx = NULL;
+    init_barrett_ctx(&ptrCtx, ptrMod);
+
+    int record_words = sh->point_words + U64_WORDS + 1;
+    WORD* record = malloc(record_words * sizeof(WORD));
+    exit_on_null_error(record, "record", "kangaroo_worker");
+    u64 dp_mask = (1ULL << sh->dp_bits) - 1;
+
+    kangaroo herd[2] = { { NULL, 0, KANGAROO_TAME }, { NULL, 0, KANGAROO_WILD } };
+    for (int i = 0; i < 2; i++)
+        kangaroo_spawn(&herd[i], sh->ptrFG, &ptrH, ptrMod, sh->width, &state);
+
+    while (atomic_load_explicit(&sh->status, memory_order_relaxed) == WALK_RUNNING) {
+        for (int i = 0; i < 2; i++) {
+            kangaroo* kg = &herd[i];
+            u64 hash = hash_residue(kg->ptrPos->val, kg->ptrPos->wordlen);
+            if ((hash & dp_mask) == 0) {
+                pack_words(record, kg->ptrPos, sh->point_words);
+                pack_u64(record + sh->point_words, kg->dist);
+                record[record_words - 1] = (WORD)kg->type;
+
+                const WORD* other = NULL;
+                int res = dp_insert(sh->table, hash, record, &other);
+                if (res == DP_FULL) {
+                    int expected = WALK_RUNNING;
+                    atomic_compare_exchange_strong(&sh->status, &expected, WALK_FAILED);
+                    break;
+                }
+                if (res == DP_COLLISION) {
+                    u64 other_dist = unpack_u64(other + sh->point_words);
+                    int other_type = (int)other[record_words - 1];
+                    if (other_type != kg->type) {
+                        // g^d_tame = h' * g^d_wild
+                        u64 d_tame = kg->type == KANGAROO_TAME ? kg->dist : other_dist;
+                        u64 d_wild = kg->type == KANGAROO_WILD ? kg->dist : other_dist;
+                        if (d_tame >= d_wild && d_tame - d_wild <= sh->width) {
+                            set_bint_u64(&ptrE, d_tame - d_wild);
+                            EXP_MOD_FixedBase(sh->ptrFG, &ptrE, &ptrT);
+                            int expected = WALK_RUNNING;
+                            if (equal_bint(ptrT, ptrH) &&
+                                atomic_compare_exchange_strong(&sh->status, &expected, WALK_SOLVED))
+                                sh->offset = d_tame - d_wild;
+                        }
+                    }
+                    // Same herd (or no solution): this kangaroo now trails the other one forever
+                    kangaroo_spawn(kg, sh->ptrFG, &ptrH, ptrMod, sh->width, &state);
+                    continue;
+                }
+            }
+            int k = (int)((hash >> 32) % (u64)sh->num_jumps);
+            BARRETT_Mul(&kg->ptrPos, &ptrJ[k], &ptrT, ptrCtx);
+            swapBINT(&kg->ptrPos, &ptrT);
+            kg->dist += 1ULL << k;
+        }
+    }
+
+    free(record);
+    delete_barrett_ctx(&ptrCtx);
+    delete_bint(&herd[0].ptrPos); delete_bint(&herd[1].ptrPos);
+    delete_bint(&ptrH); delete_bint(&ptrMod);
+    delete_bint(&ptrT); delete_bint(&ptrE);
+    for (int k = 0; k < sh->num_jumps; k++)
+        delete_bint(&ptrJ[k]);
+    return NULL;
+}
+
+bool DLP_Kangaroo(BINT** pptrG, BINT** pptrH, BINT** pptrX, BINT* ptrMod,
+                  BINT* ptrLower, BINT* ptrUpper, int num_threads) {
+    CHECK_PTR_AND_DEREF(pptrG, "pptrG", "DLP_Kangaroo");
+    CHECK_PTR_AND_DEREF(pptrH, "pptrH", "DLP_Kangaroo");
+    CHECK_PTR_AND_DEREF(&ptrMod, "ptrMod", "DLP_Kangaroo");
+    CHECK_PTR_AND_DEREF(&ptrLower, "ptrLower", "DLP_Kangaroo");
+    CHECK_PTR_AND_DEREF(&ptrUpper, "ptrUpper", "DLP_Kangaroo");
+    refineBINT(ptrMod);
+
+    BINT *ptrW = NULL, *ptrT = NULL, *ptrU = NULL, *ptrQ = NULL;
+    SUB(&ptrUpper, &ptrLower, &ptrW);
+    refineBINT(ptrW);
+    if ((ptrW->sign && !isZero(ptrW)) || BIT_LENGTH(ptrW) > 62) {
+        fprintf(stderr, "Error: interval must satisfy 0 <= upper - lower < 2^62 in 'DLP_Kangaroo'\n");
+        delete_bint(&ptrW);
+        return false;
+    }
+    if (num_threads <= 0)
+        num_threads = online_cores();
+
+    kangaroo_shared sh;
+    memset(&sh, 0, sizeof(sh));
+    sh.width = get_bint_u64(ptrW);
+    copyBINT(&sh.ptrG, pptrG);
+    copyBINT(&sh.ptrMod, &ptrMod);
+
+    // h' = h * g^(-lower)
+    EXP_MOD_Sliding(&sh.ptrG, &ptrLower, &ptrT, sh.ptrMod);
+    bool ok = inv_mod(&ptrT, &ptrU, sh.ptrMod);
+    if (ok) {
+        DIV_Long(pptrH, &ptrMod, &ptrQ, &ptrT);
+        mul_mod(&ptrT, &ptrU, &sh.ptrH, sh.ptrMod);
+    }
+
+    // Jumps 2^0, ..., 2^(K-1) with mean (2^K - 1) / K close to (#kangaroos) * sqrt(w) / 4
+    u64 mean = MAXIMUM((2 * (u64)num_threads * isqrt_ceil(sh.width)) / 4, (u64)1);
+    sh.num_jumps = 1;
+    while (sh.num_jumps < KANGAROO_MAX_JUMPS && ((1ULL << sh.num_jumps) - 1) / (u64)sh.num_jumps < mean)
+        sh.num_jumps++;
+    copyBINT(&sh.ptrJ[0], &sh.ptrG);
+    for (int k = 1; k < sh.num_jumps; k++)
+        mul_mod(&sh.ptrJ[k - 1], &sh.ptrJ[k - 1], &sh.ptrJ[k], sh.ptrMod);
+
+    int bits = BIT_LENGTH(ptrW);
+    init_fixed_base(&sh.ptrFG, &sh.ptrG, sh.ptrMod, MAXIMUM(bits, 1), 0);
+    sh.dp_bits = MAXIMUM(bits / 2 - 8, 0);
+    sh.point_words = sh.ptrMod->wordlen;
+    sh.seed = ((u64)time(NULL) << 20) ^ (u64)clock() ^ (u64)(size_t)&sh;
+    atomic_init(&sh.status, ok ? WALK_RUNNING : WALK_FAILED);
+    sh.table = create_dp_table(KANGAROO_TABLE_SIZE, sh.point_words, sh.point_words + U64_WORDS + 1);
+
+    pthread_t* threads = malloc(num_threads * sizeof(pthread_t));
+    kangaroo_worker_arg* args = malloc(num_threads * sizeof(kangaroo_worker_arg));
+    exit_on_null_error(threads, "threads", "DLP_Kangaroo");
+    exit_on_null_error(args, "args", "DLP_Kangaroo");
+    for (int i = 0; i < num_threads && ok; i++) {
+        args[i].shared = &sh;
+        args[i].id = i;
+        if (pthread_create(&threads[i], NULL, kangaroo_worker, &args[i]) != 0) {
+            fprintf(stderr, "Error: Unable to create thread in 'DLP_Kangaroo'\n");
+            exit(1);
+        }
+    }
+    for (int i = 0; i < num_threads && ok; i++)
+        pthread_join(threads[i], NULL);
+
+    bool found = atomic_load(&sh.status) == WALK_SOLVED;
+    if (found) {
+        // x = lower + (d_tame - d_wild)
+        set_bint_u64(&ptrT, sh.offset);
+        add_core_xyz(&ptrLower, &ptrT, pptrX);
+        refineBINT(*pptrX);
+    }
+
+    free(threads); free(args);
+    delete_dp_table(&sh.table);
+    delete_fixed_base(&sh.ptrFG);
+    delete_bint(&sh.ptrG); delete_bint(&sh.ptrH); delete_bint(&sh.ptrMod);
+    for (int k = 0; k < sh.num_jumps; k++)
+        delete_bint(&sh.ptrJ[k]);
+    delete_bint(&ptrW); delete_bint(&ptrT); delete_bint(&ptrU); delete_bint(&ptrQ);
+    return found;
+}
+
+/*
+ * Index calculus
+ */
+
+#define IC_MAGIC "PUBAO-IC"
+#define IC_VERSION 1
+
+typedef struct {
+    int nnz;
+    int* cols;                      // factor base indices, increasing
+    int* exps;
+    BINT* ptrK;                     // sum exps[j] * log(l_cols[j]) = k (mod q)
+} ic_relation;
+
+typedef struct {
+    IC_DB* db;
+    BINT* ptrBase;                  // candidates are base * g^k
+    bool need_logs;                 // only accept primes whose log is known
+    ic_relation* rels;
+    int count;
+    int target;
+    pthread_mutex_t lock;
+    atomic_int done;
+    _Atomic u64 trials;             // candidates tested so far, in batches of IC_TRIAL_BATCH
+    u64 max_trials;
+    u64 seed;
+} ic_shared;
+
+#define IC_TRIAL_BATCH 1024
+
+typedef struct {
+    ic_shared* shared;
+    int id;
+} ic_worker_arg;
+
+// val mod d for a single-word divisor; val is left untouched
+static WORD mod_word(const WORD* val, int len, WORD d) {
+    DWORD r = 0;
+    for (int i = len - 1; i >= 0; i--)
+        r = ((r << WORD_BITLEN) | val[i]) % d;
+    return (WORD)r;
+}
+
+// val <- val / d for a single-word divisor
+static void div_word(WORD* val, int len, WORD d) {
+    DWORD r = 0;
+    for (int i = len - 1; i >= 0; i--) {
+        DWORD cur = (r << WORD_BITLEN) | val[i];
+        val[i] = (WORD)(cur / d);
+        r = cur % d;
+    }
+}
+
+// Z <- value mod n
+static void set_mod_u64(BINT** pptrZ, u64 value, BINT* ptrMod) {
+    BINT *ptrT = NULL, *ptrQ = NULL;
+    set_bint_u64(&ptrT, value);
+    DIV_Long(&ptrT, &ptrMod, &ptrQ, pptrZ);
+    refineBINT(*pptrZ);
+    delete_bint(&ptrT); delete_bint(&ptrQ);
+}
+
+// Z <- X + Y mod n for X, Y in [0, n)
+static void add_mod(BINT** pptrX, BINT** pptrY, BINT** pptrZ, BINT* ptrMod) {
+    BINT* ptrT = NULL;
+    add_core_xyz(pptrX, pptrY, &ptrT);
+    refineBINT(ptrT);
+    if (compare_abs_bint(ptrT, ptrMod))
+        SUB(&ptrT, &ptrMod, pptrZ);
+    else
+        copyBINT(pptrZ, &ptrT);
+    refineBINT(*pptrZ);
+    delete_bint(&ptrT);
+}
+
+// Trial division of the len words in buf over the factor base (buf is destroyed). Returns the number of
+// distinct primes written to cols/exps, or -1 if buf is not smooth over the usable part of the base.
+static int ic_factor(WORD* buf, int len, IC_DB* db, bool need_logs, int* cols, int* exps) {
+    int nnz = 0;
+    while (len > 0 && buf[len - 1] == 0)
+        len--;
+    for (int i = 0; i < db->fb_size && !(len == 1 && buf[0] == 1); i++) {
+        WORD l = db->primes[i];
+        if (mod_word(buf, len, l) != 0)
+            continue;
+        if (need_logs && db->ptrLogs[i] == NULL)
+            return -1;
+        int e = 0;
+        do {
+            div_word(buf, len, l);
+            while (len > 0 && buf[len - 1] == 0)
+                len--;
+            e++;
+        } while (mod_word(buf, len, l) == 0);
+        cols[nnz] = i;
+        exps[nnz++] = e;
+    }
+    return (len == 1 && buf[0] == 1) ? nnz : -1;
+}
+
+static void ic_free_relation(ic_relation* rel) {
+    free(rel->cols);
+    free(rel->exps);
+    delete_bint(&rel->ptrK);
+}
+
+static bool ic_has_col(ic_relation* rel, int c) {
+    for (int j = 0; j < rel->nnz; j++) {
+        if (rel->cols[j] == c)
+            return true;
+    }
+    return false;
+}
+
+// C <- (p-1)/q and Gc <- g^C mod p, the projection onto the subgroup of order q
+static void ic_project(IC_DB* db, BINT** pptrC, BINT** pptrGc) {
+    BINT *ptrOne = NULL, *ptrP1 = NULL, *ptrR = NULL;
+    set_bint_u64(&ptrOne, 1);
+    SUB(&db->ptrMod, &ptrOne, &ptrP1);
+    DIV_Long(&ptrP1, &db->ptrOrder, pptrC, &ptrR);
+    refineBINT(*pptrC);
+    refineBINT(db->ptrMod); refineBINT(db->ptrOrder);
+    EXP_MOD_Sliding(&db->ptrGen, pptrC, pptrGc, db->ptrMod);
+    refineBINT(*pptrGc);
+    delete_bint(&ptrOne); delete_bint(&ptrP1); delete_bint(&ptrR);
+}
+
+static void* ic_worker(void* arg) {
+    ic_worker_arg* wa = arg;
+    ic_shared* sh = wa->shared;
+    IC_DB* db = sh->db;
+    u64 state = (sh->seed + 0x9E3779B97F4A7C15ULL * (u64)(wa->id + 1)) | 1;
+
+    // Thread-local copies: the arithmetic kernels resize their operands in place
+    BINT *ptrG = NULL, *ptrMod = NULL, *ptrN = NULL, *ptrX = NULL, *ptrK = NULL, *ptrS = NULL;
+    BINT *ptrT = NULL, *ptrU = NULL, *ptrQ = NULL, *ptrStep = NULL, *ptrGs = NULL;
+    copyBINT(&ptrG, &db->ptrGen);
+    copyBINT(&ptrMod, &db->ptrMod);
+    copyBINT(&ptrN, &db->ptrOrder);
+    copyBINT(&ptrU, &sh->ptrBase);
+
+    // X = base * g^k0, then every candidate costs one multiplication by g^s. Both k0 and s are random:
+    // stepping by a small base element such as g = 2 would only yield multiples of earlier relations.
+    random_mod(&ptrK, ptrN, &state);
+    random_mod(&ptrS, ptrN, &state);
+    EXP_MOD_Sliding(&ptrG, &ptrK, &ptrT, ptrMod);
+    mul_mod(&ptrU, &ptrT, &ptrX, ptrMod);
+    EXP_MOD_Sliding(&ptrG, &ptrS, &ptrGs, ptrMod);
+    BarrettCtx* ptrCtx = NULL;
+    init_barrett_ctx(&ptrCtx, ptrMod);
+
+    WORD* buf = malloc(ptrMod->wordlen * sizeof(WORD));
+    int* cols = malloc(db->fb_size * sizeof(int));
+    int* exps = malloc(db->fb_size * sizeof(int));
+    exit_on_null_error(buf, "buf", "ic_worker");
+    exit_on_null_error(cols, "cols", "ic_worker");
+    exit_on_null_error(exps, "exps", "ic_worker");
+
+    for (u64 step = 0; !atomic_load(&sh->done); step++) {
+        refineBINT(ptrX);
+        pack_words(buf, ptrX, ptrX->wordlen);
+        int nnz = ic_factor(buf, ptrX->wordlen, db, sh->need_logs, cols, exps);
+        if (nnz >= 0) {
+            ic_relation rel;
+            rel.nnz = nnz;
+            rel.cols = malloc(MAXIMUM(nnz, 1) * sizeof(int));
+            rel.exps = malloc(MAXIMUM(nnz, 1) * sizeof(int));
+            exit_on_null_error(rel.cols, "rel.cols", "ic_worker");
+            exit_on_null_error(rel.exps, "rel.exps", "ic_worker");
+            memcpy(rel.cols, cols, nnz * sizeof(int));
+            memcpy(rel.exps, exps, nnz * sizeof(int));
+            rel.ptrK = NULL;
+            // k = k0 + step * s
+            set_bint_u64(&ptrStep, step);
+            MUL_Core_ImpTxtBk_xyz(&ptrStep, &ptrS, &ptrU);
+            add_core_xyz(&ptrK, &ptrU, &ptrT);
+            DIV_Long(&ptrT, &ptrN, &ptrQ, &rel.ptrK);
+            refineBINT(rel.ptrK);
+
+            bool stored = false;
+            pthread_mutex_lock(&sh->lock);
+            if (sh->count < sh->target) {
+                sh->rels[sh->count++] = rel;
+                stored = true;
+                if (sh->count == sh->target)
+                    atomic_store(&sh->done, 1);
+            }
+            pthread_mutex_unlock(&sh->lock);
+            if (!stored)
+                ic_free_relation(&rel);
+        }
+        BARRETT_Mul(&ptrX, &ptrGs, &ptrT, ptrCtx);
+        swapBINT(&ptrX, &ptrT);
+        // The budget is shared, so every thread stops once the candidates of all of them have used it up
+        if ((step + 1) % IC_TRIAL_BATCH == 0 &&
+            atomic_fetch_add(&sh->trials, IC_TRIAL_BATCH) + IC_TRIAL_BATCH >= sh->max_trials)
+            atomic_store(&sh->done, 1);
+    }
+
+    free(buf); free(cols); free(exps);
+    delete_barrett_ctx(&ptrCtx);
+    delete_bint(&ptrG); delete_bint(&ptrMod); delete_bint(&ptrN);
+    delete_bint(&ptrX); delete_bint(&ptrK); delete_bint(&ptrT);
+    delete_bint(&ptrU); delete_bint(&ptrQ); delete_bint(&ptrStep);
+    delete_bint(&ptrS); delete_bint(&ptrGs);
+    return NULL;
+}
+
+// Appends relations base * g^k = prod l^e to rels until *count reaches target (rels holds target entries).
+// Returns false if IC_MAX_TRIALS candidates per missing relation were tested first.
+static bool ic_collect(IC_DB* db, BINT* ptrBase, bool need_logs, ic_relation* rels, int* count, int target,
+                       int num_threads) {
+    ic_shared sh;
+    memset(&sh, 0, sizeof(sh));
+    sh.db = db;
+    sh.ptrBase = ptrBase;
+    sh.need_logs = need_logs;
+    sh.rels = rels;
+    sh.count = *count;
+    sh.target = target;
+    sh.max_trials = IC_MAX_TRIALS * (u64)MAXIMUM(target - *count, 1);
+    sh.seed = ((u64)time(NULL) << 20) ^ (u64)clock() ^ (u64)(size_t)&sh ^ ((u64)*count << 40);
+    pthread_mutex_init(&sh.lock, NULL);
+    atomic_init(&sh.done, sh.count >= target);
+    atomic_init(&sh.trials, 0);
+
+    pthread_t* threads = malloc(num_threads * sizeof(pthread_t));
+    ic_worker_arg* args = malloc(num_threads * sizeof(ic_worker_arg));
+    exit_on_null_error(threads, "threads", "ic_collect");
+    exit_on_null_error(args, "args", "ic_collect");
+    for (int i = 0; i < num_threads; i++) {
+        args[i].shared = &sh;
+        args[i].id = i;
+        if (pthread_create(&threads[i], NULL, ic_worker, &args[i]) != 0) {
+            fprintf(stderr, "Error: Unable to create thread in 'ic_collect'\n");
+            exit(1);
+        }
+    }
+    for (int i = 0; i < num_threads; i++)
+        pthread_join(threads[i], NULL);
+
+    *count = sh.count;
+    pthread_mutex_destroy(&sh.lock);
+    free(threads); free(args);
+    return sh.count >= target;
+}
+
+// Drops every log that fails l^C == Gc^log(l) and returns the number of logs left
+static int ic_verify(IC_DB* db) {
+    BINT *ptrC = NULL, *ptrGc = NULL, *ptrL = NULL, *ptrLc = NULL, *ptrT = NULL;
+    ic_project(db, &ptrC, &ptrGc);
+    int known = 0;
+    for (int i = 0; i < db->fb_size; i++) {
+        if (db->ptrLogs[i] == NULL)
+            continue;
+        set_bint_u64(&ptrL, db->primes[i]);
+        EXP_MOD_Sliding(&ptrL, &ptrC, &ptrLc, db->ptrMod);
+        EXP_MOD_Sliding(&ptrGc, &db->ptrLogs[i], &ptrT, db->ptrMod);
+        refineBINT(db->ptrLogs[i]);
+        refineBINT(ptrLc); refineBINT(ptrT);
+        if (equal_bint(ptrLc, ptrT))
+            known++;
+        else
+            delete_bint(&db->ptrLogs[i]);
+    }
+    delete_bint(&ptrC); delete_bint(&ptrGc);
+    delete_bint(&ptrL); delete_bint(&ptrLc); delete_bint(&ptrT);
+    return known;
+}
+
+// Solves k = sum e_j log(l_j) (mod q) for the factor base logs. Structured Gaussian elimination removes
+// singleton columns (their rows are back-substituted at the end) and the remaining core is solved by
+// dense Gaussian elimination. Logs that stay undetermined are left NULL. Returns the number of primes
+// occurring in the relations.
+static int ic_solve(IC_DB* db, ic_relation* rels, int nrels) {
+    int n = db->fb_size;
+    BINT* ptrN = db->ptrOrder;
+    BINT *ptrT = NULL, *ptrU = NULL, *ptrE = NULL, *ptrInv = NULL, *ptrF = NULL;
+    BarrettCtx* ptrCtx = NULL;
+    init_barrett_ctx(&ptrCtx, ptrN);
+    for (int i = 0; i < n; i++)
+        delete_bint(&db->ptrLogs[i]);
+
+    int* weight = calloc(n, sizeof(int));
+    bool* alive = malloc(MAXIMUM(nrels, 1) * sizeof(bool));
+    int* stack_row = malloc(MAXIMUM(nrels, 1) * sizeof(int));
+    int* stack_col = malloc(MAXIMUM(nrels, 1) * sizeof(int));
+    exit_on_null_error(weight, "weight", "ic_solve");
+    exit_on_null_error(alive, "alive", "ic_solve");
+    exit_on_null_error(stack_row, "stack_row", "ic_solve");
+    exit_on_null_error(stack_col, "stack_col", "ic_solve");
+    for (int r = 0; r < nrels; r++) {
+        alive[r] = true;
+        for (int j = 0; j < rels[r].nnz; j++)
+            weight[rels[r].cols[j]]++;
+    }
+    int seen = 0;
+    for (int c = 0; c < n; c++)
+        seen += weight[c] > 0;
+
+    // A column met by a single row only fixes that row's pivot: set the row aside until the rest is known
+    int depth = 0;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (int c = 0; c < n; c++) {
+            if (weight[c] != 1)
+                continue;
+            int r = 0;
+            while (!(alive[r] && ic_has_col(&rels[r], c)))
+                r++;
+            alive[r] = false;
+            stack_row[depth] = r;
+            stack_col[depth++] = c;
+            for (int j = 0; j < rels[r].nnz; j++)
+                weight[rels[r].cols[j]]--;
+            changed = true;
+        }
+    }
+
+    // Core columns; every surviving row is kept, as the largest primes often occur in only a few of them
+    int* dense_col = malloc(n * sizeof(int));
+    exit_on_null_error(dense_col, "dense_col", "ic_solve");
+    int ncols = 0, nrows = 0;
+    for (int c = 0; c < n; c++)
+        dense_col[c] = weight[c] > 0 ? ncols++ : -1;
+    for (int r = 0; r < nrels; r++)
+        nrows += alive[r];
+
+    // Dense matrix [A | k] over Z/qZ
+    BINT*** A = malloc(MAXIMUM(nrows, 1) * sizeof(BINT**));
+    exit_on_null_error(A, "A", "ic_solve");
+    for (int r = 0, i = 0; r < nrels; r++) {
+        if (!alive[r])
+            continue;
+        A[i] = malloc((ncols + 1) * sizeof(BINT*));
+        exit_on_null_error(A[i], "A[i]", "ic_solve");
+        for (int c = 0; c < ncols; c++) {
+            A[i][c] = NULL;
+            set_bint_u64(&A[i][c], 0);
+        }
+        for (int j = 0; j < rels[r].nnz; j++)
+            set_mod_u64(&A[i][dense_col[rels[r].cols[j]]], rels[r].exps[j], ptrN);
+        A[i][ncols] = NULL;
+        copyBINT(&A[i][ncols], &rels[r].ptrK);
+        i++;
+    }
+
+    // Forward elimination. Columns go from the largest prime down, sparsest first, and each pivot is the
+    // candidate row with the fewest nonzeros, which keeps the fill-in of the small prime columns late.
+    int* pivot_row = malloc(MAXIMUM(ncols, 1) * sizeof(int));
+    exit_on_null_error(pivot_row, "pivot_row", "ic_solve");
+    int rank = 0;
+    for (int j = ncols - 1; j >= 0; j--) {
+        pivot_row[j] = -1;
+        int best = -1, best_nnz = ncols + 1;
+        for (int i = rank; i < nrows; i++) {
+            if (isZero(A[i][j]))
+                continue;
+            int nnz = 0;
+            for (int c = 0; c < ncols; c++)
+                nnz += !isZero(A[i][c]);
+            if (nnz < best_nnz) {
+                best = i;
+                best_nnz = nnz;
+            }
+        }
+        if (best < 0)
+            continue;
+        BINT** row = A[best]; A[best] = A[rank]; A[rank] = row;
+        inv_mod(&row[j], &ptrInv, ptrN);
+        for (int c = 0; c <= ncols; c++) {
+            if (isZero(row[c]))
+                continue;
+            BARRETT_Mul(&row[c], &ptrInv, &ptrT, ptrCtx);
+            swapBINT(&row[c], &ptrT);
+        }
+        for (int i = rank + 1; i < nrows; i++) {
+            if (isZero(A[i][j]))
+                continue;
+            copyBINT(&ptrF, &A[i][j]);
+            for (int c = 0; c <= ncols; c++) {
+                if (isZero(row[c]))
+                    continue;
+                BARRETT_Mul(&ptrF, &row[c], &ptrT, ptrCtx);
+                sub_mod(&A[i][c], &ptrT, &ptrU, ptrN);
+                swapBINT(&A[i][c], &ptrU);
+            }
+        }
+        pivot_row[j] = rank++;
+    }
+
+    // Back substitution in increasing column order: a pivot row only involves columns eliminated after it,
+    // and its log stays unknown if any of them is a free column or unknown itself
+    BINT** ptrCore = calloc(MAXIMUM(ncols, 1), sizeof(BINT*));
+    exit_on_null_error(ptrCore, "ptrCore", "ic_solve");
+    for (int j = 0; j < ncols; j++) {
+        if (pivot_row[j] < 0)
+            continue;
+        BINT** row = A[pivot_row[j]];
+        bool known = true;
+        copyBINT(&ptrF, &row[ncols]);
+        for (int c = 0; c < j && known; c++) {
+            if (isZero(row[c]))
+                continue;
+            known = ptrCore[c] != NULL;
+            if (!known)
+                break;
+            BARRETT_Mul(&row[c], &ptrCore[c], &ptrT, ptrCtx);
+            sub_mod(&ptrF, &ptrT, &ptrU, ptrN);
+            swapBINT(&ptrF, &ptrU);
+        }
+        if (known)
+            copyBINT(&ptrCore[j], &ptrF);
+    }
+    for (int c = 0; c < n; c++) {
+        if (dense_col[c] >= 0 && ptrCore[dense_col[c]] != NULL)
+            copyBINT(&db->ptrLogs[c], &ptrCore[dense_col[c]]);
+    }
+    for (int j = 0; j < ncols; j++)
+        delete_bint(&ptrCore[j]);
+    free(ptrCore);
+
+    // Back-substitute the singleton rows, last removed first
+    for (int s = depth - 1; s >= 0; s--) {
+        ic_relation* rel = &rels[stack_row[s]];
+        int c = stack_col[s], ec = 0;
+        bool known = true;
+        copyBINT(&ptrF, &rel->ptrK);
+        for (int j = 0; j < rel->nnz && known; j++) {
+            if (rel->cols[j] == c) {
+                ec = rel->exps[j];
+                continue;
+            }
+            known = db->ptrLogs[rel->cols[j]] != NULL;
+            if (!known)
+                break;
+            set_mod_u64(&ptrE, rel->exps[j], ptrN);
+            BARRETT_Mul(&ptrE, &db->ptrLogs[rel->cols[j]], &ptrT, ptrCtx);
+            sub_mod(&ptrF, &ptrT, &ptrU, ptrN);
+            swapBINT(&ptrF, &ptrU);
+        }
+        set_mod_u64(&ptrE, ec, ptrN);
+        if (known && !isZero(ptrE) && inv_mod(&ptrE, &ptrInv, ptrN))
+            BARRETT_Mul(&ptrF, &ptrInv, &db->ptrLogs[c], ptrCtx);
+    }
+
+    for (int i = 0; i < nrows; i++) {
+        for (int c = 0; c <= ncols; c++)
+            delete_bint(&A[i][c]);
+        free(A[i]);
+    }
+    free(A); free(pivot_row); free(dense_col);
+    free(weight); free(alive); free(stack_row); free(stack_col);
+    delete_bint(&ptrT); delete_bint(&ptrU); delete_bint(&ptrE);
+    delete_bint(&ptrInv); delete_bint(&ptrF);
+    delete_barrett_ctx(&ptrCtx);
+    return seen;
+}
+
+void delete_ic_db(IC_DB** pptrDB) {
+    if (pptrDB == NULL || *pptrDB == NULL)
+        return;
+    IC_DB* db = *pptrDB;
+    delete_bint(&db->ptrMod);
+    delete_bint(&db->ptrGen);
+    delete_bint(&db->ptrOrder);
+    if (db->ptrLogs) {
+        for (int i = 0; i < db->fb_size; i++)
+            delete_bint(&db->ptrLogs[i]);
+    }
+    free(db->ptrLogs);
+    free(db->primes);
+    free(db);
+    *pptrDB = NULL;
+}
+
+bool IC_Precompute(IC_DB** pptrDB, BINT** pptrG, BINT* ptrMod, BINT* ptrOrder, int fb_bound, int num_threads) {
+    exit_on_null_error(pptrDB, "pptrDB", "IC_Precompute");
+    CHECK_PTR_AND_DEREF(pptrG, "pptrG", "IC_Precompute");
+    CHECK_PTR_AND_DEREF(&ptrMod, "ptrMod", "IC_Precompute");
+    CHECK_PTR_AND_DEREF(&ptrOrder, "ptrOrder", "IC_Precompute");
+    delete_ic_db(pptrDB);
+    refineBINT(ptrMod); refineBINT(ptrOrder);
+#if WORD_BITLEN < 32
+    fb_bound = MINIMUM(fb_bound, (1 << WORD_BITLEN) - 1);
+#endif
+    if (fb_bound < 2) {
+        fprintf(stderr, "Error: factor base bound below 2 in 'IC_Precompute'\n");
+        return false;
+    }
+    if (num_threads <= 0)
+        num_threads = online_cores();
+
+    IC_DB* db = calloc(1, sizeof(IC_DB));
+    exit_on_null_error(db, "db", "IC_Precompute");
+    BINT* ptrQ = NULL;
+    DIV_Long(pptrG, &ptrMod, &ptrQ, &db->ptrGen);
+    refineBINT(db->ptrGen);
+    copyBINT(&db->ptrMod, &ptrMod);
+    copyBINT(&db->ptrOrder, &ptrOrder);
+
+    // Factor base: sieve of Eratosthenes up to the bound
+    char* composite = calloc(fb_bound + 1, 1);
+    db->primes = malloc((fb_bound + 1) * sizeof(WORD));
+    exit_on_null_error(composite, "composite", "IC_Precompute");
+    exit_on_null_error(db->primes, "primes", "IC_Precompute");
+    for (int i = 2; i <= fb_bound; i++) {
+        if (composite[i])
+            continue;
+        db->primes[db->fb_size++] = (WORD)i;
+        for (long j = (long)i * i; j <= fb_bound; j += i)
+            composite[j] = 1;
+    }
+    free(composite);
+    db->ptrLogs = calloc(db->fb_size, sizeof(BINT*));
+    exit_on_null_error(db->ptrLogs, "ptrLogs", "IC_Precompute");
+
+    // The logs live in the subgroup of order q, which g must reach
+    BINT *ptrC = NULL, *ptrGc = NULL;
+    ic_project(db, &ptrC, &ptrGc);
+    bool ok = !isOne(ptrGc);
+    if (!ok)
+        fprintf(stderr, "Error: order of g is not divisible by q in 'IC_Precompute'\n");
+    delete_bint(&ptrC); delete_bint(&ptrGc); delete_bint(&ptrQ);
+
+    BINT* ptrOne = NULL;
+    set_bint_u64(&ptrOne, 1);
+    int count = 0, target = db->fb_size + IC_EXCESS;
+    ic_relation* rels = malloc(target * sizeof(ic_relation));
+    exit_on_null_error(rels, "rels", "IC_Precompute");
+    for (int round = 0; ok && round < IC_MAX_ROUNDS; round++) {
+        if (!ic_collect(db, ptrOne, false, rels, &count, target, num_threads)) {
+            fprintf(stderr, "Error: too few smooth values within IC_MAX_TRIALS in 'IC_Precompute'\n");
+            ok = false;
+            break;
+        }
+        int seen = ic_solve(db, rels, count);
+        if (seen > 0 && ic_verify(db) == seen)
+            break;
+        if (round == IC_MAX_ROUNDS - 1) {
+            ok = false;
+            break;
+        }
+        // A rank-deficient core leaves logs undetermined; more relations cure it
+        target += db->fb_size / 2 + IC_EXCESS;
+        rels = realloc(rels, target * sizeof(ic_relation));
+        exit_on_null_error(rels, "rels", "IC_Precompute");
+    }
+
+    // Primes absent from every relation leave the factor base
+    if (ok) {
+        int kept = 0;
+        for (int i = 0; i < db->fb_size; i++) {
+            if (db->ptrLogs[i] == NULL)
+                continue;
+            db->primes[kept] = db->primes[i];
+            db->ptrLogs[kept++] = db->ptrLogs[i];
+        }
+        db->fb_size = kept;
+    }
+
+    for (int r = 0; r < count; r++)
+        ic_free_relation(&rels[r]);
+    free(rels);
+    delete_bint(&ptrOne);
+    if (!ok)
+        delete_ic_db(&db);
+    *pptrDB = db;
+    return ok;
+}
+
+bool DLP_IndexCalculus(IC_DB* ptrDB, BINT** pptrH, BINT** pptrX, int num_threads) {
+    exit_on_null_error(ptrDB, "ptrDB", "DLP_IndexCalculus");
+    CHECK_PTR_AND_DEREF(pptrH, "pptrH", "DLP_IndexCalculus");
+    if (num_threads <= 0)
+        num_threads = online_cores();
+
+    BINT *ptrH = NULL, *ptrQ = NULL, *ptrE = NULL, *ptrT = NULL, *ptrU = NULL, *ptrAcc = NULL;
+    DIV_Long(pptrH, &ptrDB->ptrMod, &ptrQ, &ptrH);
+    refineBINT(ptrH); refineBINT(ptrDB->ptrMod);
+    if (isZero(ptrH)) {
+        fprintf(stderr, "Error: target is zero modulo p in 'DLP_IndexCalculus'\n");
+        delete_bint(&ptrH); delete_bint(&ptrQ);
+        return false;
+    }
+
+    // h * g^k = prod l^e  =>  log(h) = sum e * log(l) - k (mod q)
+    ic_relation rel;
+    int count = 0;
+    if (!ic_collect(ptrDB, ptrH, true, &rel, &count, 1, num_threads)) {
+        fprintf(stderr, "Error: no smooth value within IC_MAX_TRIALS in 'DLP_IndexCalculus'\n");
+        delete_bint(&ptrH); delete_bint(&ptrQ);
+        return false;
+    }
+    BINT* ptrN = ptrDB->ptrOrder;
+    set_bint_u64(&ptrAcc, 0);
+    for (int j = 0; j < rel.nnz; j++) {
+        set_mod_u64(&ptrE, rel.exps[j], ptrN);
+        mul_mod(&ptrE, &ptrDB->ptrLogs[rel.cols[j]], &ptrT, ptrN);
+        add_mod(&ptrAcc, &ptrT, &ptrU, ptrN);
+        swapBINT(&ptrAcc, &ptrU);
+    }
+    sub_mod(&ptrAcc, &rel.ptrK, &ptrT, ptrN);
+    ic_free_relation(&rel);
+
+    // Check h^C == Gc^x as h^C * Gc^(q - x) == 1 with a single squaring chain (Gc has order q)
+    BINT *ptrC = NULL, *ptrGc = NULL;
+    ic_project(ptrDB, &ptrC, &ptrGc);
+    refineBINT(ptrT);
+    SUB(&ptrN, &ptrT, &ptrE);
+    refineBINT(ptrE); refineBINT(ptrN); refineBINT(ptrT);
+    BINT* ptrBases[2] = { ptrH, ptrGc };
+    BINT* ptrExps[2] = { ptrC, ptrE };
+    EXP_MOD_Multi(ptrBases, ptrExps, 2, &ptrU, ptrDB->ptrMod);
+    refineBINT(ptrU);
+    bool found = isOne(ptrU);
+    if (found)
+        copyBINT(pptrX, &ptrT);
+
+    delete_bint(&ptrH); delete_bint(&ptrQ); delete_bint(&ptrE);
+    delete_bint(&ptrT); delete_bint(&ptrU); delete_bint(&ptrAcc);
+    delete_bint(&ptrC); delete_bint(&ptrGc);
+    return found;
+}
+
+bool IC_Save(IC_DB* ptrDB, const char* path) {
+    exit_on_null_error(ptrDB, "ptrDB", "IC_Save");
+    FILE* fp = fopen(path, "w");
+    if (fp == NULL) {
+        fprintf(stderr, "Error: Unable to open '%s' in 'IC_Save'\n", path);
+        return false;
+    }
+    fprintf(fp, "%s %d\n", IC_MAGIC, IC_VERSION);
+    fputs("p ", fp); write_bint_hex(fp, ptrDB->ptrMod);   fputc('\n', fp);
+    fputs("g ", fp); write_bint_hex(fp, ptrDB->ptrGen);   fputc('\n', fp);
+    fputs("q ", fp); write_bint_hex(fp, ptrDB->ptrOrder); fputc('\n', fp);
+    fprintf(fp, "n %d\n", ptrDB->fb_size);
+    for (int i = 0; i < ptrDB->fb_size; i++) {
+        fprintf(fp, "%llu ", (u64)ptrDB->primes[i]);
+        if (ptrDB->ptrLogs[i])
+            write_bint_hex(fp, ptrDB->ptrLogs[i]);
+        else
+            fputc('-', fp);
+        fputc('\n', fp);
+    }
+    return fclose(fp) == 0;
+}
+
+// Reads the next whitespace-separated token, however long, into *pbuf (grown as needed, *pcap bytes)
+static bool ic_read_token(FILE* fp, char** pbuf, size_t* pcap) {
+    int c;
+    while ((c = fgetc(fp)) != EOF && isspace(c))
+        ;
+    size_t len = 0;
+    for (; c != EOF && !isspace(c); c = fgetc(fp)) {
+        if (len + 1 >= *pcap) {
+            *pcap = MAXIMUM(2 * *pcap, (size_t)64);
+            *pbuf = realloc(*pbuf, *pcap);
+            exit_on_null_error(*pbuf, "buf", "ic_read_token");
+        }
+        (*pbuf)[len++] = (char)c;
+    }
+    if (len > 0)
+        (*pbuf)[len] = '\0';
+    return len > 0;
+}
+
+// Reads a "<tag> 0x..." line of IC_Save, whatever the size of the value
+static bool ic_read_value(FILE* fp, const char* tag, BINT** pptrZ, char** pbuf, size_t* pcap) {
+    return ic_read_token(fp, pbuf, pcap) && strcmp(*pbuf, tag) == 0 &&
+           ic_read_token(fp, pbuf, pcap) && read_bint_hex(pptrZ, *pbuf);
+}
+
+bool IC_Load(IC_DB** pptrDB, const char* path) {
+    exit_on_null_error(pptrDB, "pptrDB", "IC_Load");
+    delete_ic_db(pptrDB);
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "Error: Unable to open '%s' in 'IC_Load'\n", path);
+        return false;
+    }
+    IC_DB* db = calloc(1, sizeof(IC_DB));
+    exit_on_null_error(db, "db", "IC_Load");
+    char magic[16];
+    char* hex = NULL;
+    size_t cap = 0;
+    int version = 0;
+    bool ok = fscanf(fp, "%15s %d", magic, &version) == 2 &&
+              strcmp(magic, IC_MAGIC) == 0 && version == IC_VERSION;
+    ok = ok && ic_read_value(fp, "p", &db->ptrMod, &hex, &cap);
+    ok = ok && ic_read_value(fp, "g", &db->ptrGen, &hex, &cap);
+    ok = ok && ic_read_value(fp, "q", &db->ptrOrder, &hex, &cap);
+    ok = ok && fscanf(fp, " n %d", &db->fb_size) == 1 && db->fb_size > 0;
+    if (ok) {
+        db->primes = malloc(db->fb_size * sizeof(WORD));
+        db->ptrLogs = calloc(db->fb_size, sizeof(BINT*));
+        exit_on_null_error(db->primes, "primes", "IC_Load");
+        exit_on_null_error(db->ptrLogs, "ptrLogs", "IC_Load");
+    }
+    for (int i = 0; ok && i < db->fb_size; i++) {
+        u64 prime;
+        ok = fscanf(fp, " %llu", &prime) == 1 && ic_read_token(fp, &hex, &cap) && prime >= 2 &&
+             (i == 0 || prime > db->primes[i - 1]) && (u64)(WORD)prime == prime;
+        if (ok)
+            db->primes[i] = (WORD)prime;
+        if (ok && strcmp(hex, "-") != 0)
+            ok = read_bint_hex(&db->ptrLogs[i], hex);
+    }
+    free(hex);
+    fclose(fp);
+    if (!ok) {
+        fprintf(stderr, "Error: Malformed database '%s' in 'IC_Load'\n", path);
+        delete_ic_db(&db);
+    }
+    *pptrDB = db;
+    return ok;
+}
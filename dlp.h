@@ -0,0 +1,241 @@
+/**
+ * @file dlp.h
+ * @brief Header file for discrete logarithm solvers.
+ *
+ * This file declares the solvers for the discrete logarithm problem (DLP)
+ * g^x = h (mod p) over BINT, built on top of the modular arithmetic provided
+ * by arithmetic.h and the residue table in hash/hash.h.
+ */
+
+#ifndef _DLP_H
+#define _DLP_H
+
+#include "arithmetic.h"
+
+#include <stddef.h>
+
+/**
+ * @def BSGS_DEFAULT_MEMORY
+ * @brief Default memory budget (in bytes) for the baby-step table of DLP_BSGS.
+ */
+#define BSGS_DEFAULT_MEMORY ((size_t)1 << 30)
+
+/**
+ * @brief Solves the discrete logarithm g^x = h (mod p) with baby-step giant-step.
+ * @details Stores the baby steps g^j (0 <= j < m) in an open-addressing table keyed on
+ *          the reduced residue, keeping only a 32-bit fingerprint and the index j per slot.
+ *          The giant steps h * g^(-m*i) are then looked up in the table and every fingerprint
+ *          hit is confirmed with one modular exponentiation before it is returned.
+ *          The split m is ceil(sqrt(order)) unless the memory budget is smaller, in which
+ *          case m shrinks to what fits and the number of giant steps grows accordingly.
+ * @param pptrG A double pointer to the generator g.
+ * @param pptrH A double pointer to the target h.
+ * @param pptrX A double pointer where the logarithm x (0 <= x < order) will be stored.
+ * @param ptrMod A pointer to the prime modulus p.
+ * @param ptrOrder A pointer to the order of g (at most 64 bits).
+ * @param mem_budget The number of bytes the baby-step table may use.
+ * @pre g must have order exactly ptrOrder modulo p.
+ * @post On success *pptrX holds x with g^x = h (mod p).
+ * @return bool True if the logarithm was found, false if h is not in the subgroup generated by g
+ *         or the parameters are out of range.
+ */
+bool DLP_BSGS(BINT** pptrG, BINT** pptrH, BINT** pptrX, BINT* ptrMod, BINT* ptrOrder, size_t mem_budget);
+
+/**
+ * @def RHO_ADDING_WALK
+ * @brief Number of multipliers M_k = g^c_k * h^d_k in the r-adding walk of DLP_Rho (Teske's r = 20).
+ */
+#define RHO_ADDING_WALK 20
+
+/**
+ * @def RHO_TABLE_SIZE
+ * @brief Number of slots in the shared distinguished-point table of DLP_Rho.
+ */
+#define RHO_TABLE_SIZE ((size_t)1 << 16)
+
+/**
+ * @brief Solves the discrete logarithm g^x = h (mod p) with parallel Pollard rho.
+ * @details Every thread runs its own r-adding walk X <- X * M_k, k = hash(X) mod r, starting from
+ *          X = g^a * h^b with random a and b. A point whose hash has its low bits clear is
+ *          distinguished and is reported to a lock-free table shared by all threads. Two walks that
+ *          reach the same distinguished point with different (a, b) give a + b*x = a' + b'*x (mod order),
+ *          which is solved with EEA. Only the coefficients of distinguished points are stored, so the
+ *          memory use does not depend on the size of the order.
+ * @param pptrG A double pointer to the generator g.
+ * @param pptrH A double pointer to the target h.
+ * @param pptrX A double pointer where the logarithm x (0 <= x < order) will be stored.
+ * @param ptrMod A pointer to the prime modulus p.
+ * @param ptrOrder A pointer to the prime order of g.
+ * @param num_threads The number of walking threads; 0 or less uses every online core.
+ * @pre g must have prime order ptrOrder modulo p.
+ * @post On success *pptrX holds x with g^x = h (mod p).
+ * @return bool True if the logarithm was found, false if the distinguished-point table filled up first.
+ * @note h must lie in the subgroup generated by g, otherwise the walks never produce a usable collision.
+ */
+bool DLP_Rho(BINT** pptrG, BINT** pptrH, BINT** pptrX, BINT* ptrMod, BINT* ptrOrder, int num_threads);
+
+/**
+ * @def PH_BSGS_MAX_BITS
+ * @brief Largest prime factor (in bits) that DLP_PohligHellman hands to DLP_BSGS; larger primes go to DLP_Rho.
+ */
+#define PH_BSGS_MAX_BITS 48
+
+/**
+ * @brief Recombines residues with the Chinese Remainder Theorem.
+ * @details Computes the unique x modulo m_0 * m_1 * ... * m_(count-1) with x = r_i (mod m_i) for every i,
+ *          using EEA for the inverses of the partial products.
+ * @param ptrResidues An array of count pointers to the residues r_i.
+ * @param ptrModuli An array of count pointers to the moduli m_i.
+ * @param count The number of congruences.
+ * @param pptrX A double pointer where x will be stored.
+ * @pre The moduli must be pairwise coprime and 0 <= r_i < m_i.
+ * @return bool True on success, false if two moduli share a factor.
+ */
+bool DLP_CRT(BINT** ptrResidues, BINT** ptrModuli, int count, BINT** pptrX);
+
+/**
+ * @brief Solves the discrete logarithm g^x = h (mod p) with Pohlig-Hellman decomposition.
+ * @details For every prime power q^e dividing the order n, the problem is projected to the subgroup of
+ *          order q^e by raising g and h to n / q^e and solved digit by digit in the subgroup of order q.
+ *          Each digit is found with DLP_BSGS when q has at most PH_BSGS_MAX_BITS bits and with DLP_Rho
+ *          otherwise. The prime powers are independent and are taken from a shared queue by a pool of
+ *          threads; the results are recombined with DLP_CRT. The workers split BSGS_DEFAULT_MEMORY evenly
+ *          for their baby-step tables, and the threads for DLP_Rho likewise.
+ * @param pptrG A double pointer to the generator g.
+ * @param pptrH A double pointer to the target h.
+ * @param pptrX A double pointer where the logarithm x (0 <= x < n) will be stored.
+ * @param ptrMod A pointer to the prime modulus p.
+ * @param ptrPrimes An array of num_factors pointers to the distinct primes q_i dividing the order of g.
+ * @param exponents An array of num_factors exponents e_i, so that the order is n = prod q_i^e_i.
+ * @param num_factors The number of distinct prime factors.
+ * @param num_threads The size of the thread pool; 0 or less uses every online core.
+ * @pre g must have order exactly n modulo p and the factorization must be complete.
+ * @post On success *pptrX holds x with g^x = h (mod p).
+ * @return bool True if the logarithm was found, false if any subproblem has no solution.
+ */
+bool DLP_PohligHellman(BINT** pptrG, BINT** pptrH, BINT** pptrX, BINT* ptrMod,
+                       BINT** ptrPrimes, int* exponents, int num_factors, int num_threads);
+
+/**
+ * @def KANGAROO_TABLE_SIZE
+ * @brief Number of slots in the shared distinguished-point table of DLP_Kangaroo.
+ */
+#define KANGAROO_TABLE_SIZE ((size_t)1 << 16)
+
+/**
+ * @brief Solves the discrete logarithm g^x = h (mod p) for x in a known interval with parallel kangaroos.
+ * @details Implements the van Oorschot-Wiener parallel lambda method. With w = upper - lower, the target is
+ *          shifted to h' = h * g^(-lower) so that its logarithm lies in [0, w]. Every thread runs one tame
+ *          kangaroo (a known power of g) and one wild kangaroo (h' times a known power of g); both jump by
+ *          g^(2^k) with k taken from the hash of the current point, with a mean jump of about
+ *          (number of kangaroos) * sqrt(w) / 4. Distinguished points go to the same kind of lock-free table as
+ *          DLP_Rho, and a tame/wild collision gives x = lower + d_tame - d_wild. Time is O(sqrt(w)) and the
+ *          memory use only depends on the number of distinguished points, not on w.
+ * @param pptrG A double pointer to the generator g.
+ * @param pptrH A double pointer to the target h.
+ * @param pptrX A double pointer where the logarithm x (lower <= x <= upper) will be stored.
+ * @param ptrMod A pointer to the prime modulus p.
+ * @param ptrLower A pointer to the lower bound of the interval.
+ * @param ptrUpper A pointer to the upper bound of the interval.
+ * @param num_threads The number of threads; 0 or less uses every online core.
+ * @pre lower <= upper, upper - lower < 2^62 and the order of g must exceed upper - lower.
+ * @post On success *pptrX holds x with g^x = h (mod p) and lower <= x <= upper.
+ * @return bool True if the logarithm was found, false if the parameters are out of range or the
+ *         distinguished-point table filled up first.
+ */
+bool DLP_Kangaroo(BINT** pptrG, BINT** pptrH, BINT** pptrX, BINT* ptrMod,
+                  BINT* ptrLower, BINT* ptrUpper, int num_threads);
+
+/**
+ * @def IC_EXCESS
+ * @brief Number of relations collected beyond the factor base size before the linear algebra is attempted.
+ */
+#define IC_EXCESS 20
+
+/**
+ * @def IC_MAX_ROUNDS
+ * @brief Number of collect-and-solve rounds IC_Precompute runs before it gives up on undetermined logs.
+ */
+#define IC_MAX_ROUNDS 4
+
+/**
+ * @def IC_MAX_TRIALS
+ * @brief Number of candidates per missing relation, summed over all threads, after which relation collection
+ *        gives up, so that a factor base too small for the modulus makes the call fail instead of running forever.
+ */
+#define IC_MAX_TRIALS ((u64)1 << 24)
+
+/**
+ * @struct IC_DB
+ * @brief Precomputed logarithms of a factor base for index calculus in F_p^*.
+ *
+ * Logarithms are taken modulo a prime q dividing p-1 exactly once: the log of a prime l is the discrete
+ * logarithm of l^((p-1)/q) to the base g^((p-1)/q). The database only depends on (p, g, q) and can be
+ * reused for every target in the same field.
+ */
+typedef struct {
+    BINT* ptrMod;   /**< @brief The prime p. */
+    BINT* ptrGen;   /**< @brief The generator g. */
+    BINT* ptrOrder; /**< @brief The prime q dividing p-1 modulo which logarithms are computed. */
+    int fb_size;    /**< @brief The number of primes in the factor base. */
+    WORD* primes;   /**< @brief The factor base primes in increasing order. */
+    BINT** ptrLogs; /**< @brief The logarithm of each factor base prime modulo q. */
+} IC_DB;
+
+/**
+ * @brief Builds the factor base logarithm database for index calculus.
+ * @details Collects relations g^k = prod l_i^e_i (mod p) over the primes l_i <= fb_bound in parallel, each
+ *          thread stepping k by its own random stride so that a candidate costs one modular multiplication and
+ *          a trial division by single words. The system k = sum e_i log(l_i) (mod q) is pruned by structured
+ *          Gaussian elimination (singleton columns are removed and back-substituted) and the remaining core is
+ *          solved by dense Gaussian elimination modulo q. Every log is checked with one exponentiation before
+ *          it is stored; primes that occur in no relation are dropped from the factor base.
+ * @param pptrDB A double pointer where the new database will be stored.
+ * @param pptrG A double pointer to the generator g.
+ * @param ptrMod A pointer to the prime modulus p.
+ * @param ptrOrder A pointer to a prime q with q | p-1 and q^2 not dividing p-1, and q | ord(g).
+ * @param fb_bound The largest prime in the factor base (must fit in a WORD).
+ * @param num_threads The number of threads used for relation collection; 0 or less uses every online core.
+ * @return bool True if the logs of every prime met in a relation were found within IC_MAX_ROUNDS rounds, false
+ *         also if a round found too few relations within IC_MAX_TRIALS candidates each.
+ * @post On success *pptrDB must be released with delete_ic_db; on failure it is left NULL.
+ */
+bool IC_Precompute(IC_DB** pptrDB, BINT** pptrG, BINT* ptrMod, BINT* ptrOrder, int fb_bound, int num_threads);
+
+/**
+ * @brief Computes an individual logarithm with a precomputed index calculus database.
+ * @details Searches in parallel for k such that h * g^k is smooth over the factor base and returns
+ *          x = sum e_i log(l_i) - k (mod q), checked against h before it is returned.
+ * @param ptrDB A pointer to the database of the field.
+ * @param pptrH A double pointer to the target h.
+ * @param pptrX A double pointer where x = log_g(h) mod q will be stored.
+ * @param num_threads The number of searching threads; 0 or less uses every online core.
+ * @return bool True if the logarithm was found, false if no smooth h * g^k turned up within IC_MAX_TRIALS candidates.
+ * @note Only the residue of the logarithm modulo q is found; the other prime factors of p-1 can be handled with
+ *       DLP_PohligHellman and combined with DLP_CRT.
+ */
+bool DLP_IndexCalculus(IC_DB* ptrDB, BINT** pptrH, BINT** pptrX, int num_threads);
+
+/**
+ * @brief Saves an index calculus database to a text file.
+ * @param ptrDB A pointer to the database.
+ * @param path The path of the file to be written.
+ * @return bool True on success, false if the file could not be written.
+ */
+bool IC_Save(IC_DB* ptrDB, const char* path);
+
+/**
+ * @brief Loads an index calculus database written by IC_Save.
+ * @param pptrDB A double pointer where the loaded database will be stored.
+ * @param path The path of the file to be read.
+ * @return bool True on success, false if the file is missing or malformed.
+ */
+bool IC_Load(IC_DB** pptrDB, const char* path);
+
+/**
+ * @brief Deletes an index calculus database.
+ * @param pptrDB A double pointer to the database; set to NULL afterwards.
+ */
+void delete_ic_db(IC_DB** pptrDB);
+
+#endif // _DLP_H
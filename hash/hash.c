@@ -50,3 +50,159 @@ int search(hash_table *htable, char *key) {
     }
     return -1;
 }
+
+// Residue table
+
+// 64-bit finalizer (splitmix64), spreads every input bit over the whole word
+static u64 mix64(u64 x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+u64 hash_residue(const WORD *val, int wordlen) {
+    // Leading zero words must not change the hash of a reduced residue
+    while (wordlen > 1 && val[wordlen - 1] == 0)
+        wordlen--;
+
+    u64 value = 0x9e3779b97f4a7c15ULL;
+    for (int i = 0; i < wordlen; i++)
+        value = mix64(value ^ (u64)val[i]);
+    return value;
+}
+
+residue_table *create_residue_table(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity)
+        size <<= 1;
+
+    residue_table *table = malloc(sizeof(residue_table));
+    if (!table) {
+        fprintf(stderr, "Error: Unable to allocate memory for residue_table.\n");
+        exit(1);
+    }
+    table->slots = calloc(size, sizeof(u64));
+    if (!table->slots) {
+        free(table);
+        fprintf(stderr, "Error: Unable to allocate memory for residue_table slots.\n");
+        exit(1);
+    }
+    table->mask = size - 1;
+    table->count = 0;
+    return table;
+}
+
+void delete_residue_table(residue_table **ptable) {
+    if (!(*ptable))
+        return;
+    free((*ptable)->slots);
+    free(*ptable);
+    *ptable = NULL;
+}
+
+// Low bits of the hash pick the bucket, high bits form the fingerprint
+#define RESIDUE_FINGERPRINT(h) ((h) >> 32)
+
+void residue_insert(residue_table *table, u64 hash, u64 index) {
+    if (table->count >= table->mask || index > RESIDUE_INDEX_MAX) {
+        fprintf(stderr, "Error: residue_table is full or index is out of range.\n");
+        exit(1);
+    }
+    u64 slot = (RESIDUE_FINGERPRINT(hash) << 32) | (index + 1);
+    size_t i = (size_t)hash & table->mask;
+    while (table->slots[i])
+        i = (i + 1) & table->mask;
+    table->slots[i] = slot;
+    table->count++;
+}
+
+int residue_search(const residue_table *table, u64 hash, size_t *cursor, u64 *index) {
+    // *cursor == 0 starts a new probe sequence, later calls continue it
+    size_t i = *cursor ? *cursor : (((size_t)hash & table->mask) + 1);
+    u64 fingerprint = RESIDUE_FINGERPRINT(hash);
+
+    for (i = (i - 1) & table->mask; table->slots[i]; i = (i + 1) & table->mask) {
+        u64 slot = table->slots[i];
+        if ((slot >> 32) == fingerprint) {
+            *index = (slot & 0xFFFFFFFFULL) - 1;
+            *cursor = ((i + 1) & table->mask) + 1;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Distinguished point table
+
+dp_table *create_dp_table(size_t capacity, int key_words, int record_words) {
+    size_t size = 1;
+    while (size < capacity)
+        size <<= 1;
+
+    dp_table *table = malloc(sizeof(dp_table));
+    if (!table) {
+        fprintf(stderr, "Error: Unable to allocate memory for dp_table.\n");
+        exit(1);
+    }
+    table->tags = calloc(size, sizeof(u64));
+    table->records = calloc(size * record_words, sizeof(WORD));
+    if (!table->tags || !table->records) {
+        free((void *)table->tags);
+        free(table->records);
+        free(table);
+        fprintf(stderr, "Error: Unable to allocate memory for dp_table records.\n");
+        exit(1);
+    }
+    table->key_words = key_words;
+    table->record_words = record_words;
+    table->mask = size - 1;
+    atomic_init(&table->count, 0);
+    return table;
+}
+
+void delete_dp_table(dp_table **ptable) {
+    if (!(*ptable))
+        return;
+    free((void *)(*ptable)->tags);
+    free((*ptable)->records);
+    free(*ptable);
+    *ptable = NULL;
+}
+
+int dp_insert(dp_table *table, u64 hash, const WORD *record, const WORD **other) {
+    // Bit 0 of a tag marks a published record, bit 1 keeps claimed tags non-zero
+    u64 tag = (hash | 2) & ~(u64)1;
+    size_t i = (size_t)hash & table->mask;
+
+    for (;;) {
+        u64 cur = atomic_load_explicit(&table->tags[i], memory_order_acquire);
+        if (cur == 0) {
+            // Keep the load factor under 3/4 so probe sequences stay short
+            if (atomic_fetch_add_explicit(&table->count, 1, memory_order_relaxed) >= table->mask - (table->mask >> 2)) {
+                atomic_fetch_sub_explicit(&table->count, 1, memory_order_relaxed);
+                return DP_FULL;
+            }
+            if (atomic_compare_exchange_strong_explicit(&table->tags[i], &cur, tag,
+                                                        memory_order_acq_rel, memory_order_acquire)) {
+                memcpy(&table->records[i * table->record_words], record, table->record_words * sizeof(WORD));
+                atomic_store_explicit(&table->tags[i], tag | 1, memory_order_release);
+                return DP_INSERTED;
+            }
+            // Lost the race for this slot, look at what the winner put there
+            atomic_fetch_sub_explicit(&table->count, 1, memory_order_relaxed);
+        }
+        if ((cur & ~(u64)1) == tag) {
+            while (!(cur & 1))
+                cur = atomic_load_explicit(&table->tags[i], memory_order_acquire);
+            const WORD *stored = &table->records[i * table->record_words];
+            if (memcmp(stored, record, table->key_words * sizeof(WORD)) == 0) {
+                *other = stored;
+                return DP_COLLISION;
+            }
+        }
+        i = (i + 1) & table->mask;
+    }
+}
@@ -3,6 +3,11 @@
 #ifndef _HASH_H
 #define _HASH_H
 
+#include <stddef.h>
+#include <stdatomic.h>
+
+#include "../config.h"
+
 #define TABLE_SIZE 100
 
 typedef struct node {
@@ -20,4 +25,53 @@ hash_table *create_hash_table();
 void insert(hash_table *htable, char *key, int value);
 int search(hash_table *htable, char *key);
 
-#endif // _HASH_H
\ No newline at end of file
+/*
+ * Open-addressing table keyed on reduced big-integer residues.
+ *
+ * Each slot is one u64: the high 32 bits hold a fingerprint of the residue and
+ * the low 32 bits hold (index + 1), so an all-zero slot is empty. Only the
+ * fingerprint is stored, never the residue itself, so a hit is a candidate that
+ * the caller has to confirm. Collisions are resolved with linear probing and
+ * the capacity is always a power of two.
+ */
+#define RESIDUE_INDEX_MAX 0xFFFFFFFEULL
+
+typedef struct residue_table {
+    u64 *slots;
+    size_t mask;
+    size_t count;
+} residue_table;
+
+u64 hash_residue(const WORD *val, int wordlen);
+residue_table *create_residue_table(size_t capacity);
+void delete_residue_table(residue_table **ptable);
+void residue_insert(residue_table *table, u64 hash, u64 index);
+int residue_search(const residue_table *table, u64 hash, size_t *cursor, u64 *index);
+
+/*
+ * Lock-free table of distinguished points shared by parallel random walks.
+ *
+ * Every record is record_words WORDs: the first key_words hold the point and
+ * the rest are caller-defined payload (e.g. the walk coefficients). A slot is
+ * claimed with one compare-and-swap on its tag and published by setting the
+ * tag's low bit once the record has been written, so readers never see a
+ * half-written record. Records are never removed.
+ */
+#define DP_INSERTED  0
+#define DP_COLLISION 1
+#define DP_FULL      2
+
+typedef struct dp_table {
+    _Atomic u64 *tags;
+    WORD *records;
+    int key_words;
+    int record_words;
+    size_t mask;
+    _Atomic size_t count;
+} dp_table;
+
+dp_table *create_dp_table(size_t capacity, int key_words, int record_words);
+void delete_dp_table(dp_table **ptable);
+int dp_insert(dp_table *table, u64 hash, const WORD *record, const WORD **other);
+
+#endif // _HASH_H
@@ -104,13 +104,35 @@ int main() {
 
     // corretTEST_BinDIV(TEST_ITERATIONS);
     // corretTEST_GenDIV(TEST_ITERATIONS);
+    // corretTEST_KnuthDIV(TEST_ITERATIONS);
+    // corretTEST_BZDIV(TEST_ITERATIONS);
+    // corretTEST_DivInvariant(TEST_ITERATIONS);
 
     // corretTEST_EXP_MOD_L2R(TEST_ITERATIONS);
     // corretTEST_EXP_MOD_R2L(TEST_ITERATIONS);
     // corretTEST_EXP_MOD_Montgomery(TEST_ITERATIONS);
+    // corretTEST_EXP_MOD_KAry(TEST_ITERATIONS);
+    // corretTEST_EXP_MOD_Sliding(TEST_ITERATIONS);
+    // corretTEST_EXP_MOD_Multi(TEST_ITERATIONS);
 
+    // corretTEST_MontMul(TEST_ITERATIONS);
+    // corretTEST_BarrettMul(TEST_ITERATIONS);
+    // corretTEST_FixedBase(TEST_ITERATIONS);
+    // corretTEST_Arena(TEST_ITERATIONS);
+    // corretTEST_Mpn(TEST_ITERATIONS);
+    // corretTEST_Toom(TEST_ITERATIONS);
+    // corretTEST_FFT(TEST_ITERATIONS);
     // corretTEST_BarrettRed(TEST_ITERATIONS);
     // corretTEST_EEA(TEST_ITERATIONS);
+    // corretTEST_HGCD(TEST_ITERATIONS);
+    // corretTEST_BinaryGCD(TEST_ITERATIONS);
+    // corretTEST_SafeGCD(TEST_ITERATIONS);
+
+    // corretTEST_BSGS(TEST_ITERATIONS);
+    // corretTEST_Rho(TEST_ITERATIONS);
+    // corretTEST_PohligHellman(TEST_ITERATIONS);
+    // corretTEST_Kangaroo(TEST_ITERATIONS);
+    // corretTEST_IndexCalculus(TEST_ITERATIONS);
 
     /*
     * ********************** Use 'make speed-mul' **********************
@@ -127,5 +149,6 @@ int main() {
     */
     performTEST_DIV(TEST_ITERATIONS);
 
+    bint_arena_release_thread();
     return 0;
 }
\ No newline at end of file
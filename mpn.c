@@ -0,0 +1,1833 @@
+/**
+ * @file mpn.c
+ * @brief Implementation of the low-level word-array kernels.
+ *
+ * This file contains the allocation-free kernels declared in mpn.h: carry
+ * propagating addition and subtraction, single-word multiply-accumulate rows,
+ * shifts, schoolbook, Karatsuba, Toom-Cook and NTT multiplication on caller
+ * scratch, schoolbook and Burnikel-Ziegler division for the BINT division
+ * routines, Newton reciprocals for division by invariant divisors, and the
+ * Lehmer steps of the extended GCD, the binary GCD and constant-time
+ * modular inversion.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mpn.h"
+
+#define WORD_MAX ((WORD)~(WORD)0)
+
+// Native 64-bit words on x86-64 chain their carries through the flags (adc/sbb); products use the DWORD type,
+// which is unsigned __int128 there and compiles to single 64x64 -> 128 multiplies
+#if WORD_BITLEN == 64 && defined(__x86_64__)
+#include <x86intrin.h>
+#define MPN_CARRY_INTRINSICS
+#endif
+
+int mpn_mul_karatsuba_threshold = MPN_MUL_KARATSUBA_THRESHOLD;
+int mpn_sqr_karatsuba_threshold = MPN_SQR_KARATSUBA_THRESHOLD;
+int mpn_mul_toom3_threshold = MPN_MUL_TOOM3_THRESHOLD;
+int mpn_sqr_toom3_threshold = MPN_SQR_TOOM3_THRESHOLD;
+int mpn_mul_toom4_threshold = MPN_MUL_TOOM4_THRESHOLD;
+int mpn_sqr_toom4_threshold = MPN_SQR_TOOM4_THRESHOLD;
+int mpn_mul_fft_threshold = MPN_MUL_FFT_THRESHOLD;
+int mpn_sqr_fft_threshold = MPN_SQR_FFT_THRESHOLD;
+int mpn_div_bz_threshold = MPN_DIV_BZ_THRESHOLD;
+int mpn_hgcd_threshold = MPN_HGCD_THRESHOLD;
+
+void mpn_zero(WORD* rp, int n) {
+    if (n > 0)
+        memset(rp, 0, n * sizeof(WORD));
+}
+
+void mpn_copy(WORD* rp, const WORD* ap, int n) {
+    if (n > 0 && rp != ap)
+        memmove(rp, ap, n * sizeof(WORD));
+}
+
+int mpn_normalize(const WORD* ap, int n) {
+    while (n > 0 && ap[n - 1] == 0)
+        n--;
+    return n;
+}
+
+int mpn_cmp(const WORD* ap, const WORD* bp, int n) {
+    for (int i = n - 1; i >= 0; i--) {
+        if (ap[i] != bp[i])
+            return ap[i] > bp[i] ? 1 : -1;
+    }
+    return 0;
+}
+
+// One word of an add or subtract chain; the carry or borrow stays in a register from word to word
+#ifdef MPN_CARRY_INTRINSICS
+#define ADD_STEP(i) cf = _addcarry_u64(cf, ap[i], bp[i], &rp[i])
+#define SUB_STEP(i) cf = _subborrow_u64(cf, ap[i], bp[i], &rp[i])
+#else
+#define ADD_STEP(i) do { DWORD s = (DWORD)ap[i] + bp[i] + cf; rp[i] = (WORD)s; cf = (WORD)(s >> WORD_BITLEN); } while (0)
+#define SUB_STEP(i) do { DWORD d = (DWORD)ap[i] - bp[i] - cf; rp[i] = (WORD)d; cf = (WORD)(d >> WORD_BITLEN) & 1; } while (0)
+#endif
+
+WORD mpn_add_n(WORD* rp, const WORD* ap, const WORD* bp, int n) {
+#ifdef MPN_CARRY_INTRINSICS
+    unsigned char cf = 0;
+#else
+    WORD cf = 0;
+#endif
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        ADD_STEP(i); ADD_STEP(i + 1); ADD_STEP(i + 2); ADD_STEP(i + 3);
+    }
+    for (; i < n; i++)
+        ADD_STEP(i);
+    return cf;
+}
+
+WORD mpn_sub_n(WORD* rp, const WORD* ap, const WORD* bp, int n) {
+#ifdef MPN_CARRY_INTRINSICS
+    unsigned char cf = 0;
+#else
+    WORD cf = 0;
+#endif
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        SUB_STEP(i); SUB_STEP(i + 1); SUB_STEP(i + 2); SUB_STEP(i + 3);
+    }
+    for (; i < n; i++)
+        SUB_STEP(i);
+    return cf;
+}
+
+#undef ADD_STEP
+#undef SUB_STEP
+
+WORD mpn_add_1(WORD* rp, const WORD* ap, int an, WORD b) {
+    int i = 0;
+    for (; i < an && b != 0; i++) {
+        WORD r = (WORD)(ap[i] + b);
+        b = r < b;
+        rp[i] = r;
+    }
+    // Once the carry dies out the rest is a copy, and nothing at all in place
+    mpn_copy(rp + i, ap + i, an - i);
+    return b;
+}
+
+WORD mpn_sub_1(WORD* rp, const WORD* ap, int an, WORD b) {
+    int i = 0;
+    for (; i < an && b != 0; i++) {
+        WORD a = ap[i];
+        rp[i] = (WORD)(a - b);
+        b = a < b;
+    }
+    mpn_copy(rp + i, ap + i, an - i);
+    return b;
+}
+
+WORD mpn_add(WORD* rp, const WORD* ap, int an, const WORD* bp, int bn) {
+    WORD carry = mpn_add_n(rp, ap, bp, bn);
+    return mpn_add_1(rp + bn, ap + bn, an - bn, carry);
+}
+
+WORD mpn_sub(WORD* rp, const WORD* ap, int an, const WORD* bp, int bn) {
+    WORD borrow = mpn_sub_n(rp, ap, bp, bn);
+    return mpn_sub_1(rp + bn, ap + bn, an - bn, borrow);
+}
+
+WORD mpn_mul_1(WORD* rp, const WORD* ap, int n, WORD b) {
+    DWORD c = 0;
+    for (int i = 0; i < n; i++) {
+        c += (DWORD)ap[i] * b;
+        rp[i] = (WORD)c;
+        c >>= WORD_BITLEN;
+    }
+    return (WORD)c;
+}
+
+WORD mpn_addmul_1(WORD* rp, const WORD* ap, int n, WORD b) {
+    DWORD c = 0;
+    for (int i = 0; i < n; i++) {
+        c += (DWORD)ap[i] * b + rp[i];
+        rp[i] = (WORD)c;
+        c >>= WORD_BITLEN;
+    }
+    return (WORD)c;
+}
+
+WORD mpn_submul_1(WORD* rp, const WORD* ap, int n, WORD b) {
+    WORD borrow = 0;
+    for (int i = 0; i < n; i++) {
+        DWORD p = (DWORD)ap[i] * b + borrow;
+        WORD lo = (WORD)p, r = rp[i];
+        rp[i] = (WORD)(r - lo);
+        borrow = (WORD)(p >> WORD_BITLEN) + (r < lo);
+    }
+    return borrow;
+}
+
+WORD mpn_lshift(WORD* rp, const WORD* ap, int n, int cnt) {
+    WORD out = (WORD)(ap[n - 1] >> (WORD_BITLEN - cnt));
+    for (int i = n - 1; i > 0; i--)
+        rp[i] = (WORD)((ap[i] << cnt) | (ap[i - 1] >> (WORD_BITLEN - cnt)));
+    rp[0] = (WORD)(ap[0] << cnt);
+    return out;
+}
+
+WORD mpn_rshift(WORD* rp, const WORD* ap, int n, int cnt) {
+    WORD out = (WORD)(ap[0] << (WORD_BITLEN - cnt));
+    for (int i = 0; i < n - 1; i++)
+        rp[i] = (WORD)((ap[i] >> cnt) | (ap[i + 1] << (WORD_BITLEN - cnt)));
+    rp[n - 1] = (WORD)(ap[n - 1] >> cnt);
+    return out;
+}
+
+void mpn_mul_basecase(WORD* rp, const WORD* ap, int an, const WORD* bp, int bn) {
+    rp[an] = mpn_mul_1(rp, ap, an, bp[0]);
+    for (int i = 1; i < bn; i++)
+        rp[an + i] = mpn_addmul_1(rp + i, ap, an, bp[i]);
+}
+
+void mpn_sqr_basecase(WORD* rp, const WORD* ap, int n) {
+    // Cross products a[i] * a[j] for i < j, each once
+    mpn_zero(rp, 2 * n);
+    for (int i = 0; i < n - 1; i++)
+        rp[i + n] = mpn_addmul_1(rp + 2 * i + 1, ap + i + 1, n - 1 - i, ap[i]);
+    rp[2 * n - 1] = mpn_lshift(rp, rp, 2 * n - 1, 1);
+
+    // Plus the squares on the diagonal
+    DWORD c = 0;
+    for (int i = 0; i < n; i++) {
+        c += (DWORD)ap[i] * ap[i] + rp[2 * i];
+        rp[2 * i] = (WORD)c;
+        c >>= WORD_BITLEN;
+        c += rp[2 * i + 1];
+        rp[2 * i + 1] = (WORD)c;
+        c >>= WORD_BITLEN;
+    }
+}
+
+// Column k of a product: the sum of its terms sits in a three-word accumulator, the low two words in acc and
+// the third in top. Each column is written once and what is left moves down a word for the next one.
+#define COMBA_ADD(p) do { DWORD t_ = (p); acc += t_; top += acc < t_; } while (0)
+#define COMBA_STORE(k) do { rp[k] = (WORD)acc; acc = (acc >> WORD_BITLEN) + ((DWORD)top << WORD_BITLEN); top = 0; } while (0)
+
+void mpn_mul_comba(WORD* rp, const WORD* ap, int an, const WORD* bp, int bn) {
+    DWORD acc = 0;
+    WORD top = 0;
+    for (int k = 0; k < an + bn - 1; k++) {
+        int lo = k < bn ? 0 : k - bn + 1;
+        int hi = k < an ? k : an - 1;
+        for (int i = lo; i <= hi; i++)
+            COMBA_ADD((DWORD)ap[i] * bp[k - i]);
+        COMBA_STORE(k);
+    }
+    rp[an + bn - 1] = (WORD)acc;
+}
+
+void mpn_sqr_comba(WORD* rp, const WORD* ap, int n) {
+    DWORD acc = 0;
+    WORD top = 0;
+    for (int k = 0; k < 2 * n - 1; k++) {
+        // The cross products a[i] * a[k - i] with i < k - i, summed once and then added twice
+        DWORD cross = 0;
+        WORD ctop = 0;
+        for (int i = k < n ? 0 : k - n + 1; 2 * i < k; i++) {
+            DWORD t = (DWORD)ap[i] * ap[k - i];
+            cross += t;
+            ctop += cross < t;
+        }
+        acc += cross;
+        top += ctop + (acc < cross);
+        acc += cross;
+        top += ctop + (acc < cross);
+        if ((k & 1) == 0)
+            COMBA_ADD((DWORD)ap[k / 2] * ap[k / 2]);
+        COMBA_STORE(k);
+    }
+    rp[2 * n - 1] = (WORD)acc;
+}
+
+#undef COMBA_ADD
+#undef COMBA_STORE
+
+// Karatsuba leaves. Product scanning wins once the column sums run in 64-bit registers; with narrower words
+// the DWORD accumulator is no wider than a row's carry and the addmul_1 rows are faster.
+#if WORD_BITLEN == 64
+#define mpn_mul_leaf(rp, ap, bp, n) mpn_mul_comba(rp, ap, n, bp, n)
+#define mpn_sqr_leaf(rp, ap, n) mpn_sqr_comba(rp, ap, n)
+#else
+#define mpn_mul_leaf(rp, ap, bp, n) mpn_mul_basecase(rp, ap, n, bp, n)
+#define mpn_sqr_leaf(rp, ap, n) mpn_sqr_basecase(rp, ap, n)
+#endif
+
+// rp <- |a - b| in an words for an >= bn; returns 1 when b > a
+static int mpn_abs_sub(WORD* rp, const WORD* ap, int an, const WORD* bp, int bn) {
+    if (mpn_normalize(ap + bn, an - bn) > 0 || mpn_cmp(ap, bp, bn) >= 0) {
+        mpn_sub(rp, ap, an, bp, bn);
+        return 0;
+    }
+    mpn_sub_n(rp, bp, ap, bn);
+    mpn_zero(rp + bn, an - bn);
+    return 1;
+}
+
+// rp <- ap / d for an odd d that divides ap exactly, by Hensel division with the inverse of d mod W
+static void mpn_divexact_1(WORD* rp, const WORD* ap, int n, WORD d) {
+    WORD inv = d;                               // right in the low three bits, since d * d = 1 mod 8
+    for (int i = 0; i < 5; i++)                 // each Newton step doubles the correct bits
+        inv = (WORD)(inv * (WORD)(2 - (WORD)(d * inv)));
+    WORD c = 0;
+    for (int i = 0; i < n; i++) {
+        WORD s = ap[i];
+        WORD x = (WORD)(s - c);
+        c = x > s;
+        WORD q = (WORD)(x * inv);
+        rp[i] = q;
+        c += (WORD)(((DWORD)q * d) >> WORD_BITLEN);
+    }
+}
+
+// rp <- rp - ap * b for an n-word ap inside the rn-word rp, when the difference is known to be nonnegative
+static void mpn_submul_small(WORD* rp, int rn, const WORD* ap, int n, WORD b) {
+    WORD borrow = mpn_submul_1(rp, ap, n, b);
+    if (n < rn)
+        mpn_sub_1(rp + n, rp + n, rn - n, borrow);
+}
+
+// Three-prime NTT multiplication. The operands are cut into 32-bit chunks and multiplied as polynomials modulo
+// three primes below 2^31 whose multiplicative groups hold 2^24-th roots of unity. A transform has at most 2^24
+// points, so a product coefficient stays below 2^23 * 2^64 < p0 * p1 * p2 and the Chinese remainder theorem
+// recovers it exactly. Residues stay in [0, p); products go through Montgomery reduction with R = 2^32, and the
+// twiddles carry the factor R, so data times twiddle comes out in plain form.
+#define NTT_MAX_LOG 24
+
+static const u32 NTT_PRIMES[3] = { 2013265921u, 469762049u, 754974721u };  // 15 * 2^27 + 1, 7 * 2^26 + 1, 45 * 2^24 + 1
+static const u32 NTT_GENERATORS[3] = { 31, 3, 11 };
+
+typedef struct {
+    u32 p;
+    u32 pinv;  // p^-1 mod 2^32
+    u32 r1;    // R mod p
+} ntt_mod;
+
+static void ntt_init(ntt_mod* m, u32 p) {
+    u32 inv = p;                    // right in the low three bits for odd p
+    for (int i = 0; i < 4; i++)
+        inv *= 2 - p * inv;
+    m->p = p;
+    m->pinv = inv;
+    m->r1 = (u32)((1ULL << 32) % p);
+}
+
+// a * b / R mod p, for a < 2^32 and b < p. The low halves of a * b and q * p agree, so the high halves differ by
+// the result, in (-p, p).
+static inline u32 ntt_mul(u32 a, u32 b, const ntt_mod* m) {
+    u64 t = (u64)a * b;
+    u32 q = (u32)t * m->pinv;
+    u32 r = (u32)(t >> 32) - (u32)(((u64)q * m->p) >> 32);
+    return (r >> 31) ? r + m->p : r;
+}
+
+static inline u32 ntt_add(u32 a, u32 b, u32 p) {
+    u32 s = a + b;
+    return s >= p ? s - p : s;
+}
+
+static inline u32 ntt_sub(u32 a, u32 b, u32 p) {
+    u32 d = a - b;
+    return (d >> 31) ? d + p : d;
+}
+
+// b^e mod p in plain form, for the constants of a call
+static u32 ntt_powmod(u32 b, u64 e, u32 p) {
+    u64 r = 1, x = b % p;
+    for (; e > 0; e >>= 1) {
+        if (e & 1)
+            r = r * x % p;
+        x = x * x % p;
+    }
+    return (u32)r;
+}
+
+// Montgomery form of a plain residue x < p
+static u32 ntt_to_mont(u32 x, u32 p) {
+    return (u32)(((u64)x << 32) % p);
+}
+
+// Fills the lower stages of a twiddle table from its top stage, with w_{2 len}^j = w_{4 len}^{2 j}
+static void ntt_twiddles_down(u32* tw, int N) {
+    for (int len = N / 4; len >= 1; len /= 2)
+        for (int j = 0; j < len; j++)
+            tw[len + j] = tw[2 * len + 2 * j];
+}
+
+// tw[len + j] <- w_{2 len}^j * R and itw[len + j] <- w_{2 len}^-j * R for every stage len = 1, 2, .., N / 2 and
+// j < len, where w_N = w is a primitive N-th root of unity; each stage reads its twiddles contiguously. The top
+// stage runs as eight interleaved chains of powers, and w^-j = -w^(N/2 - j) gives the inverse table.
+static void ntt_twiddles(u32* tw, u32* itw, int N, u32 w, const ntt_mod* m) {
+    int h = N / 2;
+    if (h < 1)
+        return;
+    u32 wm = ntt_to_mont(w, m->p), w8 = ntt_to_mont(ntt_powmod(w, 8, m->p), m->p);
+    tw[h] = m->r1;
+    for (int j = 1; j < h && j < 8; j++)
+        tw[h + j] = ntt_mul(tw[h + j - 1], wm, m);
+    for (int j = 8; j < h; j++)
+        tw[h + j] = ntt_mul(tw[h + j - 8], w8, m);
+    itw[h] = m->r1;
+    for (int j = 1; j < h; j++)
+        itw[h + j] = m->p - tw[N - j];
+    ntt_twiddles_down(tw, N);
+    ntt_twiddles_down(itw, N);
+}
+
+// One decimation-in-frequency stage: natural order in, bit-reversed order out after all stages
+static void ntt_dif_stage(u32* a, int N, int len, const u32* tw, const ntt_mod* m) {
+    for (int i = 0; i < N; i += 2 * len)
+        for (int j = 0; j < len; j++) {
+            u32 u = a[i + j], v = a[i + j + len];
+            a[i + j] = ntt_add(u, v, m->p);
+            a[i + j + len] = ntt_mul(ntt_sub(u, v, m->p), tw[len + j], m);
+        }
+}
+
+// One decimation-in-time stage with the inverse twiddles: bit-reversed order in, natural order out
+static void ntt_dit_stage(u32* a, int N, int len, const u32* tw, const ntt_mod* m) {
+    for (int i = 0; i < N; i += 2 * len)
+        for (int j = 0; j < len; j++) {
+            u32 u = a[i + j], v = ntt_mul(a[i + j + len], tw[len + j], m);
+            a[i + j] = ntt_add(u, v, m->p);
+            a[i + j + len] = ntt_sub(u, v, m->p);
+        }
+}
+
+// a[k] <- a[k] * b[k] * c / R^2
+static void ntt_pointwise(u32* a, const u32* b, int N, u32 c, const ntt_mod* m) {
+    for (int k = 0; k < N; k++)
+        a[k] = ntt_mul(ntt_mul(a[k], b[k], m), c, m);
+}
+
+// The butterflies and the pointwise products, eight residues at a time, for transforms of at least 16 points. AVX2 has a
+// 32 x 32 -> 64 multiply on the even lanes, so the odd lanes are shifted down and the high halves blended back.
+// Compiled for AVX2 regardless of the build flags and chosen at run time.
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define MPN_NTT_AVX2
+#define NTT_AVX2 __attribute__((target("avx2")))
+
+NTT_AVX2 static inline __m256i ntt_mul_avx2(__m256i a, __m256i b, __m256i p, __m256i pinv) {
+    __m256i t0 = _mm256_mul_epu32(a, b);
+    __m256i t1 = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+    __m256i q0 = _mm256_mul_epu32(_mm256_mul_epu32(t0, pinv), p);
+    __m256i q1 = _mm256_mul_epu32(_mm256_mul_epu32(t1, pinv), p);
+    __m256i th = _mm256_blend_epi32(_mm256_srli_epi64(t0, 32), t1, 0xAA);
+    __m256i qh = _mm256_blend_epi32(_mm256_srli_epi64(q0, 32), q1, 0xAA);
+    __m256i r = _mm256_sub_epi32(th, qh);
+    return _mm256_min_epu32(r, _mm256_add_epi32(r, p));
+}
+
+NTT_AVX2 static inline __m256i ntt_add_avx2(__m256i a, __m256i b, __m256i p) {
+    __m256i s = _mm256_add_epi32(a, b);
+    return _mm256_min_epu32(s, _mm256_sub_epi32(s, p));
+}
+
+NTT_AVX2 static inline __m256i ntt_sub_avx2(__m256i a, __m256i b, __m256i p) {
+    __m256i d = _mm256_sub_epi32(a, b);
+    return _mm256_min_epu32(d, _mm256_add_epi32(d, p));
+}
+
+NTT_AVX2 static void ntt_dif_stage_avx2(u32* a, int N, int len, const u32* tw, const ntt_mod* m) {
+    __m256i p = _mm256_set1_epi32((int)m->p), pinv = _mm256_set1_epi32((int)m->pinv);
+    for (int i = 0; i < N; i += 2 * len)
+        for (int j = 0; j < len; j += 8) {
+            __m256i u = _mm256_loadu_si256((const __m256i*)(a + i + j));
+            __m256i v = _mm256_loadu_si256((const __m256i*)(a + i + j + len));
+            __m256i w = _mm256_loadu_si256((const __m256i*)(tw + len + j));
+            _mm256_storeu_si256((__m256i*)(a + i + j), ntt_add_avx2(u, v, p));
+            _mm256_storeu_si256((__m256i*)(a + i + j + len), ntt_mul_avx2(ntt_sub_avx2(u, v, p), w, p, pinv));
+        }
+}
+
+NTT_AVX2 static void ntt_dit_stage_avx2(u32* a, int N, int len, const u32* tw, const ntt_mod* m) {
+    __m256i p = _mm256_set1_epi32((int)m->p), pinv = _mm256_set1_epi32((int)m->pinv);
+    for (int i = 0; i < N; i += 2 * len)
+        for (int j = 0; j < len; j += 8) {
+            __m256i u = _mm256_loadu_si256((const __m256i*)(a + i + j));
+            __m256i w = _mm256_loadu_si256((const __m256i*)(tw + len + j));
+            __m256i v = ntt_mul_avx2(_mm256_loadu_si256((const __m256i*)(a + i + j + len)), w, p, pinv);
+            _mm256_storeu_si256((__m256i*)(a + i + j), ntt_add_avx2(u, v, p));
+            _mm256_storeu_si256((__m256i*)(a + i + j + len), ntt_sub_avx2(u, v, p));
+        }
+}
+
+// The stages len = 4, 2, 1 pair up residues inside a vector. Two vectors X, Y of a 16-residue block are
+// shuffled into U, holding the u of every butterfly, and V, holding the v, and back after the butterflies.
+// Stage len = 4: U = (X.lo, Y.lo), V = (X.hi, Y.hi). Stage len = 2: 64-bit unpacks. Stage len = 1: even and
+// odd lanes, with the twiddle w_2^0 = 1 and no multiply.
+NTT_AVX2 static inline void ntt_split4(__m256i x, __m256i y, __m256i* u, __m256i* v) {
+    *u = _mm256_permute2x128_si256(x, y, 0x20);
+    *v = _mm256_permute2x128_si256(x, y, 0x31);
+}
+
+NTT_AVX2 static inline void ntt_split2(__m256i x, __m256i y, __m256i* u, __m256i* v) {
+    *u = _mm256_unpacklo_epi64(x, y);
+    *v = _mm256_unpackhi_epi64(x, y);
+}
+
+NTT_AVX2 static inline void ntt_split1(__m256i x, __m256i y, __m256i* u, __m256i* v) {
+    *u = _mm256_blend_epi32(x, _mm256_slli_epi64(y, 32), 0xAA);
+    *v = _mm256_blend_epi32(_mm256_srli_epi64(x, 32), y, 0xAA);
+}
+
+// The last three forward stages. Applied to the butterfly outputs, the len = 4 and len = 2 splits put the
+// residues back in place; the even/odd split is undone by interleaving.
+NTT_AVX2 static void ntt_dif_tail_avx2(u32* a, int N, const u32* tw, const ntt_mod* m) {
+    __m256i p = _mm256_set1_epi32((int)m->p), pinv = _mm256_set1_epi32((int)m->pinv);
+    __m256i w4 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(tw + 4)));
+    __m256i w2 = _mm256_set1_epi64x((long long)(((u64)tw[3] << 32) | tw[2]));
+    for (int i = 0; i < N; i += 16) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i*)(a + i + 8));
+        __m256i u, v, s, d;
+        ntt_split4(x, y, &u, &v);
+        s = ntt_add_avx2(u, v, p);
+        d = ntt_mul_avx2(ntt_sub_avx2(u, v, p), w4, p, pinv);
+        ntt_split4(s, d, &x, &y);
+        ntt_split2(x, y, &u, &v);
+        s = ntt_add_avx2(u, v, p);
+        d = ntt_mul_avx2(ntt_sub_avx2(u, v, p), w2, p, pinv);
+        ntt_split2(s, d, &x, &y);
+        ntt_split1(x, y, &u, &v);
+        s = ntt_add_avx2(u, v, p);
+        d = ntt_sub_avx2(u, v, p);
+        x = _mm256_blend_epi32(s, _mm256_slli_epi64(d, 32), 0xAA);
+        y = _mm256_blend_epi32(_mm256_srli_epi64(s, 32), d, 0xAA);
+        _mm256_storeu_si256((__m256i*)(a + i), x);
+        _mm256_storeu_si256((__m256i*)(a + i + 8), y);
+    }
+}
+
+// The first three inverse stages, mirroring ntt_dif_tail_avx2
+NTT_AVX2 static void ntt_dit_head_avx2(u32* a, int N, const u32* tw, const ntt_mod* m) {
+    __m256i p = _mm256_set1_epi32((int)m->p), pinv = _mm256_set1_epi32((int)m->pinv);
+    __m256i w4 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(tw + 4)));
+    __m256i w2 = _mm256_set1_epi64x((long long)(((u64)tw[3] << 32) | tw[2]));
+    for (int i = 0; i < N; i += 16) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i*)(a + i + 8));
+        __m256i u, v, s, d;
+        ntt_split1(x, y, &u, &v);
+        s = ntt_add_avx2(u, v, p);
+        d = ntt_sub_avx2(u, v, p);
+        x = _mm256_blend_epi32(s, _mm256_slli_epi64(d, 32), 0xAA);
+        y = _mm256_blend_epi32(_mm256_srli_epi64(s, 32), d, 0xAA);
+        ntt_split2(x, y, &u, &v);
+        v = ntt_mul_avx2(v, w2, p, pinv);
+        ntt_split2(ntt_add_avx2(u, v, p), ntt_sub_avx2(u, v, p), &x, &y);
+        ntt_split4(x, y, &u, &v);
+        v = ntt_mul_avx2(v, w4, p, pinv);
+        ntt_split4(ntt_add_avx2(u, v, p), ntt_sub_avx2(u, v, p), &x, &y);
+        _mm256_storeu_si256((__m256i*)(a + i), x);
+        _mm256_storeu_si256((__m256i*)(a + i + 8), y);
+    }
+}
+
+NTT_AVX2 static void ntt_pointwise_avx2(u32* a, const u32* b, int N, u32 c, const ntt_mod* m) {
+    __m256i p = _mm256_set1_epi32((int)m->p), pinv = _mm256_set1_epi32((int)m->pinv);
+    __m256i cv = _mm256_set1_epi32((int)c);
+    for (int k = 0; k < N; k += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + k));
+        __m256i y = _mm256_loadu_si256((const __m256i*)(b + k));
+        _mm256_storeu_si256((__m256i*)(a + k), ntt_mul_avx2(ntt_mul_avx2(x, y, p, pinv), cv, p, pinv));
+    }
+}
+
+static int ntt_have_avx2(void) {
+    static int have = -1;
+    if (have < 0)
+        have = __builtin_cpu_supports("avx2") ? 1 : 0;
+    return have;
+}
+#endif
+
+static void ntt_forward(u32* a, int N, const u32* tw, const ntt_mod* m) {
+#ifdef MPN_NTT_AVX2
+    if (N >= 16 && ntt_have_avx2()) {
+        for (int len = N / 2; len >= 8; len /= 2)
+            ntt_dif_stage_avx2(a, N, len, tw, m);
+        ntt_dif_tail_avx2(a, N, tw, m);
+        return;
+    }
+#endif
+    for (int len = N / 2; len >= 1; len /= 2)
+        ntt_dif_stage(a, N, len, tw, m);
+}
+
+static void ntt_inverse(u32* a, int N, const u32* tw, const ntt_mod* m) {
+#ifdef MPN_NTT_AVX2
+    if (N >= 16 && ntt_have_avx2()) {
+        ntt_dit_head_avx2(a, N, tw, m);
+        for (int len = 8; len < N; len *= 2)
+            ntt_dit_stage_avx2(a, N, len, tw, m);
+        return;
+    }
+#endif
+    for (int len = 1; len < N; len *= 2)
+        ntt_dit_stage(a, N, len, tw, m);
+}
+
+static void ntt_product(u32* a, const u32* b, int N, u32 c, const ntt_mod* m) {
+#ifdef MPN_NTT_AVX2
+    if (N >= 8 && ntt_have_avx2()) {
+        ntt_pointwise_avx2(a, b, N, c, m);
+        return;
+    }
+#endif
+    ntt_pointwise(a, b, N, c, m);
+}
+
+// Number of 32-bit chunks in n words
+static int ntt_chunks(int n) {
+    return (int)(((long long)n * WORD_BITLEN + 31) / 32);
+}
+
+// Chunk i of the n-word ap, bits 32 * i to 32 * i + 31
+static u32 ntt_get_chunk(const WORD* ap, int n, int i) {
+#if WORD_BITLEN == 64
+    (void)n;
+    return (u32)(ap[i / 2] >> (32 * (i & 1)));
+#else
+    u32 c = 0;
+    for (int j = 0, w = i * (32 / WORD_BITLEN); j < 32 / WORD_BITLEN && w < n; j++, w++)
+        c |= (u32)ap[w] << (j * WORD_BITLEN);
+    return c;
+#endif
+}
+
+static void ntt_put_chunk(WORD* rp, int n, int i, u32 c) {
+#if WORD_BITLEN == 64
+    (void)n;
+    if (i & 1)
+        rp[i / 2] |= (WORD)c << 32;
+    else
+        rp[i / 2] = c;
+#else
+    for (int j = 0, w = i * (32 / WORD_BITLEN); j < 32 / WORD_BITLEN && w < n; j++, w++)
+        rp[w] = (WORD)(c >> (j * WORD_BITLEN));
+#endif
+}
+
+// Points of the transform for an an-word by bn-word product
+static int ntt_size(int an, int bn) {
+    int N = 1;
+    while (N < ntt_chunks(an) + ntt_chunks(bn) - 1)
+        N *= 2;
+    return N;
+}
+
+// Whether an an-word by bn-word product fits the largest transform
+static bool ntt_fits(int an, int bn) {
+    return (long long)(an + bn) * WORD_BITLEN < (1LL << (NTT_MAX_LOG + 5));
+}
+
+int mpn_mul_fft_itch(int an, int bn) {
+    // Three residue vectors, the second operand and two twiddle tables of N residues each, plus room to align
+    long long bits = (6LL * ntt_size(an, bn) + 8) * 32;
+    return (int)((bits + WORD_BITLEN - 1) / WORD_BITLEN);
+}
+
+// Transforms one operand modulo m into N residues at f
+static void ntt_load(u32* f, int N, const WORD* ap, int an, const u32* tw, const ntt_mod* m) {
+    int ca = ntt_chunks(an);
+    for (int k = 0; k < ca; k++)
+        f[k] = ntt_mul(ntt_get_chunk(ap, an, k), m->r1, m);   // chunk mod p
+    for (int k = ca; k < N; k++)
+        f[k] = 0;
+    ntt_forward(f, N, tw, m);
+}
+
+static void mpn_mul_ntt(WORD* rp, const WORD* ap, int an, const WORD* bp, int bn, WORD* ws, bool sqr) {
+    int N = ntt_size(an, bn);
+    u32* res = (u32*)(((uintptr_t)ws + 31) & ~(uintptr_t)31);
+    u32* fb = res + 3 * N;
+    u32* tw = fb + N;
+    u32* itw = tw + N;
+    ntt_mod m[3];
+
+    for (int i = 0; i < 3; i++) {
+        u32 p = NTT_PRIMES[i];
+        ntt_init(&m[i], p);
+        u32 w = ntt_powmod(NTT_GENERATORS[i], (p - 1) / N, p);
+        ntt_twiddles(tw, itw, N, w, &m[i]);
+        // The pointwise step multiplies by N^-1 * R^2, which cancels both reductions and the inverse's factor N
+        u32 scale = ntt_to_mont(ntt_to_mont(ntt_powmod(N, p - 2, p), p), p);
+
+        u32* fa = res + i * N;
+        ntt_load(fa, N, ap, an, tw, &m[i]);
+        if (sqr) {
+            ntt_product(fa, fa, N, scale, &m[i]);
+        } else {
+            ntt_load(fb, N, bp, bn, tw, &m[i]);
+            ntt_product(fa, fb, N, scale, &m[i]);
+        }
+        ntt_inverse(fa, N, itw, &m[i]);
+    }
+
+    // Garner: x = x0 + p0 * t1 with t1 = (x1 - x0) / p0 mod p1, then x + p0 * p1 * t2 with t2 = (x2 - x) / (p0 p1)
+    // mod p2; the constants are in Montgomery form so that ntt_mul yields plain products
+    u32 p0 = NTT_PRIMES[0], p1 = NTT_PRIMES[1], p2 = NTT_PRIMES[2];
+    u64 p01 = (u64)p0 * p1;
+    u32 c1 = ntt_to_mont(ntt_powmod(p0, p1 - 2, p1), p1);
+    u32 c2 = ntt_to_mont(ntt_powmod((u32)(p01 % p2), p2 - 2, p2), p2);
+    u32 p0m2 = ntt_to_mont(p0 % p2, p2);
+    u32 carry0 = 0, carry1 = 0, carry2 = 0;
+    int rn = an + bn, cr = ntt_chunks(rn);
+    for (int k = 0; k < cr; k++) {
+        u64 lo = 0, hi = 0, y = 0;
+        if (k < N) {
+            u32 x0 = res[k], x1 = res[N + k], x2 = res[2 * N + k];
+            u32 t1 = ntt_mul(ntt_sub(x1, ntt_mul(x0, m[1].r1, &m[1]), p1), c1, &m[1]);
+            y = x0 + (u64)p0 * t1;
+            u32 y2 = ntt_add(ntt_mul(x0, m[2].r1, &m[2]), ntt_mul(t1, p0m2, &m[2]), p2);
+            u32 t2 = ntt_mul(ntt_sub(x2, y2, p2), c2, &m[2]);
+            lo = (u64)(u32)p01 * t2;
+            hi = (p01 >> 32) * t2;
+        }
+        // The coefficient y + lo + hi * 2^32 joins the carry; its low 32 bits are the chunk
+        u64 s = (lo & 0xFFFFFFFFu) + (y & 0xFFFFFFFFu) + carry0;
+        ntt_put_chunk(rp, rn, k, (u32)s);
+        s = (s >> 32) + (lo >> 32) + (hi & 0xFFFFFFFFu) + (y >> 32) + carry1;
+        carry0 = (u32)s;
+        s = (s >> 32) + (hi >> 32) + carry2;
+        carry1 = (u32)s;
+        carry2 = (u32)(s >> 32);
+    }
+}
+
+void mpn_mul_fft(WORD* rp, const WORD* ap, int an, const WORD* bp, int bn, WORD* ws) {
+    mpn_mul_ntt(rp, ap, an, bp, bn, ws, false);
+}
+
+void mpn_sqr_fft(WORD* rp, const WORD* ap, int n, WORD* ws) {
+    mpn_mul_ntt(rp, ap, n, ap, n, ws, true);
+}
+
+enum { MPN_BASECASE, MPN_KARATSUBA, MPN_TOOM3, MPN_TOOM4, MPN_FFT };
+
+// The algorithm at the top of an n-word product or square. Toom-r needs every one of its r pieces nonempty.
+static int mpn_mul_alg(int n, bool sqr) {
+    if (n >= (sqr ? mpn_sqr_fft_threshold : mpn_mul_fft_threshold) && ntt_fits(n, n))
+        return MPN_FFT;
+    if (n < (sqr ? mpn_sqr_karatsuba_threshold : mpn_mul_karatsuba_threshold))
+        return MPN_BASECASE;
+    if (n >= (sqr ? mpn_sqr_toom4_threshold : mpn_mul_toom4_threshold) && n - 3 * ((n + 3) / 4) >= 1)
+        return MPN_TOOM4;
+    if (n >= (sqr ? mpn_sqr_toom3_threshold : mpn_mul_toom3_threshold) && n - 2 * ((n + 2) / 3) >= 1)
+        return MPN_TOOM3;
+    return MPN_KARATSUBA;
+}
+
+// Scratch of one n-word product or square: the buffers of its top level, then the most any sub-product needs
+static int mpn_itch(int n, bool sqr) {
+    int k, s, m, own, sub;
+    switch (mpn_mul_alg(n, sqr)) {
+    case MPN_KARATSUBA:
+        k = n - n / 2;
+        own = 6 * k + 1;
+        sub = MAXIMUM(mpn_itch(k, sqr), mpn_itch(n / 2, sqr));
+        return own + sub;
+    case MPN_TOOM3:
+        k = (n + 2) / 3; s = n - 2 * k; m = k + 1;
+        own = 14 * m;
+        break;
+    case MPN_TOOM4:
+        k = (n + 3) / 4; s = n - 3 * k; m = k + 1;
+        own = 24 * m;
+        break;
+    case MPN_FFT:
+        return mpn_mul_fft_itch(n, n);
+    default:
+        return 0;
+    }
+    sub = MAXIMUM(mpn_itch(m, sqr), mpn_itch(k, sqr));
+    sub = MAXIMUM(sub, mpn_itch(s, sqr));
+    return own + sub;
+}
+
+int mpn_mul_n_itch(int n) {
+    int mul = mpn_itch(n, false), sqr = mpn_itch(n, true);
+    return MAXIMUM(mul, sqr);
+}
+
+// rp <- ap * bp or ap^2 on n words by whichever algorithm fits n; the Toom levels recurse through here
+static void mpn_mul_any(WORD* rp, const WORD* ap, const WORD* bp, int n, WORD* ws, bool sqr) {
+    if (sqr)
+        mpn_sqr_n(rp, ap, n, ws);
+    else
+        mpn_mul_n(rp, ap, bp, n, ws);
+}
+
+// Adds the coefficients c_1 .. c_cnt, each in 2m words at cp, into rp at offsets of k words: rp, 2n words,
+// already holds c_0 at the bottom and the top coefficient at the top, with zeros in between
+static void toom_assemble(WORD* rp, int n, int k, WORD* const* cp, int cnt, int m) {
+    for (int i = 1; i <= cnt; i++) {
+        int cn = mpn_normalize(cp[i - 1], 2 * m);
+        if (cn > 0)
+            mpn_add(rp + i * k, rp + i * k, 2 * n - i * k, cp[i - 1], cn);
+    }
+}
+
+// a(1), |a(-1)| and a(2) of a = a2 x^2 + a1 x + a0 with k-word a0, a1 and s-word a2, in k + 1 words each.
+// Returns 1 when a(-1) < 0.
+static int toom3_eval(WORD* e1, WORD* em, WORD* e2, const WORD* ap, int k, int s) {
+    const WORD *a0 = ap, *a1 = ap + k, *a2 = ap + 2 * k;
+    e1[k] = mpn_add(e1, a0, k, a2, s);
+    int neg = mpn_abs_sub(em, e1, k + 1, a1, k);
+    e1[k] += mpn_add_n(e1, e1, a1, k);
+
+    mpn_copy(e2, a2, s);                        // ((2 a2 + a1) 2 + a0)
+    mpn_zero(e2 + s, k + 1 - s);
+    mpn_lshift(e2, e2, k + 1, 1);
+    mpn_add(e2, e2, k + 1, a1, k);
+    mpn_lshift(e2, e2, k + 1, 1);
+    mpn_add(e2, e2, k + 1, a0, k);
+    return neg;
+}
+
+// Toom-3 on n = 2k + s words: a and b become quadratics in x = W^k, the product c = c4 x^4 + .. + c0 is
+// evaluated at 0, 1, -1, 2 and infinity, and the coefficients are recovered with
+//   c0 = v(0), c4 = v(inf), c0 + c2 + c4 = (v(1) + v(-1)) / 2, c1 + c3 = (v(1) - v(-1)) / 2,
+//   c1 + 4 c3 = (v(2) - c0 - 4 c2 - 16 c4) / 2,
+// where every intermediate value is nonnegative. Scratch: six evaluations of k + 1 words, four buffers of
+// 2k + 2 words, then the recursion.
+static void mpn_toom3(WORD* rp, const WORD* ap, const WORD* bp, int n, WORD* ws, bool sqr) {
+    int k = (n + 2) / 3, s = n - 2 * k, m = k + 1;
+    WORD *ea1 = ws, *eam = ws + m, *ea2 = ws + 2 * m;
+    WORD *eb1 = ws + 3 * m, *ebm = ws + 4 * m, *eb2 = ws + 5 * m;
+    WORD *v1 = ws + 6 * m, *vm = ws + 8 * m, *v2 = ws + 10 * m, *t = ws + 12 * m;
+    WORD* next = ws + 14 * m;
+    WORD* c0 = rp;
+    WORD* c4 = rp + 4 * k;
+
+    int neg = toom3_eval(ea1, eam, ea2, ap, k, s);
+    if (!sqr)
+        neg ^= toom3_eval(eb1, ebm, eb2, bp, k, s);
+    else
+        neg = 0;
+    mpn_mul_any(v1, ea1, sqr ? ea1 : eb1, m, next, sqr);
+    mpn_mul_any(vm, eam, sqr ? eam : ebm, m, next, sqr);
+    mpn_mul_any(v2, ea2, sqr ? ea2 : eb2, m, next, sqr);
+    mpn_mul_any(c0, ap, bp, k, next, sqr);
+    mpn_mul_any(c4, ap + 2 * k, bp + 2 * k, s, next, sqr);
+
+    // t <- c0 + c2 + c4 and vm <- c1 + c3
+    if (neg) {
+        mpn_sub_n(t, v1, vm, 2 * m);
+        mpn_add_n(vm, v1, vm, 2 * m);
+    } else {
+        mpn_add_n(t, v1, vm, 2 * m);
+        mpn_sub_n(vm, v1, vm, 2 * m);
+    }
+    mpn_rshift(t, t, 2 * m, 1);
+    mpn_rshift(vm, vm, 2 * m, 1);
+
+    mpn_sub(t, t, 2 * m, c0, 2 * k);            // t <- c2
+    mpn_sub(t, t, 2 * m, c4, 2 * s);
+    mpn_sub(v2, v2, 2 * m, c0, 2 * k);          // v2 <- c1 + 4 c3
+    mpn_submul_small(v2, 2 * m, t, 2 * m, 4);
+    mpn_submul_small(v2, 2 * m, c4, 2 * s, 16);
+    mpn_rshift(v2, v2, 2 * m, 1);
+    mpn_sub_n(v2, v2, vm, 2 * m);               // v2 <- c3
+    mpn_divexact_1(v2, v2, 2 * m, 3);
+    mpn_sub_n(vm, vm, v2, 2 * m);               // vm <- c1
+
+    mpn_zero(rp + 2 * k, 2 * k);
+    WORD* coef[] = { vm, t, v2 };
+    toom_assemble(rp, n, k, coef, 3, m);
+}
+
+// a(1), |a(-1)|, a(2), |a(-2)| and 8 a(1/2) of a = a3 x^3 + a2 x^2 + a1 x + a0 with k-word a0, a1, a2 and s-word
+// a3, in k + 1 words each; t is k + 1 words of scratch. Bit 0 of the result is set when a(-1) < 0, bit 1 when
+// a(-2) < 0.
+static int toom4_eval(WORD* e1, WORD* em1, WORD* e2, WORD* em2, WORD* eh, const WORD* ap, int k, int s, WORD* t) {
+    const WORD *a0 = ap, *a1 = ap + k, *a2 = ap + 2 * k, *a3 = ap + 3 * k;
+    e1[k] = mpn_add_n(e1, a0, a2, k);           // even part a0 + a2
+    t[k] = mpn_add(t, a1, k, a3, s);            // odd part a1 + a3
+    int neg = mpn_abs_sub(em1, e1, k + 1, t, k + 1);
+    mpn_add_n(e1, e1, t, k + 1);
+
+    e2[k] = mpn_lshift(e2, a2, k, 2);           // even part a0 + 4 a2
+    mpn_add(e2, e2, k + 1, a0, k);
+    mpn_copy(t, a3, s);                         // odd part 2 a1 + 8 a3
+    mpn_zero(t + s, k + 1 - s);
+    mpn_lshift(t, t, k + 1, 2);
+    mpn_add(t, t, k + 1, a1, k);
+    mpn_lshift(t, t, k + 1, 1);
+    neg |= mpn_abs_sub(em2, e2, k + 1, t, k + 1) << 1;
+    mpn_add_n(e2, e2, t, k + 1);
+
+    mpn_copy(eh, a0, k);                        // ((2 a0 + a1) 2 + a2) 2 + a3
+    eh[k] = 0;
+    mpn_lshift(eh, eh, k + 1, 1);
+    mpn_add(eh, eh, k + 1, a1, k);
+    mpn_lshift(eh, eh, k + 1, 1);
+    mpn_add(eh, eh, k + 1, a2, k);
+    mpn_lshift(eh, eh, k + 1, 1);
+    mpn_add(eh, eh, k + 1, a3, s);
+    return neg;
+}
+
+// Toom-4 on n = 3k + s words, evaluating the sextic product at 0, 1, -1, 2, -2, 1/2 and infinity. With
+// E1 = c0 + c2 + c4 + c6, P = c1 + c3 + c5 from v(1), v(-1); E2 = c0 + 4 c2 + 16 c4 + 64 c6, Q = c1 + 4 c3 + 16 c5
+// from v(2), v(-2); and R = 16 c1 + 4 c3 + c5 from 64 v(1/2), the odd coefficients follow from
+//   (R - P) / 3 = 5 c1 + c3, (Q - P) / 3 = c3 + 5 c5, c3 = (5 P - (R - P) / 3 - (Q - P) / 3) / 3,
+// and again no intermediate value goes negative. Scratch: ten evaluations and a temporary of k + 1 words,
+// seven buffers of 2k + 2 words, then the recursion.
+static void mpn_toom4(WORD* rp, const WORD* ap, const WORD* bp, int n, WORD* ws, bool sqr) {
+    int k = (n + 3) / 4, s = n - 3 * k, m = k + 1;
+    WORD *ea1 = ws, *eam1 = ws + m, *ea2 = ws + 2 * m, *eam2 = ws + 3 * m, *eah = ws + 4 * m;
+    WORD *eb1 = ws + 5 * m, *ebm1 = ws + 6 * m, *eb2 = ws + 7 * m, *ebm2 = ws + 8 * m, *ebh = ws + 9 * m;
+    WORD* v1 = ws + 10 * m;
+    WORD* vm1 = ws + 12 * m;
+    WORD* v2 = ws + 14 * m;
+    WORD* vm2 = ws + 16 * m;
+    WORD* vh = ws + 18 * m;
+    WORD* t1 = ws + 20 * m;
+    WORD* t2 = ws + 22 * m;
+    WORD* next = ws + 24 * m;
+    WORD* c0 = rp;
+    WORD* c6 = rp + 6 * k;
+
+    int neg = toom4_eval(ea1, eam1, ea2, eam2, eah, ap, k, s, t1);
+    if (!sqr)
+        neg ^= toom4_eval(eb1, ebm1, eb2, ebm2, ebh, bp, k, s, t1);
+    else
+        neg = 0;
+    mpn_mul_any(v1, ea1, sqr ? ea1 : eb1, m, next, sqr);
+    mpn_mul_any(vm1, eam1, sqr ? eam1 : ebm1, m, next, sqr);
+    mpn_mul_any(v2, ea2, sqr ? ea2 : eb2, m, next, sqr);
+    mpn_mul_any(vm2, eam2, sqr ? eam2 : ebm2, m, next, sqr);
+    mpn_mul_any(vh, eah, sqr ? eah : ebh, m, next, sqr);
+    mpn_mul_any(c0, ap, bp, k, next, sqr);
+    mpn_mul_any(c6, ap + 3 * k, bp + 3 * k, s, next, sqr);
+
+    // t1 <- E1, vm1 <- P, t2 <- E2, vm2 <- Q
+    if (neg & 1) {
+        mpn_sub_n(t1, v1, vm1, 2 * m);
+        mpn_add_n(vm1, v1, vm1, 2 * m);
+    } else {
+        mpn_add_n(t1, v1, vm1, 2 * m);
+        mpn_sub_n(vm1, v1, vm1, 2 * m);
+    }
+    mpn_rshift(t1, t1, 2 * m, 1);
+    mpn_rshift(vm1, vm1, 2 * m, 1);
+    if (neg & 2) {
+        mpn_sub_n(t2, v2, vm2, 2 * m);
+        mpn_add_n(vm2, v2, vm2, 2 * m);
+    } else {
+        mpn_add_n(t2, v2, vm2, 2 * m);
+        mpn_sub_n(vm2, v2, vm2, 2 * m);
+    }
+    mpn_rshift(t2, t2, 2 * m, 1);
+    mpn_rshift(vm2, vm2, 2 * m, 2);
+
+    // Even coefficients: t1 <- c2 + c4, t2 <- c2 + 4 c4, then t2 <- c4 and t1 <- c2
+    mpn_sub(t1, t1, 2 * m, c0, 2 * k);
+    mpn_sub(t1, t1, 2 * m, c6, 2 * s);
+    mpn_sub(t2, t2, 2 * m, c0, 2 * k);
+    mpn_submul_small(t2, 2 * m, c6, 2 * s, 64);
+    mpn_rshift(t2, t2, 2 * m, 2);
+    mpn_sub_n(t2, t2, t1, 2 * m);
+    mpn_divexact_1(t2, t2, 2 * m, 3);
+    mpn_sub_n(t1, t1, t2, 2 * m);
+
+    // vh <- R = (64 v(1/2) - 64 c0 - 16 c2 - 4 c4 - c6) / 2
+    mpn_submul_small(vh, 2 * m, c0, 2 * k, 64);
+    mpn_submul_small(vh, 2 * m, t1, 2 * m, 16);
+    mpn_submul_small(vh, 2 * m, t2, 2 * m, 4);
+    mpn_sub(vh, vh, 2 * m, c6, 2 * s);
+    mpn_rshift(vh, vh, 2 * m, 1);
+
+    // Odd coefficients: vh <- 5 c1 + c3, vm2 <- c3 + 5 c5, v1 <- c3, then vh <- c1 and vm2 <- c5
+    mpn_sub_n(vh, vh, vm1, 2 * m);
+    mpn_divexact_1(vh, vh, 2 * m, 3);
+    mpn_sub_n(vm2, vm2, vm1, 2 * m);
+    mpn_divexact_1(vm2, vm2, 2 * m, 3);
+    mpn_mul_1(v1, vm1, 2 * m, 5);
+    mpn_sub_n(v1, v1, vh, 2 * m);
+    mpn_sub_n(v1, v1, vm2, 2 * m);
+    mpn_divexact_1(v1, v1, 2 * m, 3);
+    mpn_sub_n(vh, vh, v1, 2 * m);
+    mpn_divexact_1(vh, vh, 2 * m, 5);
+    mpn_sub_n(vm2, vm2, v1, 2 * m);
+    mpn_divexact_1(vm2, vm2, 2 * m, 5);
+
+    mpn_zero(rp + 2 * k, 4 * k);
+    WORD* coef[] = { vh, t1, v1, t2, vm2 };
+    toom_assemble(rp, n, k, coef, 5, m);
+}
+
+// Karatsuba on a = a1 * W^l + a0, b = b1 * W^l + b0 with l = ceil(n / 2):
+// a0 * b1 + a1 * b0 = a0 * b0 + a1 * b1 - (a0 - a1)(b0 - b1), so three half-size products suffice.
+// Scratch: |a0 - a1| and |b0 - b1| (l words each), the middle term (2l + 1), their product (2l), then the recursion.
+static void mpn_karatsuba_mul(WORD* rp, const WORD* ap, const WORD* bp, int n, WORD* ws) {
+    int h = n / 2, l = n - h;
+    WORD* da = ws;
+    WORD* db = ws + l;
+    WORD* t = ws + 2 * l;
+    WORD* p = ws + 4 * l + 1;
+    WORD* next = ws + 6 * l + 1;
+
+    int sa = mpn_abs_sub(da, ap, l, ap + l, h);
+    int sb = mpn_abs_sub(db, bp, l, bp + l, h);
+    mpn_mul_n(rp, ap, bp, l, next);
+    mpn_mul_n(rp + 2 * l, ap + l, bp + l, h, next);
+    mpn_mul_n(p, da, db, l, next);
+
+    t[2 * l] = mpn_add(t, rp, 2 * l, rp + 2 * l, 2 * h);
+    if (sa == sb)
+        t[2 * l] -= mpn_sub_n(t, t, p, 2 * l);
+    else
+        t[2 * l] += mpn_add_n(t, t, p, 2 * l);
+    int tn = mpn_normalize(t, 2 * l + 1);
+    if (tn > 0)
+        mpn_add(rp + l, rp + l, 2 * n - l, t, tn);
+}
+
+// As mpn_karatsuba_mul with 2 * a0 * a1 = a0^2 + a1^2 - (a0 - a1)^2
+static void mpn_karatsuba_sqr(WORD* rp, const WORD* ap, int n, WORD* ws) {
+    int h = n / 2, l = n - h;
+    WORD* da = ws;
+    WORD* t = ws + 2 * l;
+    WORD* p = ws + 4 * l + 1;
+    WORD* next = ws + 6 * l + 1;
+
+    mpn_abs_sub(da, ap, l, ap + l, h);
+    mpn_sqr_n(rp, ap, l, next);
+    mpn_sqr_n(rp + 2 * l, ap + l, h, next);
+    mpn_sqr_n(p, da, l, next);
+
+    t[2 * l] = mpn_add(t, rp, 2 * l, rp + 2 * l, 2 * h);
+    t[2 * l] -= mpn_sub_n(t, t, p, 2 * l);
+    int tn = mpn_normalize(t, 2 * l + 1);
+    if (tn > 0)
+        mpn_add(rp + l, rp + l, 2 * n - l, t, tn);
+}
+
+void mpn_mul_n(WORD* rp, const WORD* ap, const WORD* bp, int n, WORD* ws) {
+    switch (mpn_mul_alg(n, false)) {
+    case MPN_BASECASE:  mpn_mul_leaf(rp, ap, bp, n); break;
+    case MPN_KARATSUBA: mpn_karatsuba_mul(rp, ap, bp, n, ws); break;
+    case MPN_TOOM3:     mpn_toom3(rp, ap, bp, n, ws, false); break;
+    case MPN_TOOM4:     mpn_toom4(rp, ap, bp, n, ws, false); break;
+    default:            mpn_mul_fft(rp, ap, n, bp, n, ws); break;
+    }
+}
+
+void mpn_sqr_n(WORD* rp, const WORD* ap, int n, WORD* ws) {
+    switch (mpn_mul_alg(n, true)) {
+    case MPN_BASECASE:  mpn_sqr_leaf(rp, ap, n); break;
+    case MPN_KARATSUBA: mpn_karatsuba_sqr(rp, ap, n, ws); break;
+    case MPN_TOOM3:     mpn_toom3(rp, ap, ap, n, ws, true); break;
+    case MPN_TOOM4:     mpn_toom4(rp, ap, ap, n, ws, true); break;
+    default:            mpn_sqr_fft(rp, ap, n, ws); break;
+    }
+}
+
+int mpn_mul_itch(int an, int bn) {
+    if (bn >= mpn_mul_fft_threshold && ntt_fits(an, bn))
+        return mpn_mul_fft_itch(an, bn);
+    if (bn < mpn_mul_karatsuba_threshold)
+        return 0;
+    if (an == bn)
+        return mpn_mul_n_itch(bn);
+    int s = mpn_mul_n_itch(bn);
+    int r = an % bn;
+    if (r > 0) {
+        int sr = mpn_mul_itch(bn, r);
+        s = MAXIMUM(s, sr);
+    }
+    return 2 * bn + s;
+}
+
+void mpn_mul(WORD* rp, const WORD* ap, int an, const WORD* bp, int bn, WORD* ws) {
+    // The transform takes unbalanced operands whole
+    if (bn >= mpn_mul_fft_threshold && ntt_fits(an, bn)) {
+        mpn_mul_fft(rp, ap, an, bp, bn, ws);
+        return;
+    }
+    if (bn < mpn_mul_karatsuba_threshold) {
+        mpn_mul_basecase(rp, ap, an, bp, bn);
+        return;
+    }
+    if (an == bn) {
+        mpn_mul_n(rp, ap, bp, bn, ws);
+        return;
+    }
+    WORD* t = ws;
+    WORD* next = ws + 2 * bn;
+    mpn_mul_n(rp, ap, bp, bn, next);
+    for (int off = bn; off < an; off += bn) {
+        int len = MINIMUM(bn, an - off);
+        if (len == bn)
+            mpn_mul_n(t, ap + off, bp, bn, next);
+        else
+            mpn_mul(t, bp, bn, ap + off, len, next);
+        // rp holds bn valid words from off on; the piece adds bn + len more
+        mpn_add(rp + off, t, bn + len, rp + off, bn);
+    }
+}
+
+void mpn_div_binary(WORD* qp, WORD* rp, const WORD* np, int nn, const WORD* dp, int dn) {
+    mpn_zero(qp, nn);
+    mpn_zero(rp, dn + 1);
+    for (int i = mpn_normalize(np, nn) * WORD_BITLEN - 1; i >= 0; i--) {
+        mpn_lshift(rp, rp, dn + 1, 1);                          // R <- 2R + n_i
+        rp[0] |= (WORD)(np[i / WORD_BITLEN] >> (i % WORD_BITLEN)) & 1;
+        if (rp[dn] != 0 || mpn_cmp(rp, dp, dn) >= 0) {           // R >= D
+            rp[dn] -= mpn_sub_n(rp, rp, dp, dn);
+            qp[i / WORD_BITLEN] |= (WORD)WORD_ONE << (i % WORD_BITLEN);
+        }
+    }
+}
+
+WORD mpn_invert_limb(WORD d) {
+    // floor((W^2 - 1) / d) - W, written as ((W - 1 - d) * W + W - 1) / d so the dividend stays below d * W
+    return (WORD)((((DWORD)(WORD)~d << WORD_BITLEN) | WORD_MAX) / d);
+}
+
+// Moller-Granlund 2-by-1 division of u1 * W + u0 by the normalized d with v = mpn_invert_limb(d): returns the
+// quotient and leaves the remainder in *r. Needs u1 < d.
+static inline WORD div_2by1(WORD* r, WORD u1, WORD u0, WORD d, WORD v) {
+    DWORD p = (DWORD)v * u1 + (((DWORD)(WORD)(u1 + 1) << WORD_BITLEN) | u0);
+    WORD q1 = (WORD)(p >> WORD_BITLEN), q0 = (WORD)p;
+    WORD rem = (WORD)(u0 - (WORD)(q1 * d));
+    if (rem > q0) {
+        q1--;
+        rem = (WORD)(rem + d);
+    }
+    if (rem >= d) {
+        q1++;
+        rem = (WORD)(rem - d);
+    }
+    *r = rem;
+    return q1;
+}
+
+// Schoolbook division of np (nn words) in place by the normalized dp (dn words), v = mpn_invert_limb(dp[dn - 1]):
+// qp gets the low nn - dn quotient words and the top one, 0 or 1, is returned; the remainder is left in np[0..dn)
+static WORD div_sb(WORD* qp, WORD* np, int nn, const WORD* dp, int dn, WORD v) {
+    WORD* top = np + nn - dn;
+    WORD qh = mpn_cmp(top, dp, dn) >= 0;
+    if (qh)
+        mpn_sub_n(top, top, dp, dn);
+    WORD d1 = dp[dn - 1];
+
+    if (dn == 1) {
+        WORD r = np[nn - 1];
+        for (int j = nn - 2; j >= 0; j--)
+            qp[j] = div_2by1(&r, r, np[j], d1, v);
+        np[0] = r;
+        return qh;
+    }
+
+    WORD d0 = dp[dn - 2];
+    for (int j = nn - dn - 1; j >= 0; j--) {
+        // The 2-by-1 quotient of the top two words, corrected against the next divisor word, is at most one too
+        // large
+        WORD u2 = np[j + dn], u1 = np[j + dn - 1], u0 = np[j + dn - 2];
+        WORD q, r;
+        bool small = true;
+        if (u2 == d1) {
+            q = WORD_MAX;
+            r = (WORD)(u1 + d1);
+            small = r >= d1;
+        } else {
+            q = div_2by1(&r, u2, u1, d1, v);
+        }
+        while (small && (DWORD)q * d0 > (((DWORD)r << WORD_BITLEN) | u0)) {
+            q--;
+            r = (WORD)(r + d1);
+            small = r >= d1;
+        }
+
+        // Multiply and subtract, adding the divisor back once if that went negative
+        WORD borrow = mpn_submul_1(np + j, dp, dn, q);
+        np[j + dn] = (WORD)(u2 - borrow);
+        if (borrow > u2) {
+            q--;
+            np[j + dn] = (WORD)(np[j + dn] + mpn_add_n(np + j, np + j, dp, dn));
+        }
+        qp[j] = q;
+    }
+    return qh;
+}
+
+// Burnikel-Ziegler step, as div_sb for 2n words by n: the high half of the quotient comes from the top words of
+// both operands by recursion, and its product with the low divisor words, taken off the partial remainder,
+// corrects it; then the same for the low half. tp holds div_dc_n_itch(n) words.
+static WORD div_dc_n(WORD* qp, WORD* np, const WORD* dp, int n, WORD v, WORD* tp) {
+    int lo = n / 2, hi = n - lo;
+
+    WORD qh;
+    if (hi < mpn_div_bz_threshold)
+        qh = div_sb(qp + lo, np + 2 * lo, 2 * hi, dp + lo, hi, v);
+    else
+        qh = div_dc_n(qp + lo, np + 2 * lo, dp + lo, hi, v, tp);
+    mpn_mul(tp, qp + lo, hi, dp, lo, tp + n);
+    WORD cy = mpn_sub_n(np + lo, np + lo, tp, n);
+    if (qh)
+        cy += mpn_sub_n(np + n, np + n, dp, lo);
+    while (cy != 0) {
+        qh -= mpn_sub_1(qp + lo, qp + lo, hi, 1);
+        cy -= mpn_add_n(np + lo, np + lo, dp, n);
+    }
+
+    WORD ql;
+    if (lo < mpn_div_bz_threshold)
+        ql = div_sb(qp, np + hi, 2 * lo, dp + hi, lo, v);
+    else
+        ql = div_dc_n(qp, np + hi, dp + hi, lo, v, tp);
+    mpn_mul(tp, dp, hi, qp, lo, tp + n);
+    cy = mpn_sub_n(np, np, tp, n);
+    if (ql)
+        cy += mpn_sub_n(np + lo, np + lo, dp, hi);
+    while (cy != 0) {
+        mpn_sub_1(qp, qp, lo, 1);
+        cy -= mpn_add_n(np, np, dp, n);
+    }
+    return qh;
+}
+
+static int div_dc_n_itch(int n) {
+    int lo = n / 2, hi = n - lo;
+    int s = n + mpn_mul_itch(hi, lo);
+    if (hi >= mpn_div_bz_threshold) {
+        int sr = div_dc_n_itch(hi);
+        s = MAXIMUM(s, sr);
+    }
+    return s;
+}
+
+// A quotient block of qn <= dn words from np (dn + qn words), as div_sb: the top 2qn words divided by the top qn
+// divisor words, then corrected with the product of that quotient and the other dn - qn divisor words
+static WORD div_dc_block(WORD* qp, WORD* np, int qn, const WORD* dp, int dn, WORD v, WORD* tp) {
+    WORD qh;
+    if (qn < mpn_div_bz_threshold)
+        qh = div_sb(qp, np + dn - qn, 2 * qn, dp + dn - qn, qn, v);
+    else
+        qh = div_dc_n(qp, np + dn - qn, dp + dn - qn, qn, v, tp);
+    int ln = dn - qn;
+    if (ln == 0)
+        return qh;
+    if (qn >= ln)
+        mpn_mul(tp, qp, qn, dp, ln, tp + dn);
+    else
+        mpn_mul(tp, dp, ln, qp, qn, tp + dn);
+    WORD cy = mpn_sub_n(np, np, tp, dn);
+    if (qh)
+        cy += mpn_sub_n(np + qn, np + qn, dp, ln);
+    while (cy != 0) {
+        qh -= mpn_sub_1(qp, qp, qn, 1);
+        cy -= mpn_add_n(np, np, dp, dn);
+    }
+    return qh;
+}
+
+static int div_dc_block_itch(int qn, int dn) {
+    int s = qn >= mpn_div_bz_threshold ? div_dc_n_itch(qn) : 0;
+    if (qn < dn) {
+        int sm = dn + mpn_mul_itch(MAXIMUM(qn, dn - qn), MINIMUM(qn, dn - qn));
+        s = MAXIMUM(s, sm);
+    }
+    return s;
+}
+
+// Whether mpn_div_qr divides its normalized nn + 1 words by dn with div_dc
+static bool div_uses_dc(int nn, int dn) {
+    return dn >= mpn_div_bz_threshold && nn + 1 - dn >= mpn_div_bz_threshold;
+}
+
+// Division of np (nn words) in place by the normalized dp (dn words), as div_sb, one quotient block of dn words
+// at a time from the top; the first block takes what is left over
+static WORD div_dc(WORD* qp, WORD* np, int nn, const WORD* dp, int dn, WORD v, WORD* tp) {
+    int qn = nn - dn;
+    int b = (qn - 1) % dn + 1;
+    WORD qh = div_dc_block(qp + qn - b, np + qn - b, b, dp, dn, v, tp);
+    for (int j = qn - b - dn; j >= 0; j -= dn)
+        div_dc_n(qp + j, np + j, dp, dn, v, tp);
+    return qh;
+}
+
+int mpn_div_qr_itch(int nn, int dn) {
+    int s = nn + 1 + dn;
+    if (nn >= dn && div_uses_dc(nn, dn)) {
+        int qn = nn + 1 - dn;
+        int sn = div_dc_n_itch(dn), sb = div_dc_block_itch((qn - 1) % dn + 1, dn);
+        s += MAXIMUM(sn, sb);
+    }
+    return s;
+}
+
+void mpn_div_qr(WORD* qp, WORD* rp, const WORD* np, int nn, const WORD* dp, int dn, WORD* ws) {
+    mpn_zero(qp, nn);
+    mpn_zero(rp, dn + 1);
+    if (nn < dn) {
+        mpn_copy(rp, np, nn);
+        return;
+    }
+
+    // Shift both operands left until the top bit of the divisor is set; the extra top word of the dividend
+    // keeps its top dn words below the divisor, so the quotient fits in nn words
+    int s = 0;
+    for (WORD top = dp[dn - 1]; !(top & ((WORD)WORD_ONE << (WORD_BITLEN - 1))); top = (WORD)(top << 1))
+        s++;
+    WORD* u = ws;
+    WORD* d = ws + nn + 1;
+    if (s > 0) {
+        u[nn] = mpn_lshift(u, np, nn, s);
+        mpn_lshift(d, dp, dn, s);
+    } else {
+        u[nn] = 0;
+        mpn_copy(u, np, nn);
+        mpn_copy(d, dp, dn);
+    }
+    WORD v = mpn_invert_limb(d[dn - 1]);
+    if (div_uses_dc(nn, dn))
+        div_dc(qp, u, nn + 1, d, dn, v, ws + nn + 1 + dn);
+    else
+        div_sb(qp, u, nn + 1, d, dn, v);
+
+    // The remainder is the low dn words, shifted back
+    if (s > 0)
+        mpn_rshift(rp, u, dn, s);
+    else
+        mpn_copy(rp, u, dn);
+}
+
+// xp <- floor((W^(2n) - 1) / dp) in n + 1 words for the normalized dp. The top half of the divisor gives the
+// top half of the reciprocal by recursion, one Newton step x + x * (W^(2n) - dp * x) / W^(2n) takes it to within
+// a few units, and a last product with dp settles those.
+static void invert_full(WORD* xp, const WORD* dp, int n, WORD* ws) {
+    if (n == 1 || n < mpn_div_bz_threshold) {
+        WORD* u = ws;
+        WORD* q = u + 2 * n;
+        WORD* r = q + 2 * n;
+        for (int i = 0; i < 2 * n; i++)
+            u[i] = WORD_MAX;
+        mpn_div_qr(q, r, u, 2 * n, dp, n, r + n + 1);
+        mpn_copy(xp, q, n + 1);
+        return;
+    }
+    int h = (n + 1) / 2, k = n - h;
+    invert_full(xp + k, dp + k, h, ws);
+    mpn_zero(xp, k);
+
+    // E = W^(n+h) - dp * x_h lies in (-2 W^n, W^n), so its magnitude takes n + 1 words
+    WORD* p = ws;
+    mpn_mul(p, dp, n, xp + k, h + 1, p + n + h + 1);
+    bool neg = p[n + h] != 0;
+    if (neg) {
+        p[n + h]--;
+    } else {
+        for (int i = 0; i < n + h; i++)
+            p[i] = (WORD)~p[i];
+        mpn_add_1(p, p, n + h, 1);
+    }
+
+    // x <- x +- floor(x_h * |E| / W^(2h)), which reaches the low k + 2 words. The k - 1 low words of E move that by
+    // less than one unit, so only the top h + 2 enter the product.
+    WORD* c = p + n + h + 1;
+    mpn_mul(c, p + k - 1, h + 2, xp + k, h + 1, c + 2 * h + 3);
+    c -= k - 1;
+    if (neg)
+        mpn_sub(xp, xp, n + 1, c + 2 * h, k + 2);
+    else
+        mpn_add(xp, xp, n + 1, c + 2 * h, k + 2);
+
+    // Settle x so that W^(2n) - 1 - x * dp lands in [0, dp)
+    WORD* t = ws;
+    mpn_mul(t, xp, n + 1, dp, n, t + 2 * n + 1);
+    while (t[2 * n] != 0) {
+        mpn_sub(t, t, 2 * n + 1, dp, n);
+        mpn_sub_1(xp, xp, n + 1, 1);
+    }
+    for (int i = 0; i < 2 * n; i++)
+        t[i] = (WORD)~t[i];
+    while (mpn_normalize(t, 2 * n) > n || mpn_cmp(t, dp, n) >= 0) {
+        mpn_sub(t, t, 2 * n, dp, n);
+        mpn_add_1(xp, xp, n + 1, 1);
+    }
+}
+
+static int invert_full_itch(int n) {
+    if (n == 1 || n < mpn_div_bz_threshold)
+        return 5 * n + 1 + mpn_div_qr_itch(2 * n, n);
+    int h = (n + 1) / 2;
+    int s = invert_full_itch(h);
+    int sp = mpn_mul_itch(n, h + 1), sc = 2 * h + 3 + mpn_mul_itch(h + 2, h + 1);
+    sp = n + h + 1 + MAXIMUM(sp, sc);
+    int st = 2 * n + 1 + mpn_mul_itch(n + 1, n);
+    s = MAXIMUM(s, sp);
+    return MAXIMUM(s, st);
+}
+
+int mpn_invert_itch(int n) {
+    return n + 1 + invert_full_itch(n);
+}
+
+void mpn_invert(WORD* ip, const WORD* dp, int n, WORD* ws) {
+    invert_full(ws, dp, n, ws + n + 1);
+    mpn_copy(ip, ws, n);                            // the top word is always 1
+}
+
+// A quotient block of qn <= dn words from np (dn + qn words) in place, as div_dc_block, with ip = mpn_invert(dp):
+// the top qn words T give q = T + floor(T * ip / W^dn), which is at most a few units low, and the remainder
+// np - q * dp is brought below dp from there
+static void div_preinv_block(WORD* qp, WORD* np, int qn, const WORD* dp, int dn, const WORD* ip, WORD* tp) {
+    const WORD* top = np + dn;
+    mpn_mul(tp, ip, dn, top, qn, tp + dn + qn);
+    mpn_add_n(qp, tp + dn, top, qn);
+    mpn_mul(tp, dp, dn, qp, qn, tp + dn + qn);
+    mpn_sub_n(np, np, tp, dn + qn);
+    while (np[dn] != 0 || mpn_cmp(np, dp, dn) >= 0) {
+        np[dn] = (WORD)(np[dn] - mpn_sub_n(np, np, dp, dn));
+        mpn_add_1(qp, qp, qn, 1);
+    }
+}
+
+// Whether division by a dn-word divisor goes through its reciprocal. Below the NTT range one Burnikel-Ziegler
+// division costs about as much as the two full products of a preinverted block, so mpn_div_qr's path is kept there.
+static bool div_uses_preinv(int dn) {
+    return dn >= mpn_div_bz_threshold && dn >= mpn_mul_fft_threshold;
+}
+
+int mpn_div_qr_preinv_itch(int nn, int dn) {
+    if (nn < dn)
+        return nn + 1;
+    if (!div_uses_preinv(dn))
+        return mpn_div_qr_itch(nn, dn);
+    int b = (nn - dn) % dn + 1;
+    int sf = mpn_mul_itch(dn, dn), sb = mpn_mul_itch(dn, b);
+    return nn + 1 + 2 * dn + MAXIMUM(sf, sb);
+}
+
+void mpn_div_qr_preinv(WORD* qp, WORD* rp, const WORD* np, int nn, const WORD* dp, int dn, const WORD* ip, int s,
+                       WORD* ws) {
+    mpn_zero(qp, nn);
+    mpn_zero(rp, dn + 1);
+    if (nn < dn) {
+        mpn_copy(rp, np, nn);
+        return;
+    }
+
+    WORD* u = ws;
+    if (s > 0) {
+        u[nn] = mpn_lshift(u, np, nn, s);
+    } else {
+        u[nn] = 0;
+        mpn_copy(u, np, nn);
+    }
+    if (!div_uses_preinv(dn)) {
+        WORD v = mpn_invert_limb(dp[dn - 1]);
+        if (div_uses_dc(nn, dn))
+            div_dc(qp, u, nn + 1, dp, dn, v, ws + nn + 1 + dn);
+        else
+            div_sb(qp, u, nn + 1, dp, dn, v);
+    } else {
+        // Blocks of dn quotient words from the top, the first one taking what is left over
+        int qn = nn + 1 - dn, b = (qn - 1) % dn + 1;
+        div_preinv_block(qp + qn - b, u + qn - b, b, dp, dn, ip, ws + nn + 1);
+        for (int j = qn - b - dn; j >= 0; j -= dn)
+            div_preinv_block(qp + j, u + j, dn, dp, dn, ip, ws + nn + 1);
+    }
+
+    if (s > 0)
+        mpn_rshift(rp, u, dn, s);
+    else
+        mpn_copy(rp, u, dn);
+}
+
+// Number of significant bits of the n-word value ap
+static int gcd_bits(const WORD* ap, int n) {
+    n = mpn_normalize(ap, n);
+    if (n == 0)
+        return 0;
+    int bits = n * WORD_BITLEN;
+    for (WORD top = ap[n - 1]; !(top >> (WORD_BITLEN - 1)); top = (WORD)(top << 1))
+        bits--;
+    return bits;
+}
+
+// floor(ap / 2^sh) for an n-word value below 2^(sh + 2 WORD_BITLEN - 2)
+static DWORD gcd_top_bits(const WORD* ap, int n, int sh) {
+    int i = sh / WORD_BITLEN, o = sh % WORD_BITLEN;
+    DWORD v = (DWORD)(ap[i] >> o);
+    if (i + 1 < n)
+        v |= (DWORD)ap[i + 1] << (WORD_BITLEN - o);
+    if (o > 0 && i + 2 < n)
+        v |= (DWORD)ap[i + 2] << (2 * WORD_BITLEN - o);
+    return v;
+}
+
+int mpn_gcd_lehmer(WORD* m, const WORD* ap, const WORD* bp, int n, int s) {
+    int abits = gcd_bits(ap, n), bbits = gcd_bits(bp, n);
+    int bits = MAXIMUM(abits, bbits);
+    int sh = bits > 2 * WORD_BITLEN - 2 ? bits - (2 * WORD_BITLEN - 2) : 0;
+    bool exact = sh == 0;
+    DWORD ah = gcd_top_bits(ap, n, sh), bh = gcd_top_bits(bp, n, sh);
+
+    // The floor W^s in units of the lowest kept bit, rounded up
+    DWORD t = 0;
+    if (s >= 0) {
+        if (bits <= s * WORD_BITLEN)
+            return 0;
+        t = s * WORD_BITLEN > sh ? (DWORD)1 << (s * WORD_BITLEN - sh) : 1;
+    }
+
+    // Below the kept bits, a value reached through the row (x, y) differs from its leading part by less than
+    // max(x, y) units, so a step is taken only while those bounds keep its remainder within [0, b) and above the
+    // floor
+    DWORD x0 = 1, y0 = 0, x1 = 0, y1 = 1;
+    int k = 0;
+    while (bh != 0) {
+        DWORD q = 0, r = ah;
+        if ((ah >> 3) < bh) {
+            while (r >= bh) {                           // most quotients are small
+                r -= bh;
+                q++;
+            }
+        } else {
+            q = ah / bh;
+            r = ah - q * bh;
+        }
+        if (q > WORD_MAX)
+            break;
+        DWORD x = x0 + q * x1, y = y0 + q * y1;
+        if (x > WORD_MAX || y > WORD_MAX)
+            break;
+        DWORD e = exact ? 0 : MAXIMUM(x1, y1), en = exact ? 0 : MAXIMUM(x, y);
+        if (r < en + t || r + en + e > bh)
+            break;
+        x0 = x1; y0 = y1;
+        x1 = x; y1 = y;
+        ah = bh; bh = r;
+        k++;
+    }
+    m[0] = (WORD)x0; m[1] = (WORD)y0;
+    m[2] = (WORD)x1; m[3] = (WORD)y1;
+    return k;
+}
+
+void mpn_gcd_apply_1(WORD* ap, WORD* bp, int n, const WORD* m, int k) {
+    // Four product rows with their own carries; each new value is the difference of two of them, taken in the
+    // order the parity of k makes nonnegative
+    bool odd = k & 1;
+    WORD c[4] = { 0, 0, 0, 0 }, ba = 0, bb = 0;
+    for (int i = 0; i < n; i++) {
+        WORD a = ap[i], b = bp[i];
+        DWORD xa = (DWORD)m[0] * a + c[0], yb = (DWORD)m[1] * b + c[1];
+        DWORD xa1 = (DWORD)m[2] * a + c[2], yb1 = (DWORD)m[3] * b + c[3];
+        c[0] = (WORD)(xa >> WORD_BITLEN); c[1] = (WORD)(yb >> WORD_BITLEN);
+        c[2] = (WORD)(xa1 >> WORD_BITLEN); c[3] = (WORD)(yb1 >> WORD_BITLEN);
+
+        WORD u = odd ? (WORD)yb : (WORD)xa, v = odd ? (WORD)xa : (WORD)yb;
+        WORD d = (WORD)(u - v), r = (WORD)(d - ba);
+        ba = (WORD)((u < v) | (d < ba));
+        ap[i] = r;
+
+        u = odd ? (WORD)xa1 : (WORD)yb1;
+        v = odd ? (WORD)yb1 : (WORD)xa1;
+        d = (WORD)(u - v);
+        r = (WORD)(d - bb);
+        bb = (WORD)((u < v) | (d < bb));
+        bp[i] = r;
+    }
+}
+
+void mpn_gcd_mul_1(WORD* up, WORD* vp, int n, const WORD* m) {
+    // Each sum of two products carries up to two words' worth into the next position
+    DWORD cu = 0, cv = 0;
+    for (int i = 0; i < n; i++) {
+        WORD u = up[i], v = vp[i];
+        DWORD p = (DWORD)m[0] * u + cu, q = (DWORD)m[1] * v + (WORD)p;
+        up[i] = (WORD)q;
+        cu = (p >> WORD_BITLEN) + (q >> WORD_BITLEN);
+        p = (DWORD)m[2] * u + cv;
+        q = (DWORD)m[3] * v + (WORD)p;
+        vp[i] = (WORD)q;
+        cv = (p >> WORD_BITLEN) + (q >> WORD_BITLEN);
+    }
+    up[n] = (WORD)cu; up[n + 1] = (WORD)(cu >> WORD_BITLEN);
+    vp[n] = (WORD)cv; vp[n + 1] = (WORD)(cv >> WORD_BITLEN);
+}
+
+/*
+ * Binary GCD, and modular inversion by Bernstein-Yang divsteps in time independent of the operand
+ */
+
+// Trailing zero bits of a nonzero n-word value
+static int gcd_ctz(const WORD* ap) {
+    int z = 0;
+    for (; *ap == 0; ap++)
+        z += WORD_BITLEN;
+    for (WORD w = *ap; !(w & 1); w >>= 1)
+        z++;
+    return z;
+}
+
+// ap >>= z over its *n words, with the new significant length left in *n
+static void gcd_strip(WORD* ap, int* n, int z) {
+    int w = z / WORD_BITLEN, b = z % WORD_BITLEN;
+    if (w > 0) {
+        mpn_copy(ap, ap + w, *n - w);
+        *n -= w;
+    }
+    if (b > 0)
+        mpn_rshift(ap, ap, *n, b);
+    *n = mpn_normalize(ap, *n);
+}
+
+// rp <- (ap - bp) >> cnt for an >= bn with ap >= bp, in one pass; the low word of the difference must be
+// nonzero with cnt its trailing zero bits. Returns the significant words of the result
+static int gcd_sub_rshift(WORD* rp, const WORD* ap, int an, const WORD* bp, int bn, int cnt) {
+    WORD prev = (WORD)(ap[0] - bp[0]), borrow = (WORD)(ap[0] < bp[0]);
+    int i = 1;
+    for (; i < bn; i++) {
+        WORD a = ap[i], b = bp[i], d = (WORD)(a - b), r = (WORD)(d - borrow);
+        borrow = (WORD)((a < b) | (d < borrow));
+        rp[i - 1] = (WORD)((prev >> cnt) | (WORD)(r << (WORD_BITLEN - cnt)));
+        prev = r;
+    }
+    for (; i < an; i++) {
+        WORD a = ap[i], r = (WORD)(a - borrow);
+        borrow = (WORD)(a < borrow);
+        rp[i - 1] = (WORD)((prev >> cnt) | (WORD)(r << (WORD_BITLEN - cnt)));
+        prev = r;
+    }
+    rp[an - 1] = (WORD)(prev >> cnt);
+    return rp[an - 1] != 0 ? an : mpn_normalize(rp, an - 1);
+}
+
+int mpn_gcd_binary_itch(int an, int bn) {
+    return an + bn + 2;
+}
+
+int mpn_gcd_binary(WORD* rp, const WORD* ap, int an, const WORD* bp, int bn, WORD* ws) {
+    int un = mpn_normalize(ap, an), vn = mpn_normalize(bp, bn);
+    if (un == 0 || vn == 0) {
+        const WORD* src = un == 0 ? bp : ap;
+        int n = un == 0 ? vn : un;
+        mpn_copy(rp, src, n);
+        return n;
+    }
+    // A word of room above each, for the double-word tail
+    WORD *u = ws, *v = ws + an + 1;
+    mpn_copy(u, ap, un);
+    mpn_copy(v, bp, vn);
+
+    // gcd(2^i u, 2^j v) = 2^min(i, j) gcd(u, v) for odd u and v
+    int zu = gcd_ctz(u), zv = gcd_ctz(v), k = MINIMUM(zu, zv);
+    gcd_strip(u, &un, zu);
+    gcd_strip(v, &vn, zv);
+
+    // Stein: the difference of two odd values is even, so each subtraction takes off at least one bit; the
+    // last two words go in the double-word type
+    while (un > 2 || vn > 2) {
+        int c = un != vn ? (un > vn ? 1 : -1) : mpn_cmp(u, v, un);
+        if (c == 0)
+            break;
+        if (c < 0) {
+            WORD* t = u; u = v; v = t;
+            int tn = un; un = vn; vn = tn;
+        }
+        WORD d = (WORD)(u[0] - v[0]);
+        if (d != 0) {
+            int cnt = 0;
+            for (; !(d & 1); d >>= 1)
+                cnt++;
+            un = gcd_sub_rshift(u, u, un, v, vn, cnt);
+        } else {
+            mpn_sub(u, u, un, v, vn);
+            un = mpn_normalize(u, un);
+            gcd_strip(u, &un, gcd_ctz(u));
+        }
+    }
+    if (un <= 2 && vn <= 2) {
+        DWORD x = u[0], y = v[0];
+        if (un == 2)
+            x |= (DWORD)u[1] << WORD_BITLEN;
+        if (vn == 2)
+            y |= (DWORD)v[1] << WORD_BITLEN;
+        while (x != y) {
+            if (x < y) {
+                DWORD t = x; x = y; y = t;
+            }
+            for (x -= y; !(x & 1); x >>= 1);
+        }
+        u[0] = (WORD)x;
+        u[1] = (WORD)(x >> WORD_BITLEN);
+        un = u[1] != 0 ? 2 : 1;
+    }
+
+    // The result times 2^k still fits the shorter operand
+    int w = k / WORD_BITLEN, b = k % WORD_BITLEN, n = w + un;
+    mpn_zero(rp, w);
+    if (b > 0) {
+        WORD c = mpn_lshift(rp + w, u, un, b);
+        if (c != 0)
+            rp[n++] = c;
+    } else {
+        mpn_copy(rp + w, u, un);
+    }
+    return n;
+}
+
+// Divsteps per batch: after i of them f and g are known modulo 2^(WORD_BITLEN - i) from their low words, and
+// the transition matrix entries stay within 2^SEC_BATCH
+#define SEC_BATCH (WORD_BITLEN - 2)
+
+// All ones if the low bit of x is set, else zero
+#define SEC_MASK(x) ((WORD)0 - (WORD)((x) & 1))
+
+// SEC_BATCH divsteps (Bernstein and Yang, "Fast constant-time gcd computation and modular inversion", 2019) on
+// the low words of f, odd, and g: delta, f, g <- 1 - delta, g, (g - f)/2 if delta > 0 and g is odd, else
+// 1 + delta, f, (g + (g odd) f)/2, kept here as eta = -delta. The steps are returned as t = {u, v, q, r} with
+// 2^SEC_BATCH (f', g') = (u f + v g, q f + r g). Masks select instead of branches: g takes -f or f, and when
+// the rows swap, f then takes the new g, which is the old g minus f (as in libsecp256k1's modinv64)
+static void sec_divsteps(long long* t, long long* eta, WORD f, WORD g) {
+    long long u = 1, v = 0, q = 0, r = 1, e = *eta;
+    for (int i = 0; i < SEC_BATCH; i++) {
+        long long c1 = e >> 63, c2 = (long long)0 - (long long)(g & 1);
+        WORD w1 = (WORD)c1, w2 = (WORD)c2;
+        g = (WORD)(g + ((WORD)((f ^ w1) - w1) & w2));
+        q += ((u ^ c1) - c1) & c2;
+        r += ((v ^ c1) - c1) & c2;
+        c1 &= c2;
+        w1 = (WORD)c1;
+        e = (e ^ c1) - 1 - c1;
+        f = (WORD)(f + (g & w1));
+        u += q & c1;
+        v += r & c1;
+        g >>= 1;
+        u += u;
+        v += v;
+    }
+    t[0] = u; t[1] = v; t[2] = q; t[3] = r;
+    *eta = e;
+}
+
+// rp <- (u xp + v yp + k mp) / 2^SEC_BATCH for two's complement xp and yp of n words, in one pass, where k is
+// chosen in [0, 2^SEC_BATCH) to make the sum divisible: from minv = mp^(-1) mod W, or k = 0 without mp, when
+// u xp + v yp must be divisible itself. A negative factor multiplies the complement of the words, as
+// -x = ~x + 1 modulo W^n, and the ones go into the first carry
+static void sec_lin_shift(WORD* rp, const WORD* xp, const WORD* yp, int n, long long u, long long v, const WORD* mp,
+                          WORD minv) {
+    long long su = u >> 63, sv = v >> 63;
+    WORD mu = (WORD)su, mv = (WORD)sv, au = (WORD)((u ^ su) - su), av = (WORD)((v ^ sv) - sv);
+    DWORD c = (DWORD)(au & mu) + (av & mv);
+    WORD k = 0;
+    if (mp != NULL) {
+        WORD low = (WORD)((WORD)(au * (WORD)(xp[0] ^ mu)) + (WORD)(av * (WORD)(yp[0] ^ mv)) + (WORD)c);
+        k = (WORD)((WORD)(0 - (WORD)(low * minv)) & (WORD)(((WORD)1 << SEC_BATCH) - 1));
+    } else {
+        mp = xp;
+    }
+
+    // Each carry is below 4 W, and the word below the current one goes out shifted
+    WORD prev = 0;
+    for (int i = 0; i < n; i++) {
+        DWORD p = (DWORD)au * (WORD)(xp[i] ^ mu) + (WORD)c;
+        DWORD q = (DWORD)av * (WORD)(yp[i] ^ mv) + (WORD)p;
+        DWORD s = (DWORD)k * mp[i] + (WORD)q;
+        c = (c >> WORD_BITLEN) + (p >> WORD_BITLEN) + (q >> WORD_BITLEN) + (s >> WORD_BITLEN);
+        WORD w = (WORD)s;
+        if (i > 0)
+            rp[i - 1] = (WORD)((prev >> SEC_BATCH) | (WORD)(w << (WORD_BITLEN - SEC_BATCH)));
+        prev = w;
+    }
+    WORD sign = SEC_MASK(prev >> (WORD_BITLEN - 1));
+    rp[n - 1] = (WORD)((prev >> SEC_BATCH) | (WORD)(sign << (WORD_BITLEN - SEC_BATCH)));
+}
+
+// rp <- rp mod mp for -mp < rp < 2 mp in two's complement, with tp scratch of n words
+static void sec_reduce(WORD* rp, const WORD* mp, int n, WORD* tp) {
+    WORD neg = SEC_MASK(rp[n - 1] >> (WORD_BITLEN - 1)), c = 0;
+    for (int i = 0; i < n; i++) {
+        DWORD s = (DWORD)rp[i] + (mp[i] & neg) + c;
+        rp[i] = (WORD)s;
+        c = (WORD)(s >> WORD_BITLEN);
+    }
+    WORD keep = (WORD)(mpn_sub_n(tp, rp, mp, n) - 1);
+    for (int i = 0; i < n; i++)
+        rp[i] = (WORD)((rp[i] & ~keep) | (tp[i] & keep));
+}
+
+int mpn_sec_invert_itch(int n) {
+    return 10 * (n + 1);
+}
+
+bool mpn_sec_invert(WORD* rp, const WORD* ap, const WORD* mp, int n, WORD* ws) {
+    // f, g, d, e and m in two's complement on L words, each of the four with a buffer for its next value: f
+    // and g never exceed m in magnitude, and d and e stay in [0, m), so the sums of the updates stay below
+    // 2^(SEC_BATCH + 1) times m
+    int L = n + 1;
+    WORD *f = ws, *g = f + L, *d = g + L, *e = d + L, *m = e + L, *tp = m + L;
+    WORD *nf = tp + L, *ng = nf + L, *nd = ng + L, *ne = nd + L;
+    mpn_copy(m, mp, n);
+    m[n] = 0;
+    mpn_copy(f, m, L);
+    mpn_copy(g, ap, n);
+    g[n] = 0;
+    mpn_zero(d, L);
+    mpn_zero(e, L);
+    e[0] = WORD_ONE;
+
+    // m * minv = 1 mod W, by Newton steps from the 3 bits of an odd m that are their own inverse
+    WORD minv = mp[0];
+    for (int i = 3; i < WORD_BITLEN; i *= 2)
+        minv = (WORD)(minv * (WORD)(2 - (WORD)(mp[0] * minv)));
+
+    // (49 b + 80) / 17 divsteps take any g < m of b bits to zero (Bernstein and Yang, Theorem 11.2), where b
+    // counts from the top of m, which is public
+    int bits = n * WORD_BITLEN;
+    for (WORD top = mp[n - 1]; !(top >> (WORD_BITLEN - 1)); top = (WORD)(top << 1))
+        bits--;
+    long long steps = (49LL * bits + 80) / 17;
+    long long batches = (steps + SEC_BATCH - 1) / SEC_BATCH;
+
+    // f = d a and g = e a modulo m throughout
+    long long eta = -1, t[4];
+    for (long long b = 0; b < batches; b++) {
+        sec_divsteps(t, &eta, f[0], g[0]);
+        sec_lin_shift(nf, f, g, L, t[0], t[1], NULL, 0);
+        sec_lin_shift(ng, f, g, L, t[2], t[3], NULL, 0);
+        sec_lin_shift(nd, d, e, L, t[0], t[1], m, minv);
+        sec_lin_shift(ne, d, e, L, t[2], t[3], m, minv);
+        sec_reduce(nd, m, L, tp);
+        sec_reduce(ne, m, L, tp);
+        WORD* x;
+        x = f; f = nf; nf = x;
+        x = g; g = ng; ng = x;
+        x = d; d = nd; nd = x;
+        x = e; e = ne; ne = x;
+    }
+
+    // Now g = 0 and f = +-gcd(a, m), so the inverse is d or -d mod m as f is 1 or -1
+    WORD neg = SEC_MASK(f[L - 1] >> (WORD_BITLEN - 1)), acc = 0, cf = neg & 1, cd = neg & 1;
+    for (int i = 0; i < L; i++) {
+        WORD x = (WORD)((f[i] ^ neg) + cf), y = (WORD)((d[i] ^ neg) + cd);
+        cf = (WORD)(x < cf);
+        cd = (WORD)(y < cd);
+        acc |= (WORD)(x ^ (i == 0 ? WORD_ONE : 0));
+        d[i] = y;
+    }
+    sec_reduce(d, m, L, tp);
+    mpn_copy(rp, d, n);
+    return acc == 0;
+}
+
+#undef SEC_MASK
+#undef SEC_BATCH
@@ -0,0 +1,554 @@
+/**
+ * @file mpn.h
+ * @brief Header file for the low-level word-array kernels.
+ *
+ * This file declares the natural-number kernels that the BINT operations in
+ * arithmetic.c are built on. Every kernel works on plain little-endian WORD
+ * arrays with explicit lengths, returns its carry, borrow or shifted-out bits,
+ * and never allocates: the caller owns every buffer, including the scratch
+ * space of the Karatsuba routines. Signs, normalization and storage management
+ * stay at the BINT level.
+ *
+ * Unless a function says otherwise, sizes are at least 1, a result area may be
+ * the same as an input of the same length but must not partially overlap one,
+ * and the multiplication routines need a result area disjoint from their inputs.
+ */
+
+#ifndef _MPN_H
+#define _MPN_H
+
+#include "config.h"
+
+// Crossovers measured on this host by `make tune`, when it has been run
+#if defined(__has_include)
+#if __has_include("mpn_tune.h")
+#include "mpn_tune.h"
+#endif
+#endif
+
+/**
+ * @def MPN_KARATSUBA_THRESHOLD
+ * @brief Default operand size in words from which multiplication and squaring split with Karatsuba.
+ * @details It follows FLAG, the threshold of the BINT level Karatsuba routines, unless the build overrides it;
+ *          an override also takes precedence over mpn_tune.h.
+ */
+#ifndef MPN_KARATSUBA_THRESHOLD
+#define MPN_KARATSUBA_THRESHOLD (FLAG + 1)
+#endif
+
+/**
+ * @def MPN_MUL_KARATSUBA_THRESHOLD
+ * @brief Initial value of mpn_mul_karatsuba_threshold: the tuned crossover from mpn_tune.h, or
+ *        MPN_KARATSUBA_THRESHOLD.
+ */
+#ifndef MPN_MUL_KARATSUBA_THRESHOLD
+#define MPN_MUL_KARATSUBA_THRESHOLD MPN_KARATSUBA_THRESHOLD
+#endif
+
+/**
+ * @def MPN_SQR_KARATSUBA_THRESHOLD
+ * @brief Initial value of mpn_sqr_karatsuba_threshold: the tuned crossover from mpn_tune.h, or
+ *        MPN_KARATSUBA_THRESHOLD.
+ */
+#ifndef MPN_SQR_KARATSUBA_THRESHOLD
+#define MPN_SQR_KARATSUBA_THRESHOLD MPN_KARATSUBA_THRESHOLD
+#endif
+
+/**
+ * @def MPN_TOOM3_THRESHOLD
+ * @brief Default operand size in words from which multiplication and squaring use Toom-3 instead of Karatsuba.
+ * @details About 9600 bits, where Toom-3 overtook Karatsuba on 32-bit and 64-bit words alike. A build override
+ *          takes precedence over mpn_tune.h, as with MPN_KARATSUBA_THRESHOLD.
+ */
+#ifndef MPN_TOOM3_THRESHOLD
+#define MPN_TOOM3_THRESHOLD (9600 / WORD_BITLEN)
+#endif
+
+/**
+ * @def MPN_TOOM4_THRESHOLD
+ * @brief Default operand size in words from which multiplication and squaring use Toom-4 instead of Toom-3.
+ * @details About 25600 bits, measured as MPN_TOOM3_THRESHOLD.
+ */
+#ifndef MPN_TOOM4_THRESHOLD
+#define MPN_TOOM4_THRESHOLD (25600 / WORD_BITLEN)
+#endif
+
+/**
+ * @def MPN_FFT_THRESHOLD
+ * @brief Default operand size in words from which multiplication and squaring use the three-prime NTT.
+ * @details The transform works on 32-bit chunks whatever the word size, while the other algorithms slow down
+ *          with narrower words, so the crossover moves: about 160k bits with 64-bit words, 8k bits with 32-bit
+ *          words and 1k bits with 8-bit words.
+ */
+#ifndef MPN_FFT_THRESHOLD
+#if WORD_BITLEN == 64
+#define MPN_FFT_THRESHOLD 2560
+#elif WORD_BITLEN == 32
+#define MPN_FFT_THRESHOLD 256
+#else
+#define MPN_FFT_THRESHOLD 128
+#endif
+#endif
+
+/**
+ * @def MPN_BZ_THRESHOLD
+ * @brief Default divisor size in words from which division recurses with Burnikel-Ziegler.
+ * @details Where the recursion's products start to beat the schoolbook rows: about 2k bits with 64-bit and
+ *          32-bit words, and 512 bits with 8-bit words, whose rows are slow. A build override takes precedence
+ *          over mpn_tune.h, as with MPN_KARATSUBA_THRESHOLD.
+ */
+#ifndef MPN_BZ_THRESHOLD
+#if WORD_BITLEN == 64
+#define MPN_BZ_THRESHOLD 32
+#elif WORD_BITLEN == 32
+#define MPN_BZ_THRESHOLD 48
+#else
+#define MPN_BZ_THRESHOLD 64
+#endif
+#endif
+
+/**
+ * @def MPN_HGCD_THRESHOLD
+ * @brief Default operand size in words from which EEA reduces with the half-GCD recursion.
+ * @details Below it, the Lehmer runs of mpn_gcd_lehmer take each operand pass; above it, the recursion on the
+ *          top halves batches them into matrix products. About 100 words at each WORD_BITLEN, with EEA on
+ *          random operands of 64 to 2048 words; `make tune` does not measure it, as the recursion runs on BINTs.
+ */
+#ifndef MPN_HGCD_THRESHOLD
+#define MPN_HGCD_THRESHOLD 100
+#endif
+
+// Initial values of the Toom, NTT and division thresholds below: the tuned crossovers from mpn_tune.h, or the defaults above
+#ifndef MPN_MUL_TOOM3_THRESHOLD
+#define MPN_MUL_TOOM3_THRESHOLD MPN_TOOM3_THRESHOLD
+#endif
+#ifndef MPN_SQR_TOOM3_THRESHOLD
+#define MPN_SQR_TOOM3_THRESHOLD MPN_TOOM3_THRESHOLD
+#endif
+#ifndef MPN_MUL_TOOM4_THRESHOLD
+#define MPN_MUL_TOOM4_THRESHOLD MPN_TOOM4_THRESHOLD
+#endif
+#ifndef MPN_SQR_TOOM4_THRESHOLD
+#define MPN_SQR_TOOM4_THRESHOLD MPN_TOOM4_THRESHOLD
+#endif
+#ifndef MPN_MUL_FFT_THRESHOLD
+#define MPN_MUL_FFT_THRESHOLD MPN_FFT_THRESHOLD
+#endif
+#ifndef MPN_SQR_FFT_THRESHOLD
+#define MPN_SQR_FFT_THRESHOLD MPN_FFT_THRESHOLD
+#endif
+#ifndef MPN_DIV_BZ_THRESHOLD
+#define MPN_DIV_BZ_THRESHOLD MPN_BZ_THRESHOLD
+#endif
+
+/**
+ * @brief Operand size in words from which mpn_mul_n and mpn_mul split with Karatsuba; below it they use the
+ *        basecase kernels.
+ * @details Starts at MPN_MUL_KARATSUBA_THRESHOLD. The tuning program varies it at run time to find the
+ *          crossover; other callers should leave it alone, and must not change it between taking the scratch
+ *          size from mpn_mul_n_itch or mpn_mul_itch and the call that uses it. At least 2.
+ */
+extern int mpn_mul_karatsuba_threshold;
+
+/**
+ * @brief Operand size in words from which mpn_sqr_n splits with Karatsuba, as mpn_mul_karatsuba_threshold.
+ */
+extern int mpn_sqr_karatsuba_threshold;
+
+/**
+ * @brief Operand sizes in words from which mpn_mul_n uses Toom-3 and Toom-4, as mpn_mul_karatsuba_threshold.
+ * @details Toom-r cuts the operands into r pieces and is only used where each piece is nonempty; otherwise the
+ *          next smaller algorithm takes the level.
+ */
+extern int mpn_mul_toom3_threshold, mpn_mul_toom4_threshold;
+
+/**
+ * @brief Operand sizes in words from which mpn_sqr_n uses Toom-3 and Toom-4.
+ */
+extern int mpn_sqr_toom3_threshold, mpn_sqr_toom4_threshold;
+
+/**
+ * @brief Operand sizes in words from which mpn_mul_n, mpn_mul and mpn_sqr_n multiply by the NTT, as
+ *        mpn_mul_karatsuba_threshold; mpn_mul compares its shorter operand.
+ * @details Products too large for the transform, see mpn_mul_fft, stay with Toom-4.
+ */
+extern int mpn_mul_fft_threshold, mpn_sqr_fft_threshold;
+
+/**
+ * @brief Divisor and quotient size in words from which mpn_div_qr divides with Burnikel-Ziegler, as
+ *        mpn_mul_karatsuba_threshold; below it, and in the recursion, it uses the schoolbook rows. At least 2.
+ */
+extern int mpn_div_bz_threshold;
+
+/**
+ * @brief Operand size in words from which EEA reduces with the half-GCD recursion, as
+ *        mpn_mul_karatsuba_threshold; below it, and at the leaves of the recursion, it takes Lehmer steps. At
+ *        least 4.
+ */
+extern int mpn_hgcd_threshold;
+
+/**
+ * @brief Sets n words to zero.
+ * @param rp The destination array.
+ * @param n The number of words, may be zero.
+ */
+void mpn_zero(WORD* rp, int n);
+
+/**
+ * @brief Copies n words; the arrays may overlap.
+ * @param rp The destination array.
+ * @param ap The source array.
+ * @param n The number of words, may be zero.
+ */
+void mpn_copy(WORD* rp, const WORD* ap, int n);
+
+/**
+ * @brief Strips leading zero words.
+ * @param ap The array.
+ * @param n The number of words.
+ * @return The number of words without the leading zeros, 0 for a zero value.
+ */
+int mpn_normalize(const WORD* ap, int n);
+
+/**
+ * @brief Compares two numbers of n words each.
+ * @param ap The first operand.
+ * @param bp The second operand.
+ * @param n The number of words, may be zero.
+ * @return 1 if a > b, -1 if a < b and 0 if they are equal.
+ */
+int mpn_cmp(const WORD* ap, const WORD* bp, int n);
+
+/**
+ * @brief rp <- ap + bp over n words.
+ * @return The carry out of the top word, 0 or 1.
+ */
+WORD mpn_add_n(WORD* rp, const WORD* ap, const WORD* bp, int n);
+
+/**
+ * @brief rp <- ap - bp over n words.
+ * @return The borrow out of the top word, 0 or 1.
+ */
+WORD mpn_sub_n(WORD* rp, const WORD* ap, const WORD* bp, int n);
+
+/**
+ * @brief rp <- ap + b for a single word b; rp gets an words.
+ * @return The carry out of the top word.
+ */
+WORD mpn_add_1(WORD* rp, const WORD* ap, int an, WORD b);
+
+/**
+ * @brief rp <- ap - b for a single word b; rp gets an words.
+ * @return The borrow out of the top word.
+ */
+WORD mpn_sub_1(WORD* rp, const WORD* ap, int an, WORD b);
+
+/**
+ * @brief rp <- ap + bp for operands of different lengths; rp gets an words.
+ * @pre an >= bn.
+ * @return The carry out of the top word.
+ */
+WORD mpn_add(WORD* rp, const WORD* ap, int an, const WORD* bp, int bn);
+
+/**
+ * @brief rp <- ap - bp for operands of different lengths; rp gets an words.
+ * @pre an >= bn.
+ * @return The borrow out of the top word.
+ */
+WORD mpn_sub(WORD* rp, const WORD* ap, int an, const WORD* bp, int bn);
+
+/**
+ * @brief rp <- ap * b over n words.
+ * @return The high word of the product.
+ */
+WORD mpn_mul_1(WORD* rp, const WORD* ap, int n, WORD b);
+
+/**
+ * @brief rp <- rp + ap * b over n words.
+ * @details The row operation of schoolbook multiplication and of Montgomery reduction.
+ * @return The word carried out of position n - 1.
+ */
+WORD mpn_addmul_1(WORD* rp, const WORD* ap, int n, WORD b);
+
+/**
+ * @brief rp <- rp - ap * b over n words.
+ * @details The row operation of long division.
+ * @return The word borrowed out of position n - 1.
+ */
+WORD mpn_submul_1(WORD* rp, const WORD* ap, int n, WORD b);
+
+/**
+ * @brief rp <- ap << cnt over n words.
+ * @pre 0 < cnt < WORD_BITLEN. rp may equal ap, or lie above it.
+ * @return The cnt bits shifted out of the top word, in the low bits of the result.
+ */
+WORD mpn_lshift(WORD* rp, const WORD* ap, int n, int cnt);
+
+/**
+ * @brief rp <- ap >> cnt over n words.
+ * @pre 0 < cnt < WORD_BITLEN. rp may equal ap, or lie below it.
+ * @return The cnt bits shifted out of the bottom word, in the high bits of the result.
+ */
+WORD mpn_rshift(WORD* rp, const WORD* ap, int n, int cnt);
+
+/**
+ * @brief rp <- ap * bp by schoolbook multiplication, one mpn_addmul_1 row per word of bp.
+ * @param rp The product, an + bn words, disjoint from the operands.
+ * @pre an >= 1 and bn >= 1.
+ */
+void mpn_mul_basecase(WORD* rp, const WORD* ap, int an, const WORD* bp, int bn);
+
+/**
+ * @brief rp <- ap^2 with each cross product computed once and doubled.
+ * @param rp The square, 2n words, disjoint from the operand.
+ */
+void mpn_sqr_basecase(WORD* rp, const WORD* ap, int n);
+
+/**
+ * @brief rp <- ap * bp by product scanning (Comba): each word of rp is one column of partial products, summed
+ *        in a three-word accumulator and written once.
+ * @param rp The product, an + bn words, disjoint from the operands.
+ * @pre an >= 1, bn >= 1 and min(an, bn) <= 2^WORD_BITLEN, so that a column sum fits in three words.
+ */
+void mpn_mul_comba(WORD* rp, const WORD* ap, int an, const WORD* bp, int bn);
+
+/**
+ * @brief rp <- ap^2 by product scanning, each cross product of a column computed once and doubled.
+ * @param rp The square, 2n words, disjoint from the operand.
+ * @pre n <= 2^WORD_BITLEN.
+ */
+void mpn_sqr_comba(WORD* rp, const WORD* ap, int n);
+
+/**
+ * @brief Number of scratch words that mpn_mul_fft and mpn_sqr_fft need for an-word by bn-word operands.
+ */
+int mpn_mul_fft_itch(int an, int bn);
+
+/**
+ * @brief rp <- ap * bp by number-theoretic transforms modulo three 31-bit primes.
+ * @details The operands are read as polynomials in 32-bit chunks, transformed over a power-of-two length,
+ *          multiplied pointwise and transformed back, and the coefficients are put together from their three
+ *          residues by the Chinese remainder theorem. The butterflies and pointwise products run eight at a
+ *          time with AVX2 on x86-64 processors that have it, chosen at run time.
+ * @param rp The product, an + bn words, disjoint from the operands.
+ * @param ws Scratch space of mpn_mul_fft_itch(an, bn) words.
+ * @pre an, bn >= 1 and an + bn < 2^29 / WORD_BITLEN, a product of less than 2^29 bits.
+ */
+void mpn_mul_fft(WORD* rp, const WORD* ap, int an, const WORD* bp, int bn, WORD* ws);
+
+/**
+ * @brief rp <- ap^2 as mpn_mul_fft, transforming the operand once.
+ * @param rp The square, 2n words, disjoint from the operand.
+ * @param ws Scratch space of mpn_mul_fft_itch(n, n) words.
+ * @pre n >= 1 and n < 2^28 / WORD_BITLEN.
+ */
+void mpn_sqr_fft(WORD* rp, const WORD* ap, int n, WORD* ws);
+
+/**
+ * @brief Number of scratch words that mpn_mul_n and mpn_sqr_n need for n-word operands.
+ */
+int mpn_mul_n_itch(int n);
+
+/**
+ * @brief rp <- ap * bp for two n-word operands.
+ * @details Uses the basecase below mpn_mul_karatsuba_threshold words, then Karatsuba, Toom-3 from
+ *          mpn_mul_toom3_threshold and Toom-4 from mpn_mul_toom4_threshold words on, and mpn_mul_fft from
+ *          mpn_mul_fft_threshold. Every level takes its temporaries from ws and recurses through mpn_mul_n.
+ * @param rp The product, 2n words, disjoint from the operands.
+ * @param ws Scratch space of mpn_mul_n_itch(n) words.
+ */
+void mpn_mul_n(WORD* rp, const WORD* ap, const WORD* bp, int n, WORD* ws);
+
+/**
+ * @brief rp <- ap^2 for an n-word operand, choosing among the basecase, Karatsuba, Toom-3, Toom-4 and the NTT
+ *        by the mpn_sqr_* thresholds as mpn_mul_n does.
+ * @param rp The square, 2n words, disjoint from the operand.
+ * @param ws Scratch space of mpn_mul_n_itch(n) words.
+ */
+void mpn_sqr_n(WORD* rp, const WORD* ap, int n, WORD* ws);
+
+/**
+ * @brief Number of scratch words that mpn_mul needs for an-word by bn-word operands.
+ */
+int mpn_mul_itch(int an, int bn);
+
+/**
+ * @brief rp <- ap * bp for operands of any lengths.
+ * @details The longer operand is cut into pieces as long as the shorter one, and each piece is multiplied with
+ *          mpn_mul_n, so unbalanced products still use Karatsuba. From mpn_mul_fft_threshold
+ *          words on, the NTT takes both operands whole.
+ * @param rp The product, an + bn words, disjoint from the operands.
+ * @param ws Scratch space of mpn_mul_itch(an, bn) words.
+ * @pre an >= bn >= 1.
+ */
+void mpn_mul(WORD* rp, const WORD* ap, int an, const WORD* bp, int bn, WORD* ws);
+
+/**
+ * @brief Binary long division: qp <- floor(np / dp), rp <- np mod dp.
+ * @details Restoring shift-and-subtract over the bits of np, each step a word-wise shift and subtraction.
+ * @param qp The quotient, nn words.
+ * @param rp The remainder, dn + 1 words; the top word ends up zero.
+ * @param np The dividend, nn words.
+ * @param dp The divisor, dn words, nonzero.
+ * @pre qp and rp are disjoint from each other and from the operands.
+ */
+void mpn_div_binary(WORD* qp, WORD* rp, const WORD* np, int nn, const WORD* dp, int dn);
+
+/**
+ * @brief The reciprocal floor((W^2 - 1) / d) - W of a normalized divisor word, W = 2^WORD_BITLEN.
+ * @details Computed once per divisor, it turns each 2-by-1 quotient step of mpn_div_qr into a product and a few
+ *          corrections (Moller and Granlund, "Improved division by invariant integers").
+ * @pre The top bit of d is set.
+ */
+WORD mpn_invert_limb(WORD d);
+
+/**
+ * @brief Number of scratch words that mpn_div_qr needs for an nn-word dividend and a dn-word divisor.
+ */
+int mpn_div_qr_itch(int nn, int dn);
+
+/**
+ * @brief Long division (Knuth, TAOCP vol. 2, 4.3.1, Algorithm D, and Burnikel-Ziegler for large operands):
+ *        qp <- floor(np / dp), rp <- np mod dp.
+ * @details Both operands are shifted until the divisor's top bit is set. Each quotient word is then estimated
+ *          from the top two words of the running remainder with mpn_invert_limb's reciprocal, corrected against
+ *          the second divisor word, so that it is at most one too large, and the divisor times it is taken off
+ *          with mpn_submul_1 and added back once if that went negative. A one-word divisor needs the 2-by-1
+ *          steps alone.
+ *
+ *          From mpn_div_bz_threshold divisor and quotient words on, the quotient is produced in blocks of dn
+ *          words by Burnikel-Ziegler recursion instead ("Fast recursive division", 1998): each half of a block
+ *          comes from the top halves of the operands, and the remainder is corrected with mpn_mul, so the cost
+ *          follows that of multiplication, about 2 M(dn) log dn per block, rather than dn^2.
+ * @param qp The quotient, nn words.
+ * @param rp The remainder, dn + 1 words; the top word ends up zero.
+ * @param np The dividend, nn words.
+ * @param dp The divisor, dn words with a nonzero top word.
+ * @param ws Scratch space of mpn_div_qr_itch(nn, dn) words.
+ * @pre qp, rp and ws are disjoint from each other and from the operands.
+ */
+void mpn_div_qr(WORD* qp, WORD* rp, const WORD* np, int nn, const WORD* dp, int dn, WORD* ws);
+
+/**
+ * @brief Number of scratch words that mpn_invert needs for an n-word divisor.
+ */
+int mpn_invert_itch(int n);
+
+/**
+ * @brief The reciprocal floor((W^(2n) - 1) / dp) - W^n of a normalized n-word divisor, the multi-word
+ *        mpn_invert_limb.
+ * @details Newton iteration on the full reciprocal: the top ceil(n / 2) words of dp give the top half of it by
+ *          recursion, and one step x + x * (W^(2n) - dp * x) / W^(2n) doubles the precision with two products,
+ *          after which a third product with dp settles the last few units. The cost is a small multiple of one
+ *          n-word multiplication. Below mpn_div_bz_threshold words, where division is schoolbook anyway, the
+ *          reciprocal comes from a single mpn_div_qr.
+ * @param ip The reciprocal, n words.
+ * @param dp The divisor, n words with the top bit set.
+ * @param ws Scratch space of mpn_invert_itch(n) words.
+ * @pre ip and ws are disjoint from each other and from dp.
+ */
+void mpn_invert(WORD* ip, const WORD* dp, int n, WORD* ws);
+
+/**
+ * @brief Number of scratch words that mpn_div_qr_preinv needs for an nn-word dividend and a dn-word divisor.
+ */
+int mpn_div_qr_preinv_itch(int nn, int dn);
+
+/**
+ * @brief Division by an invariant divisor: qp <- floor(np / d), rp <- np mod d, where dp = d << s is normalized
+ *        and ip = mpn_invert(dp) was computed once for it.
+ * @details The quotient is produced in blocks of dn words from the top. Each block is estimated as
+ *          T + floor(T * ip / W^dn) from its top words T, which is at most a few units low, and the remainder is
+ *          settled from there, so a block costs two multiplications instead of a recursive division. That only
+ *          pays once the products reach the NTT, so below mpn_mul_fft_threshold (or mpn_div_bz_threshold) divisor
+ *          words it divides as mpn_div_qr does, on the normalized divisor.
+ * @param qp The quotient, nn words.
+ * @param rp The remainder, dn + 1 words; the top word ends up zero.
+ * @param np The dividend, nn words.
+ * @param dp The normalized divisor, dn words with the top bit set.
+ * @param ip mpn_invert(dp), dn words.
+ * @param s The shift that normalized the divisor, 0 <= s < WORD_BITLEN.
+ * @param ws Scratch space of mpn_div_qr_preinv_itch(nn, dn) words.
+ * @pre qp, rp and ws are disjoint from each other and from the operands.
+ */
+void mpn_div_qr_preinv(WORD* qp, WORD* rp, const WORD* np, int nn, const WORD* dp, int dn, const WORD* ip, int s,
+                       WORD* ws);
+
+/**
+ * @brief A run of Euclid steps on a and b decided from their leading bits (Lehmer; Knuth, TAOCP vol. 2, 4.5.2).
+ * @details The top 2 WORD_BITLEN - 2 bits of the larger value, and the same bits of the other, go through the
+ *          remainder sequence with single-word cofactors. Below those bits, a value reached through the row (x, y)
+ *          differs from its leading part by less than max(x, y) units, so a step is taken only while these bounds
+ *          keep its remainder within [0, b), which makes its quotient the true one, and at least W^s. When the
+ *          values fit in the kept bits the steps are exact and run to the end.
+ *
+ *          The cofactors of consecutive remainders alternate in sign, so the run is kept as magnitudes: k steps
+ *          take (a, b) to ((-1)^k (x0 a - y0 b), (-1)^(k+1) (x1 a - y1 b)), and a following run with rows
+ *          (x0', y0'), (x1', y1') composes as the matrix product, see mpn_gcd_mul_1.
+ * @param m The row matrix {x0, y0, x1, y1}, four words.
+ * @param ap The value a, n words; leading zero words are allowed.
+ * @param bp The value b, n words; a and b are not both zero.
+ * @param s The floor: no remainder falls below W^s, where a and b start at or above it, or -1 for none.
+ * @return k, the number of steps; 0 if the leading bits do not decide even the first quotient, or it does not fit
+ *         a word.
+ */
+int mpn_gcd_lehmer(WORD* m, const WORD* ap, const WORD* bp, int n, int s);
+
+/**
+ * @brief (a, b) <- ((-1)^k (x0 a - y0 b), (-1)^(k+1) (x1 a - y1 b)) for k steps of mpn_gcd_lehmer, in one pass.
+ * @param ap The value a, n words, replaced in place.
+ * @param bp The value b, n words, replaced in place.
+ * @param m The row matrix {x0, y0, x1, y1} from mpn_gcd_lehmer.
+ * @param k Its number of steps.
+ */
+void mpn_gcd_apply_1(WORD* ap, WORD* bp, int n, const WORD* m, int k);
+
+/**
+ * @brief (u, v) <- (x0 u + y0 v, x1 u + y1 v) for a single-word row matrix m, in one pass.
+ * @details Carries a run of mpn_gcd_lehmer steps into the cofactor magnitudes of a, or into each column of the
+ *          row matrix of an earlier run.
+ * @param up The value u, n words with room for n + 2.
+ * @param vp The value v, n words with room for n + 2.
+ * @param m The row matrix {x0, y0, x1, y1}.
+ */
+void mpn_gcd_mul_1(WORD* up, WORD* vp, int n, const WORD* m);
+
+/**
+ * @brief Number of scratch words that mpn_gcd_binary needs for an an-word and a bn-word operand.
+ */
+int mpn_gcd_binary_itch(int an, int bn);
+
+/**
+ * @brief rp <- gcd(ap, bp) by Stein's binary algorithm, in time that depends on the operands.
+ * @details The common power of two comes off first; then the smaller odd value is subtracted from the larger and
+ *          the difference shifted down to odd again in the same pass, until the values meet, and the last two
+ *          words finish in the double-word type. Quadratic, without divisions, for public operands of similar
+ *          lengths; gcd(a, 0) = a.
+ * @param rp The GCD, with room for max(an, bn) words.
+ * @param ws Scratch space of mpn_gcd_binary_itch(an, bn) words.
+ * @return The significant words of the GCD, 0 if both operands are zero.
+ */
+int mpn_gcd_binary(WORD* rp, const WORD* ap, int an, const WORD* bp, int bn, WORD* ws);
+
+/**
+ * @brief Number of scratch words that mpn_sec_invert needs for an n-word modulus.
+ */
+int mpn_sec_invert_itch(int n);
+
+/**
+ * @brief rp <- ap^(-1) mod mp by Bernstein-Yang divsteps, in time that depends only on n and the bit length of mp.
+ * @details From (f, g) = (m, a), batches of WORD_BITLEN - 2 divsteps are decided from the low words alone, with
+ *          masks instead of branches, and applied as a 2x2 matrix to f and g in two's complement and to their
+ *          cofactors modulo m, which each batch also divides by 2^(WORD_BITLEN - 2) by adding a multiple of m.
+ *          The number of batches is fixed by the bound of Bernstein and Yang ("Fast constant-time gcd
+ *          computation and modular inversion", 2019), (49 b + 80) / 17 divsteps for a b-bit modulus, after which
+ *          f = +-gcd(a, m).
+ * @param rp The inverse, n words, in [0, m); meaningless when false is returned.
+ * @param ap The value, n words, below mp.
+ * @param mp The modulus, n words, odd, with a nonzero top word.
+ * @param ws Scratch space of mpn_sec_invert_itch(n) words.
+ * @return Whether gcd(a, m) = 1; this is the only outcome that depends on a.
+ */
+bool mpn_sec_invert(WORD* rp, const WORD* ap, const WORD* mp, int n, WORD* ws);
+
+#endif // _MPN_H
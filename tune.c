@@ -0,0 +1,174 @@
+/**
+ * @file tune.c
+ * @brief Measures the multiplication and division crossovers of the mpn kernels on this host.
+ *
+ * `make tune` builds this program against the library, runs it and saves its
+ * output as mpn_tune.h, which mpn.h picks up as the default thresholds unless
+ * the build sets MPN_KARATSUBA_THRESHOLD, MPN_TOOM3_THRESHOLD,
+ * MPN_TOOM4_THRESHOLD, MPN_FFT_THRESHOLD or MPN_BZ_THRESHOLD itself. Every
+ * crossover is found the same way: for each operand size n the program times
+ * mpn_mul_n, mpn_sqr_n or mpn_div_qr once with the smaller algorithm at the top
+ * and once with the larger one, and reports the smallest size from which the
+ * larger one keeps winning. Karatsuba is measured over the basecase, Toom-3
+ * over the tuned Karatsuba and Toom-4 over the tuned Toom-3. The NTT is measured
+ * over all of them from the Karatsuba crossover on, since with narrow words it
+ * can win before Toom-4 does. Burnikel-Ziegler
+ * division is measured last, on 2n-word dividends by n-word divisors, since its
+ * recursion runs on the tuned products. The thresholds are for the WORD_BITLEN
+ * the library was built with.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "mpn.h"
+
+#define TUNE_MIN_WORDS 4
+#define TUNE_MAX_WORDS (524288 / WORD_BITLEN) // the largest operands measured, 524288 bits
+#define TUNE_CONFIRM 4                        // consecutive sizes the larger algorithm must win
+#define TUNE_ROUNDS 9                         // timings per size and method; the fastest one counts
+#define TUNE_MIN_SECONDS 2e-4                 // the shortest timed batch
+
+// What a timing measures: a product or a square of n words, or a division of 2n words by n
+enum { TUNE_MUL, TUNE_SQR, TUNE_DIV };
+
+static WORD ap[TUNE_MAX_WORDS], bp[TUNE_MAX_WORDS], rp[2 * TUNE_MAX_WORDS];
+static WORD np[2 * TUNE_MAX_WORDS], qp[2 * TUNE_MAX_WORDS];
+static WORD* ws = NULL;
+static int ws_len = 0;
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Seconds per call of one operation op on n words under the current thresholds
+static double time_once(int n, int op, int reps) {
+    int itch = op == TUNE_DIV ? mpn_div_qr_itch(2 * n, n) : mpn_mul_n_itch(n);
+    if (itch > ws_len) {
+        ws = realloc(ws, itch * sizeof(WORD));
+        if (ws == NULL) {
+            fprintf(stderr, "Error: Out of memory in 'time_once'\n");
+            exit(1);
+        }
+        ws_len = itch;
+    }
+    double start = now();
+    for (int i = 0; i < reps; i++) {
+        if (op == TUNE_DIV)
+            mpn_div_qr(qp, rp, np, 2 * n, bp, n, ws);
+        else if (op == TUNE_SQR)
+            mpn_sqr_n(rp, ap, n, ws);
+        else
+            mpn_mul_n(rp, ap, bp, n, ws);
+    }
+    return (now() - start) / reps;
+}
+
+// Calls per timed batch, so that a batch runs for at least TUNE_MIN_SECONDS
+static int batch_size(int n, int op) {
+    int reps = 1;
+    while (time_once(n, op, reps) * reps < TUNE_MIN_SECONDS)
+        reps *= 2;
+    return reps;
+}
+
+// Whether the algorithm *threshold switches on beats the one below it at n words; the two are timed in turns to
+// share the noise
+static bool larger_wins(int* threshold, int n, int op) {
+    *threshold = n + 1;
+    int reps = batch_size(n, op);
+    double below = 1e9, above = 1e9;
+    for (int r = 0; r < TUNE_ROUNDS; r++) {
+        *threshold = n + 1;
+        double t = time_once(n, op, reps);
+        below = t < below ? t : below;
+        *threshold = n;
+        t = time_once(n, op, reps);
+        above = t < above ? t : above;
+    }
+    return above < below;
+}
+
+// The smallest size from `from` on at which *threshold's algorithm wins TUNE_CONFIRM measured sizes in a row, and
+// every size up to span times the first one, or one past the range if it never does; *threshold is left at the
+// result. Sizes grow by about 3% a step. The NTT pads to a power of two, so its cost climbs in steps and it needs
+// a span of 2 to see a whole step.
+static int crossover(int* threshold, int from, int op, int span) {
+    int run = 0, first = 0;
+    for (int n = from; n <= TUNE_MAX_WORDS; n += 1 + n / 32) {
+        if (!larger_wins(threshold, n, op)) {
+            run = 0;
+            continue;
+        }
+        if (run++ == 0)
+            first = n;
+        if (run >= TUNE_CONFIRM && n >= span * first) {
+            *threshold = first;
+            return first;
+        }
+    }
+    *threshold = TUNE_MAX_WORDS + 1;
+    return *threshold;
+}
+
+int main(void) {
+    srand((unsigned int)time(NULL));
+    for (int i = 0; i < TUNE_MAX_WORDS; i++) {
+        ap[i] = (WORD)rand() * (WORD)2654435761u + (WORD)rand();
+        bp[i] = (WORD)((WORD)rand() * (WORD)2246822519u + (WORD)rand()) | WORD_ONE;     // nonzero divisor tops
+    }
+    for (int i = 0; i < 2 * TUNE_MAX_WORDS; i++)
+        np[i] = (WORD)rand() * (WORD)2654435761u + (WORD)rand();
+
+    // Each search runs with the larger algorithms out of the way and the smaller ones already tuned
+    mpn_mul_toom3_threshold = mpn_sqr_toom3_threshold = TUNE_MAX_WORDS + 1;
+    mpn_mul_toom4_threshold = mpn_sqr_toom4_threshold = TUNE_MAX_WORDS + 1;
+    mpn_mul_fft_threshold = mpn_sqr_fft_threshold = TUNE_MAX_WORDS + 1;
+    mpn_div_bz_threshold = TUNE_MAX_WORDS + 1;
+    int mul_kara = crossover(&mpn_mul_karatsuba_threshold, TUNE_MIN_WORDS, TUNE_MUL, 1);
+    int sqr_kara = crossover(&mpn_sqr_karatsuba_threshold, TUNE_MIN_WORDS, TUNE_SQR, 1);
+    int mul_toom3 = crossover(&mpn_mul_toom3_threshold, mul_kara + 1, TUNE_MUL, 1);
+    int sqr_toom3 = crossover(&mpn_sqr_toom3_threshold, sqr_kara + 1, TUNE_SQR, 1);
+    int mul_toom4 = crossover(&mpn_mul_toom4_threshold, mul_toom3 + 1, TUNE_MUL, 1);
+    int sqr_toom4 = crossover(&mpn_sqr_toom4_threshold, sqr_toom3 + 1, TUNE_SQR, 1);
+    int mul_fft = crossover(&mpn_mul_fft_threshold, mul_kara + 1, TUNE_MUL, 2);
+    int sqr_fft = crossover(&mpn_sqr_fft_threshold, sqr_kara + 1, TUNE_SQR, 2);
+    int div_bz = crossover(&mpn_div_bz_threshold, TUNE_MIN_WORDS, TUNE_DIV, 1);
+    free(ws);
+    fprintf(stderr, "%d-bit words: products Karatsuba from %d words, Toom-3 from %d, Toom-4 from %d, NTT from %d\n",
+            WORD_BITLEN, mul_kara, mul_toom3, mul_toom4, mul_fft);
+    fprintf(stderr, "%d-bit words: squares Karatsuba from %d words, Toom-3 from %d, Toom-4 from %d, NTT from %d\n",
+            WORD_BITLEN, sqr_kara, sqr_toom3, sqr_toom4, sqr_fft);
+    fprintf(stderr, "%d-bit words: division Burnikel-Ziegler from %d words\n", WORD_BITLEN, div_bz);
+
+    printf("/**\n");
+    printf(" * @file mpn_tune.h\n");
+    printf(" * @brief Multiplication and division crossovers measured on this host by `make tune`; rerun it rather than editing.\n");
+    printf(" */\n\n");
+    printf("#if WORD_BITLEN == %d\n", WORD_BITLEN);
+    printf("#ifndef MPN_KARATSUBA_THRESHOLD\n");
+    printf("#define MPN_MUL_KARATSUBA_THRESHOLD %d\n", mul_kara);
+    printf("#define MPN_SQR_KARATSUBA_THRESHOLD %d\n", sqr_kara);
+    printf("#endif\n");
+    printf("#ifndef MPN_TOOM3_THRESHOLD\n");
+    printf("#define MPN_MUL_TOOM3_THRESHOLD %d\n", mul_toom3);
+    printf("#define MPN_SQR_TOOM3_THRESHOLD %d\n", sqr_toom3);
+    printf("#endif\n");
+    printf("#ifndef MPN_TOOM4_THRESHOLD\n");
+    printf("#define MPN_MUL_TOOM4_THRESHOLD %d\n", mul_toom4);
+    printf("#define MPN_SQR_TOOM4_THRESHOLD %d\n", sqr_toom4);
+    printf("#endif\n");
+    printf("#ifndef MPN_FFT_THRESHOLD\n");
+    printf("#define MPN_MUL_FFT_THRESHOLD %d\n", mul_fft);
+    printf("#define MPN_SQR_FFT_THRESHOLD %d\n", sqr_fft);
+    printf("#endif\n");
+    printf("#ifndef MPN_BZ_THRESHOLD\n");
+    printf("#define MPN_DIV_BZ_THRESHOLD %d\n", div_bz);
+    printf("#endif\n");
+    printf("#endif\n");
+    return 0;
+}
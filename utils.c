@@ -11,7 +11,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
+#include <pthread.h>
 
 
 void exit_on_null_error(const void* ptr, const char* ptr_name, const char* function_name) {
@@ -21,31 +23,302 @@ void exit_on_null_error(const void* ptr, const char* ptr_name, const char* funct
     }
 }
 
+/*
+ * Per-thread arena for BINT temporaries
+ */
+
+// Blocks are carved from chunks by bumping `used`; every block is preceded by its capacity so that resizes
+// know how much to copy. Chunks above the current one are kept on a spare list until the arena is destroyed.
+typedef struct arena_chunk {
+    struct arena_chunk* prev;
+    size_t size;
+    size_t used;
+    _Alignas(16) unsigned char data[];
+} arena_chunk;
+
+#define ARENA_ALIGN 16
+#define ARENA_HEADER ARENA_ALIGN
+
+typedef struct {
+    arena_chunk* top;       // current chunk, linked to the older ones
+    arena_chunk* spare;     // released chunks, ready for reuse
+    int depth;              // number of open scopes
+    unsigned char* spill;   // staging area for the words of kept BINTs during a rollback
+    size_t spill_size;
+} bint_arena_state;
+
+static _Thread_local bint_arena_state arena;
+static _Thread_local size_t heap_calls;     // calls into malloc, calloc and realloc, for bint_heap_calls
+static pthread_key_t arena_key;
+static pthread_once_t arena_key_once = PTHREAD_ONCE_INIT;
+
+static void arena_free_chunks(arena_chunk* c) {
+    while (c) {
+        arena_chunk* prev = c->prev;
+        free(c);
+        c = prev;
+    }
+}
+
+// Key destructor, registered by arena_alloc when a thread mallocs its first chunk. It runs when such a thread
+// ends through pthread_exit or by returning from its start routine; the main thread leaves through exit(),
+// which runs no key destructors, so its arena lasts until bint_arena_release_thread or the end of the process
+static void arena_destroy(void* unused) {
+    (void)unused;
+    arena_free_chunks(arena.top);
+    arena_free_chunks(arena.spare);
+    free(arena.spill);
+    memset(&arena, 0, sizeof(arena));
+}
+
+static void arena_key_create(void) {
+    pthread_key_create(&arena_key, arena_destroy);
+}
+
+static void* arena_alloc(size_t bytes) {
+    size_t need = ARENA_HEADER + ((bytes + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1));
+    arena_chunk* c = arena.top;
+    if (!c || c->size - c->used < need) {
+        c = arena.spare;
+        if (c && c->size >= need) {
+            arena.spare = c->prev;
+        } else {
+            size_t size = MAXIMUM(need, (size_t)ARENA_CHUNK_BYTES);
+            c = malloc(sizeof(arena_chunk) + size);
+            heap_calls++;
+            exit_on_null_error(c, "chunk", "arena_alloc");
+            c->size = size;
+            pthread_once(&arena_key_once, arena_key_create);
+            pthread_setspecific(arena_key, &arena);
+        }
+        c->used = 0;
+        c->prev = arena.top;
+        arena.top = c;
+    }
+    unsigned char* p = c->data + c->used;
+    c->used += need;
+    *(size_t*)p = need - ARENA_HEADER;
+    return p + ARENA_HEADER;
+}
+
+// True if p lies in this thread's arena above mark; with mark at the bottom this is plain ownership
+static bool arena_since(const void* p, ArenaMark mark) {
+    uintptr_t a = (uintptr_t)p;
+    for (arena_chunk* c = arena.top; c; c = c->prev) {
+        if (a >= (uintptr_t)c->data && a < (uintptr_t)(c->data + c->used))
+            return c != mark.chunk || a >= (uintptr_t)(c->data + mark.used);
+        if (c == mark.chunk)
+            break;
+    }
+    return false;
+}
+
+static bool arena_owns(const void* p) {
+    ArenaMark bottom = { NULL, 0 };
+    return arena.top && arena_since(p, bottom);
+}
+
+static void arena_release(ArenaMark mark) {
+    while (arena.top && arena.top != mark.chunk) {
+        arena_chunk* c = arena.top;
+        arena.top = c->prev;
+        c->prev = arena.spare;
+        arena.spare = c;
+    }
+    if (arena.top)
+        arena.top->used = mark.used;
+}
+
+// The allocation primitives of every BINT: arena blocks inside a scope, the heap outside
+static void* bint_alloc(size_t bytes, bool zero) {
+    if (arena.depth > 0) {
+        void* p = arena_alloc(bytes);
+        if (zero)
+            memset(p, 0, bytes);
+        return p;
+    }
+    heap_calls++;
+    return zero ? calloc(MAXIMUM(bytes, (size_t)1), 1) : malloc(MAXIMUM(bytes, (size_t)1));
+}
+
+static void bint_free(void* p) {
+    if (p && !arena_owns(p))
+        free(p);
+}
+
+// Heap blocks keep growing with realloc even inside a scope; arena blocks move only when they outgrow their capacity
+static void* bint_realloc(void* p, size_t bytes) {
+    if (p && arena_owns(p)) {
+        size_t cap = *(size_t*)((unsigned char*)p - ARENA_HEADER);
+        if (bytes <= cap)
+            return p;
+        void* q = bint_alloc(bytes, false);
+        memcpy(q, p, cap);
+        return q;
+    }
+    heap_calls++;
+    return realloc(p, bytes);
+}
+
+ArenaMark bint_arena_begin(void) {
+    ArenaMark mark = { arena.top, arena.top ? arena.top->used : 0 };
+    arena.depth++;
+    return mark;
+}
+
+// Gives ptrBint fresh words for wordlen words: the inline ones when they suffice, else an exact-size block
+static void bint_set_words(BINT* ptrBint, int wordlen, bool zero) {
+    if (wordlen <= BINT_INLINE_WORDS) {
+        ptrBint->val = ptrBint->small;
+        ptrBint->capacity = BINT_INLINE_WORDS;
+        if (zero)
+            memset(ptrBint->small, 0, sizeof(ptrBint->small));
+        return;
+    }
+    ptrBint->val = (WORD*)bint_alloc((size_t)wordlen * sizeof(WORD), zero);
+    if (!ptrBint->val) {
+        fprintf(stderr, "Error: Unable to allocate memory for BINT val.\n");
+        exit(1);
+    }
+    ptrBint->capacity = wordlen;
+}
+
+// Moves the kept objects out of the region above mark, releases it and re-creates them in the current allocator
+static void arena_compact(ArenaMark mark, BINT** pptrKeep[], int keep_cnt) {
+    if (keep_cnt > ARENA_MAX_KEEP) {
+        fprintf(stderr, "Error: %d objects exceed ARENA_MAX_KEEP in 'bint_arena_rollback'\n", keep_cnt);
+        exit(1);
+    }
+    struct { BINT* old; BINT* ptr; BINT bint; bool moved; bool val_moved; size_t offset; } kept[ARENA_MAX_KEEP];
+
+    // Stage the words of every kept object that is about to be released
+    size_t spill = 0;
+    for (int i = 0; i < keep_cnt; i++) {
+        BINT* ptr = *pptrKeep[i];
+        kept[i].old = ptr;
+        kept[i].moved = kept[i].val_moved = false;
+        if (!ptr)
+            continue;
+        int first = 0;
+        while (kept[first].old != ptr)
+            first++;
+        if (first < i)
+            continue;
+        kept[i].bint = *ptr;
+        kept[i].moved = arena_since(ptr, mark);
+        kept[i].val_moved = ptr->val != ptr->small && arena_since(ptr->val, mark);
+        kept[i].offset = spill;
+        if (kept[i].val_moved)
+            spill += (size_t)MAXIMUM(ptr->wordlen, 0) * sizeof(WORD);
+    }
+    if (spill > arena.spill_size) {
+        unsigned char* tmp = realloc(arena.spill, spill);
+        heap_calls++;
+        exit_on_null_error(tmp, "spill", "bint_arena_rollback");
+        arena.spill = tmp;
+        arena.spill_size = spill;
+    }
+    for (int i = 0; i < keep_cnt; i++)
+        if (kept[i].old && kept[i].val_moved)
+            memcpy(arena.spill + kept[i].offset, kept[i].bint.val, (size_t)kept[i].bint.wordlen * sizeof(WORD));
+
+    arena_release(mark);
+
+    // Re-create them in whatever allocator is current: at the mark, in the enclosing scope or on the heap
+    for (int i = 0; i < keep_cnt; i++) {
+        BINT* ptr = kept[i].old;
+        if (!ptr)
+            continue;
+        int first = 0;
+        while (kept[first].old != ptr)
+            first++;
+        if (first == i) {
+            if (kept[i].moved) {
+                ptr = bint_alloc(sizeof(BINT), false);
+                *ptr = kept[i].bint;
+                if (kept[i].bint.val == kept[i].old->small)
+                    ptr->val = ptr->small;
+            }
+            if (kept[i].val_moved) {
+                size_t bytes = (size_t)kept[i].bint.wordlen * sizeof(WORD);
+                bint_set_words(ptr, kept[i].bint.wordlen, false);
+                memcpy(ptr->val, arena.spill + kept[i].offset, bytes);
+            }
+            kept[i].ptr = ptr;
+        }
+        *pptrKeep[i] = kept[first].ptr;
+    }
+}
+
+void bint_arena_rollback(ArenaMark mark, BINT** pptrKeep[], int keep_cnt) {
+    // Copying the kept objects costs about as much as the garbage they sit in, so small amounts are left for later
+    if (arena.top == mark.chunk && arena.top && arena.top->used - mark.used < ARENA_CHUNK_BYTES / 4)
+        return;
+    arena_compact(mark, pptrKeep, keep_cnt);
+}
+
+void bint_arena_end(ArenaMark mark, BINT** pptrKeep[], int keep_cnt) {
+    if (arena.depth <= 0) {
+        fprintf(stderr, "Error: no open scope in 'bint_arena_end'\n");
+        exit(1);
+    }
+    arena.depth--;
+    arena_compact(mark, pptrKeep, keep_cnt);
+}
+
+void bint_arena_release_thread(void) {
+    if (arena.depth > 0) {
+        fprintf(stderr, "Error: %d open scopes in 'bint_arena_release_thread'\n", arena.depth);
+        exit(1);
+    }
+    arena_destroy(NULL);
+}
+
+size_t bint_heap_calls(void) {
+    return heap_calls;
+}
+
 void delete_bint(BINT** pptrBint) {
     if(!(*pptrBint))
         return;
-    free((*pptrBint)->val);
-    free(*pptrBint);
+    if((*pptrBint)->val != (*pptrBint)->small)
+        bint_free((*pptrBint)->val);
+    bint_free(*pptrBint);
     *pptrBint = NULL;
 }
 
+void clear_bint(BINT* ptrBint) {
+    if(ptrBint->val != ptrBint->small)
+        bint_free(ptrBint->val);
+    bint_set_words(ptrBint, 1, true);
+    ptrBint->sign = false;
+    ptrBint->wordlen = 1;
+}
+
 void init_bint(BINT** pptrBint, int wordlen) {
-    if((*pptrBint) != NULL)
-        delete_bint(pptrBint);
+    if((*pptrBint) != NULL) {
+        // Reuse the structure, and the words too if they are large enough
+        if((*pptrBint)->capacity >= wordlen) {
+            memset((*pptrBint)->val, 0, (size_t)MAXIMUM(wordlen, 0) * sizeof(WORD));
+        } else {
+            if((*pptrBint)->val != (*pptrBint)->small)
+                bint_free((*pptrBint)->val);
+            bint_set_words(*pptrBint, wordlen, true);
+        }
+        (*pptrBint)->sign = false;
+        (*pptrBint)->wordlen = wordlen;
+        return;
+    }
 
     // Allocate memory for BINT structure
-    *pptrBint = (BINT*)malloc(sizeof(BINT));
+    *pptrBint = (BINT*)bint_alloc(sizeof(BINT), false);
     if(!(*pptrBint)) {
         fprintf(stderr, "Error: Unable to allocate memory for BINT.\n");
         exit(1);
     }
-    // Allocate memory for val (array of WORD)
-    (*pptrBint)->val = (WORD*)calloc(wordlen,sizeof(WORD));
-    if (!(*pptrBint)->val) {
-        free(*pptrBint); // Free the already allocated BINT memory
-        fprintf(stderr, "Error: Unable to allocate memory for BINT val.\n");
-        exit(1);
-    }
+    // Short values keep their words inline; longer ones get an array of WORD
+    bint_set_words(*pptrBint, wordlen, true);
+
     // Initialize structure members
     (*pptrBint)->sign = false;
     (*pptrBint)->wordlen = wordlen;
@@ -53,9 +326,12 @@ void init_bint(BINT** pptrBint, int wordlen) {
 
 void copyBINT(BINT** pptrBint_dst, BINT** pptrBint_src) {
     CHECK_PTR_AND_DEREF(pptrBint_src, "pptrBint_src", "copyBINT");
-    
-    // Initialize destination BINT structure with the same word length as the source
-    init_bint(pptrBint_dst, (*pptrBint_src)->wordlen);
+    if(*pptrBint_dst == *pptrBint_src)
+        return;
+
+    // Initialize destination BINT structure with the same word length as the source, unless it already has room
+    if(*pptrBint_dst == NULL || (*pptrBint_dst)->capacity < (*pptrBint_src)->wordlen)
+        init_bint(pptrBint_dst, (*pptrBint_src)->wordlen);
     
     // Copy each element of the val array from source to destination
     for(int i = 0; i < (*pptrBint_src)->wordlen; i++)
@@ -66,37 +342,70 @@ void copyBINT(BINT** pptrBint_dst, BINT** pptrBint_src) {
     (*pptrBint_dst)->sign = (*pptrBint_src)->sign;
 }
 
+void set_bint_u64(BINT** pptrBint, u64 value) {
+    int wordlen = (64 + WORD_BITLEN - 1) / WORD_BITLEN;
+    init_bint(pptrBint, wordlen);
+
+    // Fill the words from the least significant one
+    for (int i = 0; i < wordlen; i++) {
+        (*pptrBint)->val[i] = (WORD)value;
+        value = (value >> (WORD_BITLEN / 2)) >> (WORD_BITLEN - WORD_BITLEN / 2);   // by halves: 64-bit words shift it all out
+    }
+    refineBINT(*pptrBint);
+}
+
+u64 get_bint_u64(BINT* ptrBint) {
+    u64 value = 0;
+    for (int i = 0; i < ptrBint->wordlen && i * WORD_BITLEN < 64; i++)
+        value |= (u64)ptrBint->val[i] << (i * WORD_BITLEN);
+    return value;
+}
+
 void swapBINT(BINT** pptrBint1, BINT** pptrBint2) {
     if((*pptrBint1) != (*pptrBint2)) { // If they aren't the same pointer
-        // Swap the sign field of both BINTs using XOR swap algorithm
-        (*pptrBint1)->sign ^= (*pptrBint2)->sign;
-        (*pptrBint2)->sign ^= (*pptrBint1)->sign;
-        (*pptrBint1)->sign ^= (*pptrBint2)->sign;
+        // Swap every field, inline words included
+        BINT tmp = **pptrBint1;
+        **pptrBint1 = **pptrBint2;
+        **pptrBint2 = tmp;
+
+        // Inline values moved with their words, so their val pointers must follow
+        if((*pptrBint1)->val == (*pptrBint2)->small)
+            (*pptrBint1)->val = (*pptrBint1)->small;
+        if((*pptrBint2)->val == (*pptrBint1)->small)
+            (*pptrBint2)->val = (*pptrBint2)->small;
+    }
+}
 
-        // Swap the wordlen field of both BINTs using XOR swap algorithm
-        (*pptrBint1)->wordlen ^= (*pptrBint2)->wordlen;
-        (*pptrBint2)->wordlen ^= (*pptrBint1)->wordlen;
-        (*pptrBint1)->wordlen ^= (*pptrBint2)->wordlen;
+void reserveBINT(BINT* ptrBint, int capacity) {
+    if (capacity <= ptrBint->capacity)
+        return;
 
-        // Swap the val pointers of both BINTs
-        WORD* tmpVal = (*pptrBint1)->val;
-        (*pptrBint1)->val = (*pptrBint2)->val;
-        (*pptrBint2)->val = tmpVal;
+    // Grow geometrically so that repeated small extensions stay amortized O(1) per word
+    int new_capacity = MAXIMUM(capacity, 2 * ptrBint->capacity);
+    if (ptrBint->val == ptrBint->small) {
+        // Spill the inline words
+        WORD* tmp = (WORD*)bint_alloc((size_t)new_capacity * sizeof(WORD), false);
+        exit_on_null_error(tmp, "val", "reserveBINT");
+        memcpy(tmp, ptrBint->small, sizeof(ptrBint->small));
+        ptrBint->val = tmp;
+        ptrBint->capacity = new_capacity;
+        return;
+    }
+    WORD* tmp = (WORD*)bint_realloc(ptrBint->val, (size_t)new_capacity * sizeof(WORD));
+    if (!tmp) {
+        fprintf(stderr, "Error: Memory reallocation failed in 'reserveBINT'\n");
+        exit(1);
     }
+    ptrBint->val = tmp;
+    ptrBint->capacity = new_capacity;
 }
 
 void makeEven(BINT* ptrBint) {
     // Check if wordlen is odd
     if ((ptrBint)->wordlen % 2 == 1) {
+        reserveBINT(ptrBint, (ptrBint)->wordlen + 1);
         (ptrBint)->wordlen++; // Increment wordlen to make it even
 
-        // Reallocate memory for val
-        (ptrBint)->val = realloc((ptrBint)->val, (ptrBint)->wordlen * sizeof(WORD));
-        if (!(ptrBint)->val) {
-            // Handle memory allocation failure, exit or return an error
-            exit(1); 
-        }
-
         // Fill the new WORD with 0
         (ptrBint)->val[(ptrBint)->wordlen - 1] = (WORD)0;
     }
@@ -107,14 +416,7 @@ void matchSize(BINT* ptrBint1, BINT* ptrBint2) {
 
     // Resize ptrBint1 if its wordlen is smaller than max_wordlen
     if(ptrBint1->wordlen < max_wordlen) {
-        WORD* tmp = ptrBint1->val;
-        tmp = (WORD*)realloc(ptrBint1->val, max_wordlen * sizeof(WORD));
-        if (!tmp) {
-            // Handle memory allocation failure, exit or return an error
-            fprintf(stderr,"Memory allocation failure in 'matchSize'");
-            exit(1); 
-        }
-        ptrBint1->val = tmp;
+        reserveBINT(ptrBint1, max_wordlen);
 
         // Initialize the newly allocated WORDs with 0
         for(int i = ptrBint1->wordlen; i < max_wordlen; i++)
@@ -125,14 +427,7 @@ void matchSize(BINT* ptrBint1, BINT* ptrBint2) {
 
     // Resize ptrBint2 if its wordlen is smaller than max_wordlen
     if(ptrBint2->wordlen < max_wordlen) {
-        WORD* tmp = ptrBint2->val;
-        tmp = (WORD*)realloc(ptrBint2->val, max_wordlen * sizeof(WORD));
-        if (!tmp) {
-            // Handle memory allocation failure, exit or return an error
-            fprintf(stderr,"Memory allocation failure in 'matchSize'");
-            exit(1); 
-        }
-        ptrBint2->val = tmp;
+        reserveBINT(ptrBint2, max_wordlen);
 
         // Initialize the newly allocated WORDs with 0
         for(int i = ptrBint2->wordlen; i < max_wordlen; i++)
@@ -159,13 +454,8 @@ void refineBINT(BINT* ptrBint) {
         new_wordlen--;
     }
 
-    // Update the word length and reallocate memory if necessary
-    if(ptrBint->wordlen != new_wordlen) {
-        ptrBint->wordlen = new_wordlen;
-        WORD* tmp = ptrBint->val;
-        tmp = (WORD*)realloc(ptrBint->val, sizeof(WORD)*new_wordlen);
-        ptrBint->val = tmp;
-    }
+    // Update the word length; the words above it stay allocated
+    ptrBint->wordlen = new_wordlen;
 
     // Reset the sign to false if the BINT represents zero
     if((ptrBint->wordlen == 1) && (ptrBint->val[0] == 0))
@@ -177,13 +467,8 @@ void refine_BINT_word(BINT* ptrBint, int num_words) {
 
     int new_wordlen = ptrBint->wordlen - num_words;
     
-    // Update the word length and reallocate memory if necessary
-    if(ptrBint->wordlen != new_wordlen) {
-        ptrBint->wordlen = new_wordlen;
-        WORD* tmp = ptrBint->val;
-        tmp = (WORD*)realloc(ptrBint->val, sizeof(WORD)*new_wordlen);
-        ptrBint->val = tmp;
-    }
+    // Update the word length; the words above it stay allocated
+    ptrBint->wordlen = new_wordlen;
 
     // Reset the sign to false if the BINT represents zero
     if((ptrBint->wordlen == 1) && (ptrBint->val[0] == 0))
@@ -324,14 +609,8 @@ void left_shift_word(BINT** pptrBint, int shift_amount) {
 
     int new_len = (*pptrBint)->wordlen + shift_amount;
 
-    // Reallocate memory for the new word length
-    WORD* new_val = (*pptrBint)->val;
-    new_val = (WORD*)realloc((*pptrBint)->val, new_len * sizeof(WORD));
-    if (!new_val) {
-        fprintf(stderr, "Error: Memory reallocation failed in 'left_shift_word'\n");
-        exit(1);
-    }
-    (*pptrBint)->val = new_val; // Update the val pointer
+    // Make room for the new word length
+    reserveBINT(*pptrBint, new_len);
 
     // Shift the existing words to the left by the shift amount
     for (int i = new_len - 1; i >= shift_amount; i--) {
@@ -370,15 +649,6 @@ void right_shift_word(BINT** pptrBint, int shift_amount) {
         (*pptrBint)->val[i] = 0;
     }
 
-    // Reallocate memory for the new word length
-    WORD* new_val = (*pptrBint)->val;
-    new_val = (WORD*)realloc((*pptrBint)->val, new_len * sizeof(WORD));
-    if (!new_val) {
-        fprintf(stderr, "Error: Memory reallocation failed in 'right_shift_word'\n");
-        exit(1);
-    }
-    (*pptrBint)->val = new_val; // Update the val pointer
-
     // Update the word length
     (*pptrBint)->wordlen = new_len;
 }
@@ -404,20 +674,9 @@ void left_shift_bit(BINT** pptrBint, int shift_amount) {
         }
         if (carry) {
             // We need to increase the size of val to accommodate the new bit.
-            WORD* new_val = (*pptrBint)->val;
-            new_val = realloc((*pptrBint)->val, ((*pptrBint)->wordlen + 1) * sizeof(WORD));
-            if (new_val) {
-                (*pptrBint)->val = new_val;
-                (*pptrBint)->val[(*pptrBint)->wordlen] = carry; // Add the carried bit in the new WORD
-                (*pptrBint)->wordlen++; // Increment word length
-                // (*pptrBint)->val = new_val;
-                // (*pptrBint)->val[(*pptrBint)->wordlen] = 0; // Initialize the new WORD to zero before setting the carry bit.
-                // (*pptrBint)->val[(*pptrBint)->wordlen] |= carry; // Add the carried bit in the new WORD.
-                // (*pptrBint)->wordlen++;
-            } else {
-                fprintf(stderr, "Memory allocation failure during left shift operation.\n");
-                return; // Stop the function upon allocation failure.
-            }
+            reserveBINT(*pptrBint, (*pptrBint)->wordlen + 1);
+            (*pptrBint)->val[(*pptrBint)->wordlen] = carry; // Add the carried bit in the new WORD
+            (*pptrBint)->wordlen++; // Increment word length
         }
         shift_amount--;
     }
@@ -457,23 +716,7 @@ void reduction(BINT** pptrBint, int pwOf2) {
 
     // Check if the power of 2 is a multiple of WORD_BITLEN and less than current bit length
     if (pwOf2 % WORD_BITLEN == 0 && pwOf2 < BIT_LENGTH(*pptrBint)) {
-#if WORD_BITLEN == 8
-        // For 8-bit words, allocate memory for pwOf2/8 words
-        WORD* tmp = (*pptrBint)->val;
-        tmp = (WORD*)realloc(tmp, pwOf2 / WORD_BITLEN);
-        (*pptrBint)->val = tmp;
-#elif WORD_BITLEN == 64
-        // For 64-bit words, allocate memory for 8 times (pwOf2/64) words
-        WORD* tmp = (*pptrBint)->val;
-        tmp = (WORD*)realloc(tmp, 8 * (pwOf2 / WORD_BITLEN));
-        (*pptrBint)->val = tmp;
-#else
-        // For other word sizes (typically 32-bit), allocate memory for 4 times (pwOf2/WORD_BITLEN) words
-        WORD* tmp = (*pptrBint)->val;
-        tmp = (WORD*)realloc((*pptrBint)->val, 4 * (pwOf2 / WORD_BITLEN));
-        (*pptrBint)->val = tmp;
-#endif
-        // Update the word length of the BINT structure
+        // Update the word length of the BINT structure; the words above it stay allocated
         (*pptrBint)->wordlen = pwOf2 / WORD_BITLEN;
         return;
     }
@@ -481,20 +724,6 @@ void reduction(BINT** pptrBint, int pwOf2) {
     // Adjust the most significant word to fit the reduction
     (*pptrBint)->val[pwOf2 / WORD_BITLEN] = (*pptrBint)->val[pwOf2 / WORD_BITLEN] && (0xFF >> (pwOf2 % WORD_BITLEN));
 
-#if WORD_BITLEN == 8
-    WORD* tmp = (*pptrBint)->val;
-    tmp = (WORD*)realloc(tmp, (pwOf2 / WORD_BITLEN) + 1);
-    (*pptrBint)->val = tmp;
-#elif WORD_BITLEN == 64
-    WORD* tmp = (*pptrBint)->val;
-    tmp = (WORD*)realloc(tmp, 8 * (pwOf2 / WORD_BITLEN) + 1);
-    (*pptrBint)->val = tmp;
-#else
-    WORD* tmp = (*pptrBint)->val;
-    tmp = (WORD*)realloc((*pptrBint)->val, 4 * (pwOf2 / WORD_BITLEN) + 1);
-    (*pptrBint)->val = tmp;
-#endif
-
     // Update the word length to reflect the new size
     (*pptrBint)->wordlen = (pwOf2 / WORD_BITLEN) + 1;
     return;
@@ -542,4 +771,43 @@ void print_bint_hex_split(const BINT* ptrBint) {
 #endif
     }
     printf("\n");
-}
\ No newline at end of file
+}
+
+// Hex digits are written nibble by nibble so that files do not depend on WORD_BITLEN
+void write_bint_hex(FILE* fp, const BINT* ptrBint) {
+    bool lead = true;
+    fputs("0x", fp);
+    for (int i = ptrBint->wordlen - 1; i >= 0; i--) {
+        for (int s = WORD_BITLEN - 4; s >= 0; s -= 4) {
+            int d = (ptrBint->val[i] >> s) & 0xF;
+            if (lead && d == 0)
+                continue;
+            lead = false;
+            fputc("0123456789abcdef"[d], fp);
+        }
+    }
+    if (lead)
+        fputc('0', fp);
+}
+
+bool read_bint_hex(BINT** pptrBint, const char* str) {
+    if (strncmp(str, "0x", 2) != 0)
+        return false;
+    str += 2;
+    int digits = (int)strlen(str);
+    if (digits == 0)
+        return false;
+    int nibbles = WORD_BITLEN / 4;
+    init_bint(pptrBint, (digits + nibbles - 1) / nibbles);
+    for (int k = 0; k < digits; k++) {
+        char ch = str[digits - 1 - k];
+        int d;
+        if (ch >= '0' && ch <= '9') d = ch - '0';
+        else if (ch >= 'a' && ch <= 'f') d = ch - 'a' + 10;
+        else if (ch >= 'A' && ch <= 'F') d = ch - 'A' + 10;
+        else return false;
+        (*pptrBint)->val[k / nibbles] |= (WORD)d << (4 * (k % nibbles));
+    }
+    refineBINT(*pptrBint);
+    return true;
+}
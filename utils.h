@@ -9,6 +9,15 @@
 #include "config.h"
 
 #include <stdbool.h>
+#include <stdio.h>
+
+/**
+ * @def BINT_INLINE_WORDS
+ * @brief Number of words a BINT stores inside the structure itself (128 bits).
+ * @details Values up to this length, such as single-word quotients, double-word products and small constants,
+ *          need no separate allocation for their words.
+ */
+#define BINT_INLINE_WORDS (128 / WORD_BITLEN)
 
 /**
  * @struct BINT
@@ -17,8 +26,13 @@
  * This structure is used to represent integers that are too large to be
  * handled by standard integer types in C. It provides a way to work with
  * such numbers using an array of smaller 'word' units. A big integer
- * consists of a sign bit, a count of these word units, and a pointer to 
- * the array of word units.
+ * consists of a sign bit, a count of these word units, the number of words
+ * allocated, and a pointer to the array of word units, which points into the
+ * structure itself for short values.
+ *
+ * A BINT may also live on the stack or inside another structure, initialized
+ * with BINT_INITIALIZER and released with clear_bint. It must not be copied by
+ * assignment, since val may point to the inline words of the original.
  */
 typedef struct {
     bool sign; /**< @brief Sign bit of the big integer.
@@ -31,13 +45,29 @@ typedef struct {
                       constitute the big integer. It determines the size and, 
                       consequently, the precision of the big integer. */
 
+    int capacity; /**< @brief The number of words allocated for val.
+                       @details Never less than wordlen. Shrinking a big integer only lowers wordlen,
+                       and growth goes through reserveBINT, which at least doubles the allocation,
+                       so a sequence of resizes costs amortized constant time per word. */
+
     WORD* val; /**< @brief Pointer to the array of words representing the integer value.
                     @details This is a pointer to an array of WORD units, where each WORD 
                     is a part of the entire big integer. The array is used to store 
                     the actual numerical value of the big integer, split into smaller,
                     manageable units. */
+
+    WORD small[BINT_INLINE_WORDS]; /**< @brief Inline storage used by val while capacity is BINT_INLINE_WORDS. */
 } BINT;
 
+/**
+ * @def BINT_INITIALIZER
+ * @brief Initializer for a BINT variable holding zero in its inline words, e.g. BINT one = BINT_INITIALIZER(one);
+ * @details The result behaves like an object from init_bint and can be passed to every function through a
+ *          pointer to it, but must be released with clear_bint instead of delete_bint.
+ * @param name The variable being initialized.
+ */
+#define BINT_INITIALIZER(name) { false, 1, BINT_INLINE_WORDS, (name).small, { 0 } }
+
 /**
  * @brief Terminates program execution if a null pointer is encountered.
  * @details This function checks if a given pointer is NULL. If it is, the function
@@ -68,6 +98,83 @@ void exit_on_null_error(const void* ptr, const char* ptr_name, const char* funct
         exit_on_null_error(*pptr, "*" name, func); \
     } while(0)
 
+/**
+ * @def ARENA_CHUNK_BYTES
+ * @brief Size of the blocks the per-thread BINT arena requests from malloc.
+ * @details Larger requests get a block of their own size. Blocks are kept for reuse by the thread
+ *          and released when it exits, except on the main thread (see bint_arena_release_thread).
+ */
+#ifndef ARENA_CHUNK_BYTES
+#define ARENA_CHUNK_BYTES (64 * 1024)
+#endif
+
+/**
+ * @def ARENA_MAX_KEEP
+ * @brief Maximum number of BINT objects a single rollback can carry over.
+ */
+#define ARENA_MAX_KEEP 16
+
+/**
+ * @struct ArenaMark
+ * @brief Position in the calling thread's BINT arena, returned by bint_arena_begin.
+ */
+typedef struct {
+    void* chunk;    /**< @brief Arena block that was current when the mark was taken (NULL if none). */
+    size_t used;    /**< @brief Bytes in use in that block when the mark was taken. */
+} ArenaMark;
+
+/**
+ * @brief Opens an arena scope for BINT temporaries on the calling thread.
+ * @details Until the matching bint_arena_end, init_bint, copyBINT and every resize of a BINT's words are
+ *          served by bumping a pointer in a thread-local arena instead of calling malloc. delete_bint
+ *          on arena memory does nothing; the memory is reclaimed all at once when the scope is rolled
+ *          back or closed. Scopes nest and must be closed in LIFO order.
+ * @return ArenaMark The current top of the arena, to be passed to bint_arena_rollback and bint_arena_end.
+ * @note Every BINT that is reachable by the caller after the scope (outputs, and inputs the kernel may
+ *       have resized) must be listed in the keep list of bint_arena_end.
+ */
+ArenaMark bint_arena_begin(void);
+
+/**
+ * @brief Releases everything allocated in the arena since mark except the listed BINT objects.
+ * @details The kept objects are compacted back to the mark, so a loop that rolls back to the same mark
+ *          after each iteration runs in bounded arena space. Rollbacks that would free less than a quarter of
+ *          ARENA_CHUNK_BYTES are deferred, in which case nothing moves. The scope stays open. Entries that are
+ *          NULL or that do not live in the released region are left untouched, and several entries
+ *          may refer to the same object.
+ * @param mark A mark returned by bint_arena_begin for a scope that is still open.
+ * @param pptrKeep Array of keep_cnt double pointers to BINT objects to carry over; updated in place.
+ * @param keep_cnt Number of entries in pptrKeep, at most ARENA_MAX_KEEP.
+ */
+void bint_arena_rollback(ArenaMark mark, BINT** pptrKeep[], int keep_cnt);
+
+/**
+ * @brief Closes the innermost arena scope.
+ * @details Works like bint_arena_rollback, but the kept objects are moved to the enclosing scope, or to
+ *          the heap if this was the outermost scope, where they can be freed with delete_bint as usual.
+ * @param mark The mark returned by the bint_arena_begin that opened this scope.
+ * @param pptrKeep Array of keep_cnt double pointers to BINT objects to carry over; updated in place.
+ * @param keep_cnt Number of entries in pptrKeep, at most ARENA_MAX_KEEP.
+ */
+void bint_arena_end(ArenaMark mark, BINT** pptrKeep[], int keep_cnt);
+
+/**
+ * @brief Frees the arena blocks of the calling thread.
+ * @details Threads that end through pthread_exit or by returning from their start routine free their blocks
+ *          on the way out. The main thread does not, as exit() runs no thread-specific destructors: without
+ *          this call its blocks stay allocated until the process ends. The arena starts over on the next scope.
+ * @pre No arena scope may be open on the calling thread.
+ */
+void bint_arena_release_thread(void);
+
+/**
+ * @brief Number of calls the BINT allocator of the calling thread has made to malloc, calloc or realloc.
+ * @details Counts the words and structures of BINTs served outside arena scopes as well as the blocks of the
+ *          arena itself, so that two readings around a call show whether it stayed off the heap.
+ * @return size_t The running count of the calling thread.
+ */
+size_t bint_heap_calls(void);
+
 /**
  * @brief Deletes a dynamically allocated BINT object.
  * @details Frees the memory allocated for a BINT object and sets the pointer to NULL to
@@ -75,14 +182,25 @@ void exit_on_null_error(const void* ptr, const char* ptr_name, const char* funct
  * @param pptrBint Double pointer to the BINT object to be deleted.
  * @pre pptrBint must point to a valid BINT object.
  * @post pptrBint is set to NULL after deletion.
- * @note This function assumes that the BINT object was dynamically allocated.
+ * @note This function assumes that the BINT object was dynamically allocated. Objects in an open arena
+ *       scope are only unlinked; their memory goes back with the scope.
  */
 void delete_bint(BINT** pptrBint);
 
+/**
+ * @brief Releases the words of a BINT object whose structure the caller owns.
+ * @details Frees words that have spilled out of the inline storage and resets the object to zero in inline
+ *          storage, so a variable set up with BINT_INITIALIZER can be reused or go out of scope.
+ * @param ptrBint Pointer to the BINT object.
+ * @note Words that live in an arena scope are left to the scope, like in delete_bint.
+ */
+void clear_bint(BINT* ptrBint);
+
 /**
  * @brief Initializes a BINT object with a specified word length.
  * @details Allocates memory for a BINT object and initializes it to represent a number with
- *          the given word length.
+ *          the given word length. An existing object is zeroed in place instead, getting new words only
+ *          when its capacity is too small.
  * @param pptrBint Double pointer to the BINT object to be initialized.
  * @param wordlen The word length for the BINT's internal representation.
  * @pre wordlen should be a positive integer.
@@ -92,7 +210,8 @@ void init_bint(BINT** pptrBint, int wordlen);
 
 /**
  * @brief Copies the value from one BINT object to another.
- * @details The function copies the value of the source BINT object to the destination BINT object.
+ * @details The function copies the value of the source BINT object to the destination BINT object,
+ *          reusing the destination's words when its capacity allows.
  * @param pptrBint_dst Double pointer to the destination BINT object.
  * @param pptrBint_src Double pointer to the source BINT object.
  * @pre pptrBint_src must point to a valid BINT object and pptrBint_dst must point to an initialized BINT object.
@@ -100,6 +219,26 @@ void init_bint(BINT** pptrBint, int wordlen);
  */
 void copyBINT(BINT** pptrBint_dst, BINT** pptrBint_src);
 
+/**
+ * @brief Initializes a BINT object from an unsigned 64-bit integer.
+ * @details Allocates the BINT with as many words as a u64 needs for the current WORD_BITLEN
+ *          and trims leading zero words afterwards.
+ * @param pptrBint Double pointer to the BINT object to be initialized.
+ * @param value The non-negative value to be stored.
+ * @post pptrBint points to a non-negative BINT object equal to value.
+ */
+void set_bint_u64(BINT** pptrBint, u64 value);
+
+/**
+ * @brief Reads the low 64 bits of a BINT object.
+ * @details Collects the least significant words of the BINT into an unsigned 64-bit integer.
+ *          The sign is ignored.
+ * @param ptrBint Pointer to the BINT object.
+ * @return u64 The value of the BINT modulo 2^64.
+ * @note Callers are expected to check BIT_LENGTH first when the value may not fit.
+ */
+u64 get_bint_u64(BINT* ptrBint);
+
 /**
  * @brief Swaps the values of two BINT objects.
  * @details Exchanges the values between the two provided BINT objects.
@@ -110,6 +249,16 @@ void copyBINT(BINT** pptrBint_dst, BINT** pptrBint_src);
  */
 void swapBINT(BINT** pptrBint1, BINT** pptrBint2);
 
+/**
+ * @brief Makes room for at least the given number of words in a BINT object.
+ * @details Does nothing when the capacity already suffices. Otherwise the words are reallocated to the larger
+ *          of the request and twice the current capacity; wordlen and the value are unchanged.
+ * @param ptrBint Pointer to the BINT object to be grown.
+ * @param capacity The number of words needed.
+ * @post ptrBint->capacity >= capacity.
+ */
+void reserveBINT(BINT* ptrBint, int capacity);
+
 /**
  * @brief Adjusts the value of a BINT object to be even.
  * @details If the BINT object represents an odd number, this function increments it to the next even number.
@@ -328,4 +477,21 @@ void print_bint_hex_py(const BINT* ptrBint);
 
 void print_bint_hex_split(const BINT* ptrBint);
 
+/**
+ * @brief Writes the magnitude of a BINT object to a stream as a "0x" hexadecimal string without leading zeros.
+ * @details Digits are emitted nibble by nibble, so the text does not depend on WORD_BITLEN and files written with
+ *          one word size can be read with another.
+ * @param fp The output stream.
+ * @param ptrBint Pointer to the BINT object to be written.
+ */
+void write_bint_hex(FILE* fp, const BINT* ptrBint);
+
+/**
+ * @brief Parses a "0x" hexadecimal string written by write_bint_hex into a non-negative BINT object.
+ * @param pptrBint A double pointer where the parsed value will be stored (refined).
+ * @param str The string to parse; it must consist of the "0x" prefix and at least one hexadecimal digit.
+ * @return true on success, false if the string is malformed.
+ */
+bool read_bint_hex(BINT** pptrBint, const char* str);
+
 #endif // _UTILS_H
\ No newline at end of file